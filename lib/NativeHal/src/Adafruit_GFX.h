@@ -0,0 +1,89 @@
+// Native stand-in for Adafruit_GFX/Adafruit_SPITFT. Primitives follow the
+// upstream algorithms so the pixel, window and byte counts recorded in
+// hal::displayStats() match what the real driver would clock over SPI.
+#ifndef NATIVE_ADAFRUIT_GFX_H
+#define NATIVE_ADAFRUIT_GFX_H
+
+#include <Arduino.h>
+
+class Adafruit_GFX : public Print
+{
+public:
+    Adafruit_GFX(int16_t w, int16_t h) : WIDTH(w), HEIGHT(h), _width(w), _height(h) {}
+
+    virtual void startWrite();
+    virtual void endWrite();
+    virtual void writePixel(int16_t x, int16_t y, uint16_t color);
+    virtual void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+    virtual void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) { writeFillRect(x, y, 1, h, color); }
+    virtual void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) { writeFillRect(x, y, w, 1, color); }
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color);
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+    void fillScreen(uint16_t color) { fillRect(0, 0, _width, _height, color); }
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) { fillRect(x, y, 1, h, color); }
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) { fillRect(x, y, w, 1, color); }
+    void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+    void drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color);
+    void fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color);
+    void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size);
+
+    void setCursor(int16_t x, int16_t y)
+    {
+        cursor_x = x;
+        cursor_y = y;
+    }
+    void setTextColor(uint16_t c) { textcolor = textbgcolor = c; }
+    void setTextColor(uint16_t c, uint16_t bg)
+    {
+        textcolor = c;
+        textbgcolor = bg;
+    }
+    void setTextSize(uint8_t s) { textsize = s > 0 ? s : 1; }
+    virtual void setRotation(uint8_t r);
+    uint8_t getRotation() const { return rotation; }
+    int16_t width() const { return _width; }
+    int16_t height() const { return _height; }
+    int16_t getCursorX() const { return cursor_x; }
+    int16_t getCursorY() const { return cursor_y; }
+
+    size_t write(uint8_t c) override;
+    using Print::write;
+
+protected:
+    const int16_t WIDTH, HEIGHT;
+    int16_t _width, _height;
+    int16_t cursor_x = 0, cursor_y = 0;
+    uint16_t textcolor = 0xFFFF, textbgcolor = 0xFFFF;
+    uint8_t textsize = 1;
+    uint8_t rotation = 0;
+
+private:
+    void fillCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t corners, int16_t delta, uint16_t color);
+};
+
+class Adafruit_SPITFT : public Adafruit_GFX
+{
+public:
+    Adafruit_SPITFT(uint16_t w, uint16_t h) : Adafruit_GFX(w, h) {}
+
+    virtual void setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+    void writeColor(uint16_t color, uint32_t len);
+    void writePixels(uint16_t *colors, uint32_t len, bool block = true, bool bigEndian = false);
+    void pushColor(uint16_t color);
+    void writeCommand(uint8_t cmd);
+    void SPI_WRITE16(uint16_t w); // RAMWR data is a pixel
+    void SPI_WRITE32(uint32_t l); // CASET/PASET data sets the window
+    void writePixel(int16_t x, int16_t y, uint16_t color) override;
+    void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+
+protected:
+    uint32_t freq = 0;
+
+private:
+    uint8_t command = 0;
+    int16_t winX = 0, winY = 0, winW = 0, winH = 0;
+    uint32_t winPos = 0;
+};
+
+#endif // NATIVE_ADAFRUIT_GFX_H
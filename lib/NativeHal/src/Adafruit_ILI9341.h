@@ -0,0 +1,45 @@
+// Native stand-in for Adafruit_ILI9341 backed by the HAL display sink.
+#ifndef NATIVE_ADAFRUIT_ILI9341_H
+#define NATIVE_ADAFRUIT_ILI9341_H
+
+#include "Adafruit_GFX.h"
+
+#define ILI9341_TFTWIDTH 240
+#define ILI9341_TFTHEIGHT 320
+
+#define ILI9341_CASET 0x2A
+#define ILI9341_PASET 0x2B
+#define ILI9341_RAMWR 0x2C
+#define ILI9341_RDMODE 0x0A
+#define ILI9341_RDMADCTL 0x0B
+#define ILI9341_RDPIXFMT 0x0C
+
+#define ILI9341_BLACK 0x0000
+#define ILI9341_NAVY 0x000F
+#define ILI9341_DARKGREEN 0x03E0
+#define ILI9341_DARKCYAN 0x03EF
+#define ILI9341_MAROON 0x7800
+#define ILI9341_PURPLE 0x780F
+#define ILI9341_OLIVE 0x7BE0
+#define ILI9341_LIGHTGREY 0xC618
+#define ILI9341_DARKGREY 0x7BEF
+#define ILI9341_BLUE 0x001F
+#define ILI9341_GREEN 0x07E0
+#define ILI9341_CYAN 0x07FF
+#define ILI9341_RED 0xF800
+#define ILI9341_MAGENTA 0xF81F
+#define ILI9341_YELLOW 0xFFE0
+#define ILI9341_WHITE 0xFFFF
+#define ILI9341_ORANGE 0xFD20
+#define ILI9341_GREENYELLOW 0xAFE5
+#define ILI9341_PINK 0xFC18
+
+class Adafruit_ILI9341 : public Adafruit_SPITFT
+{
+public:
+    Adafruit_ILI9341(int8_t cs, int8_t dc, int8_t rst = -1) : Adafruit_SPITFT(ILI9341_TFTWIDTH, ILI9341_TFTHEIGHT) {}
+    void begin(uint32_t freq = 0);
+    uint8_t readcommand8(uint8_t commandByte, uint8_t index = 0);
+};
+
+#endif // NATIVE_ADAFRUIT_ILI9341_H
@@ -0,0 +1,181 @@
+// Native stand-in for the Arduino core, routed onto the HAL in Hal.h.
+#ifndef NATIVE_ARDUINO_H
+#define NATIVE_ARDUINO_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <algorithm>
+#include "Hal.h"
+#include "avr/pgmspace.h"
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+#define NOT_AN_INTERRUPT -1
+
+#define A0 14
+#define A1 15
+#define A2 16
+#define A3 17
+#define A4 18
+#define A5 19
+
+#define DEC 10
+#define HEX 16
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+using std::abs;
+using std::max;
+using std::min;
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+inline uint32_t micros() { return hal::nowMicros(); }
+inline uint32_t millis() { return hal::nowMillis(); }
+inline void delay(uint32_t ms) { hal::advanceMillis(ms); }
+inline void delayMicroseconds(uint32_t us) { hal::advanceMicros(us); }
+inline void yield() {}
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t pin, uint8_t val) { hal::setPinLevel(pin, val); }
+inline int digitalRead(uint8_t pin) { return hal::pinLevel(pin); }
+inline void analogWrite(uint8_t pin, int val) { hal::setPinDuty(pin, (uint8_t)val); }
+inline int digitalPinToInterrupt(uint8_t pin) { return pin == 2 ? 0 : (pin == 3 ? 1 : NOT_AN_INTERRUPT); }
+inline void attachInterrupt(uint8_t interrupt, void (*isr)(void), int mode) { hal::attachPinInterrupt(interrupt == 0 ? 2 : 3, isr, mode); }
+inline void detachInterrupt(uint8_t interrupt) { hal::detachPinInterrupt(interrupt == 0 ? 2 : 3); }
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+inline long map(long x, long in_min, long in_max, long out_min, long out_max)
+{
+    return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+inline long random(long howbig) { return howbig == 0 ? 0 : ::random() % howbig; }
+inline long random(long howsmall, long howbig)
+{
+    return howsmall >= howbig ? howsmall : random(howbig - howsmall) + howsmall;
+}
+inline void randomSeed(unsigned long seed) { srandom(seed); }
+
+// avr-libc <stdlib.h> number formatting
+inline char *ultoa(unsigned long value, char *out, int radix)
+{
+    char digits[33];
+    int n = 0;
+    do
+    {
+        int d = value % radix;
+        digits[n++] = d < 10 ? '0' + d : 'a' + d - 10;
+        value /= radix;
+    } while (value);
+    for (int i = 0; i < n; ++i)
+        out[i] = digits[n - 1 - i];
+    out[n] = '\0';
+    return out;
+}
+inline char *ltoa(long value, char *out, int radix)
+{
+    if (value < 0 && radix == 10)
+    {
+        out[0] = '-';
+        ultoa(-(unsigned long)value, out + 1, radix);
+        return out;
+    }
+    return ultoa(value, out, radix);
+}
+
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(string_literal))
+
+class String : public std::string
+{
+public:
+    String(const char *s = "") : std::string(s) {}
+    String(const std::string &s) : std::string(s) {}
+    String(int v) : std::string(std::to_string(v)) {}
+    String(unsigned int v) : std::string(std::to_string(v)) {}
+    String(long v) : std::string(std::to_string(v)) {}
+    String(unsigned long v) : std::string(std::to_string(v)) {}
+    friend String operator+(const String &a, const String &b) { return String(static_cast<const std::string &>(a) + static_cast<const std::string &>(b)); }
+    friend String operator+(const String &a, const char *b) { return String(static_cast<const std::string &>(a) + b); }
+    friend String operator+(const char *a, const String &b) { return String(a + static_cast<const std::string &>(b)); }
+};
+
+class Print
+{
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buf, size_t n)
+    {
+        for (size_t i = 0; i < n; ++i)
+            write(buf[i]);
+        return n;
+    }
+    virtual int availableForWrite() { return 64; }
+    size_t print(const char *s) { return write((const uint8_t *)s, strlen(s)); }
+    size_t print(const __FlashStringHelper *s) { return print(reinterpret_cast<const char *>(s)); }
+    size_t print(const String &s) { return print(s.c_str()); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(long v, int base = DEC)
+    {
+        char buf[24];
+        snprintf(buf, sizeof(buf), base == HEX ? "%lx" : "%ld", v);
+        return print(buf);
+    }
+    size_t print(unsigned long v, int base = DEC)
+    {
+        char buf[24];
+        snprintf(buf, sizeof(buf), base == HEX ? "%lx" : "%lu", v);
+        return print(buf);
+    }
+    size_t print(int v, int base = DEC) { return print((long)v, base); }
+    size_t print(unsigned int v, int base = DEC) { return print((unsigned long)v, base); }
+    size_t print(unsigned char v, int base = DEC) { return print((unsigned long)v, base); }
+    size_t print(double v, int = 2)
+    {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%.2f", v);
+        return print(buf);
+    }
+    size_t println() { return print("\r\n"); }
+    template <typename T>
+    size_t println(const T &v)
+    {
+        size_t n = print(v);
+        return n + println();
+    }
+    template <typename T>
+    size_t println(const T &v, int base)
+    {
+        size_t n = print(v, base);
+        return n + println();
+    }
+};
+
+class HardwareSerial : public Print
+{
+public:
+    void begin(unsigned long baud);
+    int available();
+    int read();
+    size_t write(uint8_t c) override;
+    int availableForWrite() override;
+    operator bool() { return true; }
+    using Print::write;
+};
+extern HardwareSerial Serial;
+
+void setup();
+void loop();
+
+#endif // NATIVE_ARDUINO_H
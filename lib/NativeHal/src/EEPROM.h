@@ -0,0 +1,44 @@
+// Native stand-in for the AVR EEPROM library with per-cell wear counters.
+#ifndef NATIVE_EEPROM_H
+#define NATIVE_EEPROM_H
+
+#include <stdint.h>
+#include <string.h>
+
+class EEPROMClass
+{
+public:
+    EEPROMClass() { memset(cells, 0xFF, sizeof(cells)); }
+    uint8_t read(int idx) { return cells[idx]; }
+    void write(int idx, uint8_t val)
+    {
+        cells[idx] = val;
+        ++wear[idx];
+    }
+    void update(int idx, uint8_t val)
+    {
+        if (cells[idx] != val)
+            write(idx, val);
+    }
+    uint16_t length() { return sizeof(cells); }
+    template <typename T>
+    T &get(int idx, T &t)
+    {
+        memcpy(&t, &cells[idx], sizeof(T));
+        return t;
+    }
+    template <typename T>
+    const T &put(int idx, const T &t)
+    {
+        const uint8_t *p = (const uint8_t *)&t;
+        for (unsigned i = 0; i < sizeof(T); ++i)
+            update(idx + i, p[i]);
+        return t;
+    }
+
+    uint8_t cells[1024];
+    uint32_t wear[1024] = {};
+};
+extern EEPROMClass EEPROM;
+
+#endif // NATIVE_EEPROM_H
@@ -0,0 +1,70 @@
+// Native stand-in for FastLED: frames are counted and the interrupt
+// blackout of a WS2812 push is charged to the virtual clock.
+#ifndef NATIVE_FASTLED_H
+#define NATIVE_FASTLED_H
+
+#include <stdint.h>
+
+struct CRGB
+{
+    uint8_t r, g, b;
+
+    enum HTMLColorCode : uint32_t
+    {
+        Black = 0x000000,
+        Blue = 0x0000FF,
+        Green = 0x008000,
+        OrangeRed = 0xFF4500,
+        Purple = 0x800080,
+        Red = 0xFF0000,
+        White = 0xFFFFFF
+    };
+
+    CRGB() : r(0), g(0), b(0) {}
+    CRGB(uint8_t ir, uint8_t ig, uint8_t ib) : r(ir), g(ig), b(ib) {}
+    CRGB(uint32_t colorcode) : r((colorcode >> 16) & 0xFF), g((colorcode >> 8) & 0xFF), b(colorcode & 0xFF) {}
+    CRGB(HTMLColorCode colorcode) : CRGB((uint32_t)colorcode) {}
+    bool operator==(const CRGB &o) const { return r == o.r && g == o.g && b == o.b; }
+    bool operator!=(const CRGB &o) const { return !(*this == o); }
+};
+
+enum ESPIChipsets
+{
+    NEOPIXEL
+};
+
+class CLEDController
+{
+public:
+    CLEDController &setLeds(CRGB *data, int nLeds)
+    {
+        leds = data;
+        count = nLeds;
+        return *this;
+    }
+    CRGB *leds = nullptr;
+    int count = 0;
+};
+
+class CFastLED
+{
+public:
+    template <ESPIChipsets CHIPSET, uint8_t DATA_PIN>
+    CLEDController &addLeds(CRGB *data, int nLeds)
+    {
+        return controller.setLeds(data, nLeds);
+    }
+    void setBrightness(uint8_t scale) { brightness = scale; }
+    void show();
+    CLEDController &operator[](int) { return controller; }
+
+    uint32_t frames = 0;
+    uint32_t blackoutMicros = 0;
+
+private:
+    CLEDController controller;
+    uint8_t brightness = 255;
+};
+extern CFastLED FastLED;
+
+#endif // NATIVE_FASTLED_H
@@ -0,0 +1,375 @@
+#include <unistd.h>
+#include "Hal.h"
+#include <Arduino.h>
+#include <XPT2046_Touchscreen.h>
+#include <FastLED.h>
+#include <SPI.h>
+#include <EEPROM.h>
+
+HardwareSerial Serial;
+CFastLED FastLED;
+SPIClass SPI;
+EEPROMClass EEPROM;
+
+namespace hal
+{
+    static uint32_t clockMicros = 0;
+    static uint64_t clockTotal = 0; // The same without the 71-minute wrap, for millis()
+    static TickHook tickHook = nullptr;
+    static uint32_t tickPeriod = 0;
+    static uint32_t nextTick = 0;
+    static bool chargeBusTime = false;
+
+    static uint8_t levels[PIN_COUNT];
+    static uint8_t duties[PIN_COUNT];
+    static uint32_t highSince[PIN_COUNT];
+    static uint32_t highTotal[PIN_COUNT];
+
+    static DisplayStats stats;
+    static uint16_t framebuffer[320 * 320];
+
+    struct PinInterrupt
+    {
+        void (*isr)();
+        int mode;
+    };
+    static PinInterrupt pinInterrupts[PIN_COUNT];
+
+    static TouchSample touch = {0, 0, 0};
+    static int16_t touchNoise = 0;
+
+    // Pulled-up inputs that idle high
+    static struct IdleLevels
+    {
+        IdleLevels() { levels[TOUCH_IRQ_PIN] = 1; }
+    } idleLevels;
+
+    static int serialFd = -1;
+    static int serialInputFd = -1;
+    static SerialSink serialSink = nullptr;
+    static uint32_t serialTxBytes = 0;
+    static uint32_t serialByteMicros = 87; // 10 bits at 115200 baud
+    static uint32_t serialTxIdleAt = 0;    // When the transmit buffer will have drained
+    static uint32_t serialOverrunCount = 0;
+    static uint32_t serialStallCount = 0;
+
+    // Bytes on the wire, each with the time its stop bit arrives
+    static const uint16_t WIRE_SIZE = 4096;
+    static uint8_t wire[WIRE_SIZE];
+    static uint32_t wireArrival[WIRE_SIZE];
+    static uint16_t wireHead = 0, wireTail = 0;
+    static uint32_t wireLastArrival = 0;
+
+    // The core's rings hold one byte less than their 64
+    static const uint8_t SERIAL_BUFFER_SIZE = 64;
+    static uint8_t rx[SERIAL_BUFFER_SIZE];
+    static uint8_t rxHead = 0, rxTail = 0;
+
+    uint32_t nowMicros() { return clockMicros; }
+
+    // Timer0 counts millis() on its own, so on the board it wraps after 49
+    // days rather than with micros()
+    uint32_t nowMillis() { return clockTotal / 1000; }
+
+    static void moveClock(uint32_t us)
+    {
+        clockTotal += (uint32_t)(us - clockMicros);
+        clockMicros = us;
+    }
+
+    void setMicros(uint32_t us)
+    {
+        clockMicros = us;
+        clockTotal = us;
+        nextTick = us + tickPeriod;
+    }
+
+    void setMillis(uint32_t ms)
+    {
+        clockTotal = ms * 1000ULL;
+        clockMicros = clockTotal;
+        nextTick = clockMicros + tickPeriod;
+    }
+
+    void advanceMicros(uint32_t us)
+    {
+        if (tickHook == nullptr)
+        {
+            moveClock(clockMicros + us);
+            return;
+        }
+        uint32_t target = clockMicros + us;
+        while ((int32_t)(target - nextTick) >= 0)
+        {
+            moveClock(nextTick);
+            nextTick += tickPeriod;
+            tickHook();
+        }
+        moveClock(target);
+    }
+
+    void advanceMillis(uint32_t ms) { advanceMicros(ms * 1000UL); }
+
+    void setTickHook(TickHook hook, uint32_t periodMicros)
+    {
+        tickHook = hook;
+        tickPeriod = periodMicros;
+        nextTick = clockMicros + periodMicros;
+    }
+
+    void setChargeBusTime(bool enable) { chargeBusTime = enable; }
+    void chargeBus(uint32_t us)
+    {
+        if (chargeBusTime)
+            advanceMicros(us);
+    }
+
+    uint8_t pinLevel(uint8_t pin) { return pin < PIN_COUNT ? levels[pin] : 0; }
+    uint8_t pinDuty(uint8_t pin) { return pin < PIN_COUNT ? duties[pin] : 0; }
+
+    uint32_t pinHighMicros(uint8_t pin)
+    {
+        if (pin >= PIN_COUNT)
+            return 0;
+        return highTotal[pin] + (levels[pin] ? clockMicros - highSince[pin] : 0);
+    }
+
+    void setPinLevel(uint8_t pin, uint8_t level)
+    {
+        if (pin >= PIN_COUNT)
+            return;
+        level = level ? 1 : 0;
+        uint8_t previous = levels[pin];
+        if (level && !previous)
+            highSince[pin] = clockMicros;
+        if (!level && previous)
+            highTotal[pin] += clockMicros - highSince[pin];
+        levels[pin] = level;
+        duties[pin] = level ? 255 : 0;
+
+        const PinInterrupt &irq = pinInterrupts[pin];
+        if (irq.isr != nullptr && level != previous &&
+            (irq.mode == CHANGE || (irq.mode == FALLING && !level) || (irq.mode == RISING && level)))
+            irq.isr();
+    }
+
+    void attachPinInterrupt(uint8_t pin, void (*isr)(), int mode)
+    {
+        if (pin < PIN_COUNT)
+            pinInterrupts[pin] = {isr, mode};
+    }
+
+    void detachPinInterrupt(uint8_t pin)
+    {
+        if (pin < PIN_COUNT)
+            pinInterrupts[pin] = {nullptr, 0};
+    }
+
+    void setPinDuty(uint8_t pin, uint8_t duty)
+    {
+        if (pin >= PIN_COUNT)
+            return;
+        setPinLevel(pin, duty != 0);
+        duties[pin] = duty;
+    }
+
+    DisplayStats &displayStats() { return stats; }
+    void resetDisplayStats() { stats = DisplayStats(); }
+
+    uint16_t displayPixel(int16_t x, int16_t y)
+    {
+        if (x < 0 || y < 0 || x >= 320 || y >= 320)
+            return 0;
+        return framebuffer[y * 320 + x];
+    }
+
+    void storePixel(int16_t x, int16_t y, uint16_t color)
+    {
+        if (x < 0 || y < 0 || x >= 320 || y >= 320)
+            return;
+        framebuffer[y * 320 + x] = color;
+    }
+
+    void setTouch(int16_t rawX, int16_t rawY, int16_t z)
+    {
+        touch = {rawX, rawY, z};
+        setPinLevel(TOUCH_IRQ_PIN, z > 0 ? 0 : 1);
+    }
+
+    void releaseTouch()
+    {
+        touch = {0, 0, 0};
+        setPinLevel(TOUCH_IRQ_PIN, 1);
+    }
+
+    void setTouchNoise(int16_t amplitude) { touchNoise = amplitude; }
+
+    static uint32_t touchReadCount = 0;
+    uint32_t touchReads() { return touchReadCount; }
+
+    TouchSample readTouch()
+    {
+        ++touchReadCount;
+        if (touch.z == 0 || touchNoise == 0)
+            return touch;
+        return {(int16_t)(touch.x + random(-touchNoise, touchNoise + 1)),
+                (int16_t)(touch.y + random(-touchNoise, touchNoise + 1)),
+                (int16_t)(touch.z + random(-touchNoise, touchNoise + 1))};
+    }
+
+    void setSerialFd(int fd) { serialFd = fd; }
+    void setSerialInput(int fd) { serialInputFd = fd; }
+    void setSerialSink(SerialSink sink) { serialSink = sink; }
+    uint32_t serialBytesWritten() { return serialTxBytes; }
+    uint32_t serialOverruns() { return serialOverrunCount; }
+    uint32_t serialWriteStalls() { return serialStallCount; }
+
+    static void setSerialBaud(unsigned long baud) { serialByteMicros = (10000000UL + baud / 2) / baud; }
+
+    void serialReceive(const uint8_t *data, size_t n)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            uint16_t next = (wireHead + 1) % WIRE_SIZE;
+            if (next == wireTail)
+                return; // More than the bench should ever have in flight
+            uint32_t start = (int32_t)(wireLastArrival - clockMicros) > 0 ? wireLastArrival : clockMicros;
+            wireLastArrival = start + serialByteMicros;
+            wire[wireHead] = data[i];
+            wireArrival[wireHead] = wireLastArrival;
+            wireHead = next;
+        }
+    }
+
+    // Moves what has arrived by now into the receive ring
+    static void serialPoll()
+    {
+        if (serialInputFd >= 0)
+        {
+            uint8_t chunk[256];
+            ssize_t n = ::read(serialInputFd, chunk, sizeof(chunk));
+            if (n > 0)
+                serialReceive(chunk, n);
+        }
+        while (wireTail != wireHead && (int32_t)(clockMicros - wireArrival[wireTail]) >= 0)
+        {
+            uint8_t next = (rxHead + 1) % SERIAL_BUFFER_SIZE;
+            if (next == rxTail)
+                ++serialOverrunCount;
+            else
+            {
+                rx[rxHead] = wire[wireTail];
+                rxHead = next;
+            }
+            wireTail = (wireTail + 1) % WIRE_SIZE;
+        }
+    }
+
+    static int serialAvailable()
+    {
+        serialPoll();
+        return (rxHead - rxTail + SERIAL_BUFFER_SIZE) % SERIAL_BUFFER_SIZE;
+    }
+
+    static int serialRead()
+    {
+        serialPoll();
+        if (rxTail == rxHead)
+            return -1;
+        uint8_t c = rx[rxTail];
+        rxTail = (rxTail + 1) % SERIAL_BUFFER_SIZE;
+        return c;
+    }
+
+    // Bytes still waiting in the transmit buffer
+    static uint32_t serialTxQueued()
+    {
+        int32_t busy = (int32_t)(serialTxIdleAt - clockMicros);
+        return busy > 0 ? (busy + serialByteMicros - 1) / serialByteMicros : 0;
+    }
+
+    static size_t serialWrite(uint8_t c)
+    {
+        if (serialTxQueued() >= SERIAL_BUFFER_SIZE - 1)
+        {
+            // The AVR core spins until the UDRE interrupt makes room
+            ++serialStallCount;
+            advanceMicros(serialTxIdleAt - clockMicros - (SERIAL_BUFFER_SIZE - 2) * serialByteMicros);
+        }
+        uint32_t start = (int32_t)(serialTxIdleAt - clockMicros) > 0 ? serialTxIdleAt : clockMicros;
+        serialTxIdleAt = start + serialByteMicros;
+        ++serialTxBytes;
+        if (serialSink != nullptr)
+            serialSink(c);
+        if (serialFd >= 0)
+            return ::write(serialFd, &c, 1) == 1 ? 1 : 0;
+        return 1;
+    }
+}
+
+// --- Serial ---
+
+void HardwareSerial::begin(unsigned long baud)
+{
+    hal::setSerialBaud(baud);
+}
+
+int HardwareSerial::available()
+{
+    return hal::serialAvailable();
+}
+
+int HardwareSerial::read()
+{
+    return hal::serialRead();
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+    return hal::serialWrite(c);
+}
+
+int HardwareSerial::availableForWrite()
+{
+    return 63 - hal::serialTxQueued();
+}
+
+// --- FastLED ---
+
+void CFastLED::show()
+{
+    // WS2812 at 800 kHz: 24 bits per pixel, 1.25 us per bit, interrupts off.
+    uint32_t us = (uint32_t)controller.count * 30;
+    ++frames;
+    blackoutMicros += us;
+    hal::chargeBus(us);
+}
+
+// --- Touch ---
+
+void XPT2046_Touchscreen::readData(uint16_t *x, uint16_t *y, uint8_t *z)
+{
+    TS_Point p = getPoint();
+    *x = p.x;
+    *y = p.y;
+    *z = p.z > 255 ? 255 : p.z;
+}
+
+TS_Point XPT2046_Touchscreen::getPoint()
+{
+    ++transactions;
+    // One transaction: Z1, Z2 then six X/Y conversions at 2 MHz.
+    hal::chargeBus(60);
+    hal::TouchSample s = hal::readTouch();
+    return TS_Point(s.x, s.y, s.z);
+}
+
+bool XPT2046_Touchscreen::tirqTouched()
+{
+    return hal::pinLevel(hal::TOUCH_IRQ_PIN) == 0;
+}
+
+bool XPT2046_Touchscreen::touched()
+{
+    return getPoint().z >= 300;
+}
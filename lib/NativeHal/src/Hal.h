@@ -0,0 +1,80 @@
+// Native hardware abstraction layer: virtual clock, GPIO, display sink and
+// touch source that stand in for the AVR core and device libraries.
+#ifndef NATIVE_HAL_H
+#define NATIVE_HAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace hal
+{
+    // --- Virtual clock ---
+    uint32_t nowMicros();
+    uint32_t nowMillis();
+    void setMicros(uint32_t us);
+    void setMillis(uint32_t ms); // micros() follows, wrapped as on the board
+    void advanceMicros(uint32_t us);
+    void advanceMillis(uint32_t ms);
+    typedef void (*TickHook)();
+    void setTickHook(TickHook hook, uint32_t periodMicros);
+    // When enabled, SPI and LED traffic advances the clock by its bus time.
+    void setChargeBusTime(bool enable);
+    void chargeBus(uint32_t us);
+
+    // --- GPIO ---
+    static const uint8_t PIN_COUNT = 24;
+    uint8_t pinLevel(uint8_t pin);
+    uint8_t pinDuty(uint8_t pin);
+    uint32_t pinHighMicros(uint8_t pin);
+    void setPinLevel(uint8_t pin, uint8_t level);
+    void setPinDuty(uint8_t pin, uint8_t duty);
+    // External interrupts: INT0 on pin 2, INT1 on pin 3, fired by setPinLevel()
+    void attachPinInterrupt(uint8_t pin, void (*isr)(), int mode);
+    void detachPinInterrupt(uint8_t pin);
+
+    // --- Display sink ---
+    struct DisplayStats
+    {
+        uint32_t pixels;       // Pixels written to GRAM
+        uint32_t bytes;        // Bytes clocked over SPI (commands + data)
+        uint32_t transactions; // CS assert/deassert pairs
+        uint32_t windows;      // Address window setups
+    };
+    DisplayStats &displayStats();
+    void resetDisplayStats();
+    uint16_t displayPixel(int16_t x, int16_t y);
+    void storePixel(int16_t x, int16_t y, uint16_t color);
+    void countDisplayBytes(uint32_t n);
+    // The panel drops back to its reset state, as after a brown-out: the
+    // screen goes white and RDMODE reads sleep-in, display-off until begin()
+    void resetDisplayPanel();
+
+    // --- Touch source ---
+    // T_IRQ idles high and is pulled low while the panel is pressed
+    static const uint8_t TOUCH_IRQ_PIN = 2;
+    struct TouchSample
+    {
+        int16_t x, y, z;
+    };
+    void setTouch(int16_t rawX, int16_t rawY, int16_t z);
+    void releaseTouch();
+    void setTouchNoise(int16_t amplitude); // Each reading is off by up to this much
+    TouchSample readTouch();               // One conversion, noise included
+    uint32_t touchReads();
+
+    // --- Serial ---
+    // Both directions run at the rate given to Serial.begin(). Received
+    // bytes land in the 64-byte buffer as they come off the wire and are
+    // lost while it is full; written bytes queue in a 64-byte buffer that
+    // drains onto the wire, and a write to a full one waits, as on the AVR.
+    void setSerialFd(int fd);      // Written bytes also go to fd
+    void setSerialInput(int fd);   // Bytes readable on fd are put on the wire
+    void serialReceive(const uint8_t *data, size_t n); // Put on the wire, towards the board
+    typedef void (*SerialSink)(uint8_t c);
+    void setSerialSink(SerialSink sink); // Sees every byte written
+    uint32_t serialBytesWritten();
+    uint32_t serialOverruns();    // Received bytes lost to a full buffer
+    uint32_t serialWriteStalls(); // Writes that had to wait for room
+}
+
+#endif // NATIVE_HAL_H
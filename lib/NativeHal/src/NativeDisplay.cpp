@@ -0,0 +1,342 @@
+#include "Hal.h"
+#include <Arduino.h>
+#include <Adafruit_ILI9341.h>
+
+static bool panelReset = false;
+
+namespace hal
+{
+    // The clock given to begin(); the AVR's SPI tops out at F_CPU / 2
+    static uint32_t displayByteNanos = 1000;
+    static uint32_t displayNanosOwed = 0;
+
+    void countDisplayBytes(uint32_t n)
+    {
+        displayStats().bytes += n;
+        displayNanosOwed += n * displayByteNanos;
+        chargeBus(displayNanosOwed / 1000);
+        displayNanosOwed %= 1000;
+    }
+
+    void resetDisplayPanel()
+    {
+        for (int16_t y = 0; y < 320; y++)
+            for (int16_t x = 0; x < 320; x++)
+                storePixel(x, y, ILI9341_WHITE);
+        panelReset = true;
+    }
+}
+
+static uint8_t writeDepth = 0;
+
+void Adafruit_GFX::startWrite()
+{
+    if (writeDepth++ == 0)
+        ++hal::displayStats().transactions;
+}
+
+void Adafruit_GFX::endWrite()
+{
+    if (writeDepth > 0)
+        --writeDepth;
+}
+
+void Adafruit_GFX::writePixel(int16_t x, int16_t y, uint16_t color)
+{
+    writeFillRect(x, y, 1, 1, color);
+}
+
+void Adafruit_GFX::writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    for (int16_t i = x; i < x + w; i++)
+        for (int16_t j = y; j < y + h; j++)
+            writePixel(i, j, color);
+}
+
+void Adafruit_GFX::drawPixel(int16_t x, int16_t y, uint16_t color)
+{
+    startWrite();
+    writePixel(x, y, color);
+    endWrite();
+}
+
+void Adafruit_GFX::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    startWrite();
+    writeFillRect(x, y, w, h, color);
+    endWrite();
+}
+
+void Adafruit_GFX::drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    startWrite();
+    writeFastHLine(x, y, w, color);
+    writeFastHLine(x, y + h - 1, w, color);
+    writeFastVLine(x, y, h, color);
+    writeFastVLine(x + w - 1, y, h, color);
+    endWrite();
+}
+
+void Adafruit_GFX::drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color)
+{
+    int16_t f = 1 - r;
+    int16_t ddF_x = 1;
+    int16_t ddF_y = -2 * r;
+    int16_t x = 0;
+    int16_t y = r;
+
+    startWrite();
+    writePixel(x0, y0 + r, color);
+    writePixel(x0, y0 - r, color);
+    writePixel(x0 + r, y0, color);
+    writePixel(x0 - r, y0, color);
+    while (x < y)
+    {
+        if (f >= 0)
+        {
+            y--;
+            ddF_y += 2;
+            f += ddF_y;
+        }
+        x++;
+        ddF_x += 2;
+        f += ddF_x;
+        writePixel(x0 + x, y0 + y, color);
+        writePixel(x0 - x, y0 + y, color);
+        writePixel(x0 + x, y0 - y, color);
+        writePixel(x0 - x, y0 - y, color);
+        writePixel(x0 + y, y0 + x, color);
+        writePixel(x0 - y, y0 + x, color);
+        writePixel(x0 + y, y0 - x, color);
+        writePixel(x0 - y, y0 - x, color);
+    }
+    endWrite();
+}
+
+void Adafruit_GFX::fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color)
+{
+    startWrite();
+    writeFastVLine(x0, y0 - r, 2 * r + 1, color);
+    fillCircleHelper(x0, y0, r, 3, 0, color);
+    endWrite();
+}
+
+void Adafruit_GFX::fillCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t corners, int16_t delta, uint16_t color)
+{
+    int16_t f = 1 - r;
+    int16_t ddF_x = 1;
+    int16_t ddF_y = -2 * r;
+    int16_t x = 0;
+    int16_t y = r;
+    int16_t px = x;
+    int16_t py = y;
+
+    delta++;
+
+    while (x < y)
+    {
+        if (f >= 0)
+        {
+            y--;
+            ddF_y += 2;
+            f += ddF_y;
+        }
+        x++;
+        ddF_x += 2;
+        f += ddF_x;
+        if (x < (y + 1))
+        {
+            if (corners & 1)
+                writeFastVLine(x0 + x, y0 - y, 2 * y + delta, color);
+            if (corners & 2)
+                writeFastVLine(x0 - x, y0 - y, 2 * y + delta, color);
+        }
+        if (y != py)
+        {
+            if (corners & 1)
+                writeFastVLine(x0 + py, y0 - px, 2 * px + delta, color);
+            if (corners & 2)
+                writeFastVLine(x0 - py, y0 - px, 2 * px + delta, color);
+            py = y;
+        }
+        px = x;
+    }
+}
+
+void Adafruit_GFX::drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size)
+{
+    // Without the glcdfont table, charge an average classic-font glyph:
+    // 17 of the 5x7 cells lit, each plotted as a size x size rectangle.
+    if (c == ' ' && bg == color)
+        return;
+    startWrite();
+    uint8_t lit = (c == ' ') ? 0 : 17;
+    for (uint8_t i = 0; i < lit; i++)
+        writeFillRect(x + (i % 5) * size, y + (i / 5) * size, size, size, color);
+    if (bg != color)
+        for (uint8_t i = lit; i < 48; i++)
+            writeFillRect(x + (i % 6) * size, y + (i / 6) * size, size, size, bg);
+    endWrite();
+}
+
+size_t Adafruit_GFX::write(uint8_t c)
+{
+    if (c == '\n')
+    {
+        cursor_x = 0;
+        cursor_y += textsize * 8;
+    }
+    else if (c != '\r')
+    {
+        drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize);
+        cursor_x += textsize * 6;
+    }
+    return 1;
+}
+
+void Adafruit_GFX::setRotation(uint8_t r)
+{
+    rotation = r & 3;
+    if (rotation & 1)
+    {
+        _width = HEIGHT;
+        _height = WIDTH;
+    }
+    else
+    {
+        _width = WIDTH;
+        _height = HEIGHT;
+    }
+}
+
+// The controller's column and page registers keep their ranges until the
+// next CASET/PASET; RAMWR starts writing at their top left
+void Adafruit_SPITFT::setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+    writeCommand(ILI9341_CASET);
+    SPI_WRITE32(((uint32_t)x << 16) | (x + w - 1));
+    writeCommand(ILI9341_PASET);
+    SPI_WRITE32(((uint32_t)y << 16) | (y + h - 1));
+    writeCommand(ILI9341_RAMWR);
+}
+
+void Adafruit_SPITFT::writeCommand(uint8_t cmd)
+{
+    hal::countDisplayBytes(1);
+    command = cmd;
+    if (cmd == ILI9341_RAMWR)
+    {
+        ++hal::displayStats().windows;
+        winPos = 0;
+    }
+}
+
+void Adafruit_SPITFT::SPI_WRITE16(uint16_t w)
+{
+    if (command == ILI9341_RAMWR)
+    {
+        pushColor(w);
+        return;
+    }
+    hal::countDisplayBytes(2);
+}
+
+void Adafruit_SPITFT::SPI_WRITE32(uint32_t l)
+{
+    hal::countDisplayBytes(4);
+    if (command == ILI9341_CASET)
+    {
+        winX = l >> 16;
+        winW = (int16_t)((l & 0xFFFF) - winX + 1);
+    }
+    else if (command == ILI9341_PASET)
+    {
+        winY = l >> 16;
+        winH = (int16_t)((l & 0xFFFF) - winY + 1);
+    }
+}
+
+void Adafruit_SPITFT::writeColor(uint16_t color, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++)
+        pushColor(color);
+}
+
+void Adafruit_SPITFT::writePixels(uint16_t *colors, uint32_t len, bool, bool)
+{
+    for (uint32_t i = 0; i < len; i++)
+        pushColor(colors[i]);
+}
+
+void Adafruit_SPITFT::pushColor(uint16_t color)
+{
+    if (winW > 0 && winH > 0)
+    {
+        hal::storePixel(winX + winPos % winW, winY + (winPos / winW) % winH, color);
+        ++winPos;
+    }
+    ++hal::displayStats().pixels;
+    hal::countDisplayBytes(2);
+}
+
+void Adafruit_SPITFT::writePixel(int16_t x, int16_t y, uint16_t color)
+{
+    if (x < 0 || y < 0 || x >= _width || y >= _height)
+        return;
+    setAddrWindow(x, y, 1, 1);
+    pushColor(color);
+}
+
+void Adafruit_SPITFT::writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+    if (w < 0)
+    {
+        x += w + 1;
+        w = -w;
+    }
+    if (h < 0)
+    {
+        y += h + 1;
+        h = -h;
+    }
+    if (x < 0)
+    {
+        w += x;
+        x = 0;
+    }
+    if (y < 0)
+    {
+        h += y;
+        y = 0;
+    }
+    if (x + w > _width)
+        w = _width - x;
+    if (y + h > _height)
+        h = _height - y;
+    if (w <= 0 || h <= 0)
+        return;
+    setAddrWindow(x, y, w, h);
+    writeColor(color, (uint32_t)w * h);
+}
+
+void Adafruit_ILI9341::begin(uint32_t f)
+{
+    freq = f;
+    uint32_t sck = min(f ? f : 24000000UL, 8000000UL); // The library's default, and F_CPU / 2
+    hal::displayByteNanos = 8000000000ULL / sck;
+    // Reset pulse, SLPOUT and DISPON waits in the upstream init sequence.
+    hal::countDisplayBytes(80);
+    hal::chargeBus(270000UL);
+    panelReset = false;
+}
+
+uint8_t Adafruit_ILI9341::readcommand8(uint8_t commandByte, uint8_t)
+{
+    hal::countDisplayBytes(3);
+    // Normal mode: booster on, idle off, partial off, sleep out, display on.
+    // Out of reset only the booster bit is set.
+    if (commandByte != ILI9341_RDMODE)
+        return 0x00;
+    return panelReset ? 0x08 : 0x9C;
+}
+
@@ -0,0 +1,660 @@
+// Entry point for the native build: runs the firmware's setup()/loop()
+// against the virtual clock and prints micro-benchmarks of the draw paths
+// and update() costs, simulates a shift of customers at the touch screen,
+// or runs it in real time with Serial on a pty. `pio test -e native` links
+// the test_native_* suites instead, each with its own main().
+#ifndef PIO_UNIT_TESTING
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <Arduino.h>
+#include <FastLED.h>
+#include "Hal.h"
+#include "leds/LEDController.h"
+#include "screen/ScreenController.h"
+#include "sched/Scheduler.h"
+#include "sched/BusArbiter.h"
+#include "sched/PerfStats.h"
+#include "pump/PumpTimer.h"
+#include "recipes/Inventory.h"
+#include <EEPROM.h>
+#include "link/SerialLink.h"
+
+extern LEDController ledController;
+extern ScreenController screen;
+extern ServoController servoController;
+extern PumpBank<PUMP_PINS> pumps;
+
+// Touch calibration from ScreenController.cpp
+static int16_t rawX(int16_t px) { return 200 + (int32_t)px * 3600 / 319; }
+static int16_t rawY(int16_t py) { return 200 + (int32_t)py * 3600 / 239; }
+
+// A finger on the glass for this long, with this much conversion noise
+#define TAP_MILLIS 80
+#define TOUCH_NOISE 40
+
+// Virtual time that passes per loop() pass on top of modelled bus time
+#define LOOP_OVERHEAD_MICROS 50
+
+// Serial link bench: a host keeping this many pings of this size in flight
+#define LINK_BENCH_PINGS 500
+#define LINK_BENCH_WINDOW 2
+#define LINK_BENCH_ARGS 16
+
+static uint32_t loopsRun = 0;
+static uint32_t longestLoopMicros = 0;
+
+static void runFor(uint32_t ms)
+{
+    uint32_t end = millis() + ms;
+    while ((int32_t)(millis() - end) < 0)
+    {
+        uint32_t start = micros();
+        loop();
+        hal::advanceMicros(LOOP_OVERHEAD_MICROS);
+        ++loopsRun;
+        if (micros() - start > longestLoopMicros)
+            longestLoopMicros = micros() - start;
+    }
+}
+
+static void tap(int16_t px, int16_t py)
+{
+    hal::setTouch(rawX(px), rawY(py), 1800);
+    runFor(TAP_MILLIS);
+    hal::releaseTouch();
+}
+
+static void printStats(const char *name, uint32_t periodMillis)
+{
+    const hal::DisplayStats &s = hal::displayStats();
+    BusArbiter::Stats &display = arbiter.stats[ARBITER_DISPLAY];
+    printf("%-28s %9u px %9u bytes %6u windows %5u txns %6.1f ms", name, s.pixels, s.bytes, s.windows, s.transactions,
+           display.maxMicros / 1000.0);
+    display.maxMicros = 0;
+    if (periodMillis > 0)
+        printf("  (SPI busy %.1f%%)", 100.0 * s.bytes / (periodMillis * 1000.0));
+    printf("\n");
+    hal::resetDisplayStats();
+}
+
+// The host end of the serial link, fed with every byte the firmware writes
+static FrameDecoder hostReceiver;
+static uint32_t hostReplies = 0;
+
+static void hostReceive(uint8_t c)
+{
+    if (hostReceiver.feed(c) && (hostReceiver.payload()[0] & LINK_REPLY))
+        ++hostReplies;
+}
+
+static uint8_t encodePing(uint8_t seq, uint8_t *frame)
+{
+    uint8_t payload[LINK_HEADER + LINK_BENCH_ARGS] = {LINK_PING, seq};
+    for (uint8_t i = 0; i < LINK_BENCH_ARGS; ++i)
+        payload[LINK_HEADER + i] = seq + i; // Zeros included, so COBS has work
+    return encodeFrame(payload, sizeof(payload), frame);
+}
+
+template <typename F>
+static double hostNanosPerCall(F fn, uint32_t calls)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < calls; ++i)
+        fn();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / calls;
+}
+
+static int runBenchmarks()
+{
+    hal::setChargeBusTime(true);
+    hal::setTouchNoise(TOUCH_NOISE);
+
+    printf("== Draw paths (bytes include address-window and command overhead; ms is the slowest single draw)\n");
+    uint32_t bootStart = micros();
+    setup();
+    uint32_t bootMicros = micros() - bootStart;
+    printStats("cold init", 0);
+
+    runFor(10000);
+    printStats("idle eye, 10 s", 10000);
+
+    tap(85, 100);
+    runFor(200);
+    printStats("wake -> regular menu", 0);
+
+    tap(160, 220);
+    runFor(200);
+    printStats("regular -> test menu", 0);
+
+    tap(130, 170);
+    runFor(200);
+    printStats("test -> regular menu", 0);
+
+    tap(85, 100);
+    runFor(1000);
+    printStats("start pour, first 1 s", 1000);
+
+    runFor(1000);
+    printStats("pour progress ticks, 1 s", 1000);
+
+    longestLoopMicros = 0;
+    runFor(19000);
+    uint32_t finishMicros = longestLoopMicros;
+    printStats("pour, finish, back to idle", 19000);
+
+    printf("\n== Boot and return to idle\n");
+    printf("cold boot: setup() %u ms, then interactive from the first loop() pass\n", bootMicros / 1000);
+    printf("drink to idle: longest loop() pass %.1f ms over the pour, finish and return\n", finishMicros / 1000.0);
+
+    printf("\n== LEDs\n");
+    printf("%u frames pushed, %u us interrupt blackout in total\n", FastLED.frames, FastLED.blackoutMicros);
+    printf("%u frames skipped as unchanged\n", ledController.framesSkipped);
+    printf("%u loop() passes over %u ms of virtual time\n", loopsRun, millis());
+    printf("\n== Bus arbiter (since setup)\n");
+    static const char *const resourceNames[ARBITER_RESOURCE_COUNT] = {"display", "touch", "led"};
+    for (uint8_t r = 0; r < ARBITER_RESOURCE_COUNT; ++r)
+    {
+        const BusArbiter::Stats &s = arbiter.stats[r];
+        printf("%-8s %5.1f%% busy  %6u slots  %4u deferred  longest %u us\n", resourceNames[r],
+               arbiter.busyPermille(r) / 10.0, s.slots, s.deferred, s.maxMicros);
+    }
+    printf("\n== Touch\n");
+    printf("%u panel reads for 4 taps\n", hal::touchReads());
+
+    // A rush: the first drink from the menu, two more ordered from the
+    // strip while it pours
+    printf("\n== Orders (since setup, the draw-path pour included)\n");
+    tap(85, 100);
+    runFor(200);
+    tap(85, 100);
+    runFor(1000);
+    tap(80, 220);
+    runFor(500);
+    tap(240, 220);
+    runFor(30000);
+    const OrderQueue::Stats &orders = screen.orderQueue().stats;
+    printf("%u drinks, %u/h while busy, mean wait %u ms, longest %u ms, queue depth up to %u\n", orders.served,
+           screen.orderQueue().drinksPerHour(), orders.served ? orders.totalWaitMillis / orders.served : 0,
+           orders.maxWaitMillis, orders.maxDepth);
+    // The test menu's Servo button: closes, then opens once closed
+    printf("\n== Servo (test menu)\n");
+    tap(85, 100);
+    runFor(200);
+    tap(160, 220);
+    runFor(200);
+    longestLoopMicros = 0;
+    uint32_t servoStart = millis();
+    tap(55, 115);
+    while (!servoController.moving() && millis() - servoStart < 1000)
+        runFor(1); // Buttons act on release
+    while (servoController.moving() && millis() - servoStart < 5000)
+        runFor(1);
+    printf("tap to open again: %u ms, longest loop() pass %u us\n", millis() - servoStart, longestLoopMicros);
+
+    // A shot and a long pour on pump 1, with a trickle rate measured
+    printf("\n== Pump drive (400 ms prime, 30 ms/ml, last %u ml at duty %u and 90 ms/ml)\n", PUMP_TRICKLE_ML,
+           PUMP_TRICKLE_DUTY);
+    PumpController &pump = pumps[0];
+    PumpProfile calibrated = pump.profile;
+    pump.profile = {400, 30 << 8, 90 << 8, PUMP_TRICKLE_DUTY, PUMP_TRICKLE_ML};
+    const uint16_t volumes[] = {5, 50};
+    for (uint16_t volume : volumes)
+    {
+        uint32_t runMillis = pump.dispenseVolume(volume);
+        uint32_t trickleMillis = pump.trickleMillis(volume);
+        uint32_t highMicros = hal::pinHighMicros(A1);
+        runFor(runMillis - trickleMillis);
+        uint32_t fullHigh = hal::pinHighMicros(A1) - highMicros;
+        runFor(trickleMillis + 2);
+        uint32_t trickleHigh = hal::pinHighMicros(A1) - highMicros - fullHigh;
+        printf("%3u ml: %5u ms, ramp and full drive %5u ms (on %5.1f%%), trickle %4u ms (on %4.1f%%), stop %d us late\n",
+               volume, runMillis, runMillis - trickleMillis, 100.0 * fullHigh / ((runMillis - trickleMillis) * 1000.0),
+               trickleMillis, 100.0 * trickleHigh / (trickleMillis * 1000.0), pump.stopJitterMicros);
+    }
+    pump.profile = calibrated;
+
+    printf("\n== Serial link (%u-byte pings, %u in flight, eye running)\n", LINK_BENCH_ARGS, LINK_BENCH_WINDOW);
+    hal::setSerialSink(hostReceive);
+    uint32_t linkStart = millis();
+    uint32_t sent = 0;
+    uint8_t frame[FRAME_MAX_ENCODED];
+    while (hostReplies < LINK_BENCH_PINGS && millis() - linkStart < 10000)
+    {
+        while (sent < LINK_BENCH_PINGS && sent - hostReplies < LINK_BENCH_WINDOW)
+            hal::serialReceive(frame, encodePing(sent++, frame));
+        runFor(1);
+    }
+    uint32_t linkMillis = millis() - linkStart;
+    printf("%u of %u replies in %u ms: %.0f requests/s, %.0f payload bytes/s each way\n", hostReplies, LINK_BENCH_PINGS,
+           linkMillis, hostReplies * 1000.0 / linkMillis, hostReplies * LINK_BENCH_ARGS * 1000.0 / linkMillis);
+    printf("%u bad frames received, %u host frames dropped, %u bytes overrun, %u writes stalled\n",
+           serialLink.received().errors, hostReceiver.errors, hal::serialOverruns(), hal::serialWriteStalls());
+    hal::setSerialSink(nullptr);
+
+#if PERF_STATS
+    // The test menu is still up from the servo run
+    printf("\n== Perf probes (since setup; buckets are log2 from %u us; only bus time is modelled, so probes\n"
+           "   that only compute read 0 here)\n", PERF_FIRST_BUCKET_MICROS);
+    hal::resetDisplayStats();
+    tap(285, 175);
+    runFor(1000);
+    printStats("test -> perf page, 1 s", 1000);
+    static const char *const probeNames[PERF_PROBE_COUNT] = {"loop", "screen", "eye", "leds", "touch",
+                                                             "pour", "servo", "link", "late"};
+    for (uint8_t p = 0; p < PERF_PROBE_COUNT; ++p)
+    {
+        const PerfStats::Probe &probe = perf.probes[p];
+        uint32_t samples = 0;
+        for (uint8_t b = 0; b < PERF_BUCKETS; ++b)
+            samples += probe.buckets[b];
+        printf("%-8s %7u samples  max %8u us  |", probeNames[p], samples, probe.maxMicros);
+        for (uint8_t b = 0; b < PERF_BUCKETS; ++b)
+            printf(" %5u", probe.buckets[b]);
+        printf("\n");
+    }
+    printf("%u deadlines missed by %u ms or more; %u records in %u ms, %.0f/s\n", perf.missed, PERF_MISSED_MILLIS,
+           perf.records, millis(), perf.records * 1000.0 / millis());
+#endif
+
+    // A pour on each pump, each saved once the batch time is up, then the journal read back as at power-up: as
+    // written, and with the newest record torn
+    printf("\n== Inventory journal (%u slots from EEPROM %u)\n", Inventory::slotCount(), INVENTORY_EEPROM_ADDRESS);
+    const uint16_t journalRecords = 300;
+    uint32_t recordsBefore = inventory.records;
+    uint32_t journalStart = millis();
+    for (uint16_t n = 0; n < journalRecords; ++n)
+    {
+        pumps[0].dispensedMl += 30;
+        ++pumps[0].pours;
+        pumps[1].dispensedMl += 20;
+        ++pumps[1].pours;
+        if (n % 50 == 0)
+            inventory.refillAll(); // Keeps the levels off zero
+        runFor(1); // Picked up, and the batch time starts
+        hal::advanceMillis(INVENTORY_BATCH_MILLIS);
+        for (uint16_t pass = 0; pass < 1000 && !inventory.saved(); ++pass)
+            runFor(1);
+    }
+    uint32_t maxWear = 0;
+    for (uint16_t a = INVENTORY_EEPROM_ADDRESS; a < INVENTORY_EEPROM_END; ++a)
+        maxWear = max(maxWear, EEPROM.wear[a]);
+    uint32_t saved = inventory.records - recordsBefore;
+    printf("%u records in %u ms, most-written cell %u times: %.0f records per 100k-cycle cell life\n", saved,
+           millis() - journalStart, maxWear, maxWear ? 100000.0 * saved / maxWear : 0.0);
+    Inventory recovered;
+    recovered.load();
+    printf("power-up: seq %u from slot %u (written seq %u, slot %u), pump 1 %u ml in %u pours\n", recovered.sequence,
+           recovered.slot, inventory.sequence, inventory.slot, recovered.reservoir(0).pouredMl,
+           recovered.reservoir(0).pours);
+    uint16_t torn = Inventory::address(inventory.slot) + 3;
+    EEPROM.write(torn, ~EEPROM.read(torn));
+    recovered.load();
+    printf("newest record torn: seq %u from slot %u\n", recovered.sequence, recovered.slot);
+    EEPROM.write(torn, ~EEPROM.read(torn));
+
+#if SCREEN_HEALTH_PERIOD
+    // The panel resets under whatever is on screen; the health check finds
+    // it, and the corner is background again once it has been redrawn
+    printf("\n== Display fault (RDMODE checked every %u ms)\n", SCREEN_HEALTH_PERIOD);
+    hal::resetDisplayStats();
+    longestLoopMicros = 0;
+    uint32_t faultStart = millis();
+    hal::resetDisplayPanel();
+    while (hal::displayPixel(0, 0) == ILI9341_WHITE && millis() - faultStart < 2 * SCREEN_HEALTH_PERIOD)
+        runFor(1);
+    printf("found and redrawn after %u ms, longest loop() pass %.1f ms\n", millis() - faultStart,
+           longestLoopMicros / 1000.0);
+    printStats("re-init and redraw", 0);
+
+#endif
+
+    printf("\n== update() cost on the host (ns/call, relative figures only)\n");
+    hal::setChargeBusTime(false);
+    printf("%-28s %9.0f\n", "scheduler.run(), idle", hostNanosPerCall([] { scheduler.run(); }, 100000));
+    printf("%-28s %9.0f\n", "ledController.update()", hostNanosPerCall([] { ledController.update(); }, 100000));
+    printf("%-28s %9.0f\n", "screen.update(), IDLE", hostNanosPerCall([] { screen.update(); }, 100000));
+    printf("%-28s %9.0f\n", "PumpTimer::service(), idle", hostNanosPerCall([] { PumpTimer::service(); }, 100000));
+#if PERF_STATS
+    printf("%-28s %9.0f\n", "PERF_SCOPE, probe and record", hostNanosPerCall([] { PERF_SCOPE(PERF_LINK); }, 100000));
+#endif
+    static uint8_t pingFrame[FRAME_MAX_ENCODED];
+    static uint8_t pingLength = encodePing(1, pingFrame);
+    static FrameDecoder decoder;
+    printf("%-28s %9.0f\n", "FrameDecoder.feed(), /byte", hostNanosPerCall([] {
+        for (uint8_t i = 0; i < pingLength; ++i)
+            decoder.feed(pingFrame[i]);
+    }, 100000) / pingLength);
+
+    return 0;
+}
+
+// Shift simulation defaults: customers per hour (Poisson arrivals), and
+// the mean time a customer takes to read the screen and tap (each one is
+// drawn from half to one and a half times it)
+#define SIM_HOURS 8
+#define SIM_RATE 40
+#define SIM_THINK_MILLIS 2000
+#define SIM_GLANCE_MILLIS 250  // Between looks at a screen that can't take the order yet
+#define SIM_DRAIN_MILLIS 3600000UL // Time allowed after the shift for the line to clear
+#define SIM_REFILL_ML 300      // The operator swaps the bottles once one has less left
+
+struct Customer
+{
+    uint32_t arrivedAt;
+    uint32_t orderedAt;
+    uint32_t servedAt;
+    uint8_t recipe;
+};
+
+struct SimOptions
+{
+    double hours = SIM_HOURS;
+    double rate = SIM_RATE;
+    uint32_t thinkMillis = SIM_THINK_MILLIS;
+    uint32_t seed = 1;
+    const char *trace = nullptr;
+};
+
+// Each line of a trace is "seconds [recipe]": the arrival time from the
+// start of the shift and the recipe index, random when left out
+static bool loadTrace(const char *path, std::mt19937 &rng, std::vector<Customer> &customers)
+{
+    FILE *f = fopen(path, "r");
+    if (f == nullptr)
+    {
+        perror(path);
+        return false;
+    }
+    char line[128];
+    while (fgets(line, sizeof(line), f))
+    {
+        double seconds;
+        int recipe = -1;
+        if (line[0] == '#' || sscanf(line, "%lf %d", &seconds, &recipe) < 1)
+            continue;
+        if (recipe < 0 || recipe >= Recipes::count())
+            recipe = rng() % Recipes::count();
+        customers.push_back({(uint32_t)(seconds * 1000), 0, 0, (uint8_t)recipe});
+    }
+    fclose(f);
+    std::stable_sort(customers.begin(), customers.end(),
+                     [](const Customer &a, const Customer &b) { return a.arrivedAt < b.arrivedAt; });
+    return true;
+}
+
+static const Button *findButton(uint8_t action, uint8_t arg)
+{
+    uint8_t count;
+    const Button *buttons = screen.menu(count);
+    for (uint8_t i = 0; i < count; ++i)
+        if (buttons[i].action == action && (action != ACTION_POUR_RECIPE || buttons[i].arg == arg))
+            return &buttons[i];
+    return nullptr;
+}
+
+static void printPercentiles(const char *name, std::vector<uint32_t> millis)
+{
+    if (millis.empty())
+        return;
+    std::sort(millis.begin(), millis.end());
+    auto at = [&](double p) { return millis[std::min(millis.size() - 1, (size_t)(p * millis.size()))] / 1000.0; };
+    printf("%-30s p50 %6.1f s  p90 %6.1f s  p99 %6.1f s  max %6.1f s\n", name, at(0.5), at(0.9), at(0.99),
+           millis.back() / 1000.0);
+}
+
+// A shift of customers against the real controllers. They queue in front
+// of the screen in arrival order; the one in front wakes it, pages to
+// their drink and taps it, or taps it on the order strip while another
+// pours, and steps aside once the order is taken. Time jumps straight to
+// whatever comes first: a scheduler deadline, a finger lifting or the next
+// customer's tap.
+static int runSimulation(const SimOptions &options)
+{
+    std::mt19937 rng(options.seed);
+    std::vector<Customer> customers;
+    if (options.trace != nullptr)
+    {
+        if (!loadTrace(options.trace, rng, customers))
+            return 1;
+    }
+    else
+    {
+        std::exponential_distribution<double> gap(options.rate / 3600000.0);
+        for (double t = gap(rng); t < options.hours * 3600000.0; t += gap(rng))
+            customers.push_back({(uint32_t)t, 0, 0, (uint8_t)(rng() % Recipes::count())});
+    }
+    std::uniform_real_distribution<double> think(0.5 * options.thinkMillis, 1.5 * options.thinkMillis);
+
+    hal::setChargeBusTime(true);
+    hal::setTouchNoise(TOUCH_NOISE);
+    auto hostStart = std::chrono::steady_clock::now();
+    setup();
+    uint32_t shiftStart = millis();
+    for (Customer &c : customers)
+        c.arrivedAt += shiftStart;
+    uint32_t shiftEnd = shiftStart + (uint32_t)(options.hours * 3600000.0);
+    if (!customers.empty())
+        shiftEnd = std::max(shiftEnd, customers.back().arrivedAt);
+
+    static const uint8_t pumpPins[] = {PUMP_PINS};
+    uint32_t lastHigh[PUMP_COUNT];
+    uint64_t highMicros[PUMP_COUNT] = {};
+    for (uint8_t p = 0; p < PUMP_COUNT; ++p)
+        lastHigh[p] = hal::pinHighMicros(pumpPins[p]);
+
+    const OrderQueue::Stats &orders = screen.orderQueue().stats;
+    uint16_t ordersSeen = orders.ordered;
+    uint16_t servedSeen = orders.served;
+    size_t nextToOrder = 0, nextToServe = 0;
+    size_t actingFor = SIZE_MAX; // The customer actAt belongs to
+    uint32_t actAt = 0;
+    uint32_t releaseAt = 0;
+    bool touching = false;
+    uint32_t wakes = 0, timeouts = 0, refills = 0;
+    ScreenState lastState = screen.state();
+    uint32_t passes = 0;
+
+    while (nextToServe < customers.size() || !timeReached(millis(), shiftEnd))
+    {
+        uint32_t now = millis();
+        if (timeReached(now, shiftEnd + SIM_DRAIN_MILLIS))
+            break;
+
+        // What the firmware did since the last pass
+        for (; ordersSeen != orders.ordered && nextToOrder < customers.size(); ++ordersSeen)
+            customers[nextToOrder++].orderedAt = now;
+        for (; servedSeen != orders.served && nextToServe < nextToOrder; ++servedSeen)
+            customers[nextToServe++].servedAt = now;
+        ScreenState state = screen.state();
+        if (lastState == ACTIVE && state == IDLE)
+            ++timeouts;
+        lastState = state;
+        for (uint8_t p = 0; p < PUMP_COUNT; ++p)
+        {
+            uint32_t high = hal::pinHighMicros(pumpPins[p]);
+            highMicros[p] += (uint32_t)(high - lastHigh[p]);
+            lastHigh[p] = high;
+        }
+        bool low = false;
+        for (uint8_t p = 0; p < PUMP_COUNT; ++p)
+            low |= inventory.remainingMl(p) < SIM_REFILL_ML;
+        if (low && state != DISPENSING)
+        {
+            inventory.refillAll();
+            ++refills;
+        }
+
+        // The customer in front
+        if (touching && timeReached(now, releaseAt))
+        {
+            hal::releaseTouch();
+            touching = false;
+        }
+        bool waiting = nextToOrder < customers.size() && timeReached(now, customers[nextToOrder].arrivedAt);
+        if (waiting && actingFor != nextToOrder)
+        {
+            actingFor = nextToOrder;
+            actAt = now + think(rng); // Steps up and reads the screen
+        }
+        if (waiting && !touching && timeReached(now, actAt))
+        {
+            const Button *target = nullptr;
+            if (state == IDLE)
+                ++wakes;
+            else if ((target = findButton(ACTION_POUR_RECIPE, customers[nextToOrder].recipe)) == nullptr && state == ACTIVE)
+                target = findButton(ACTION_NEXT_PAGE, 0);
+            if (state == IDLE || target != nullptr)
+            {
+                int16_t x = target ? target->x + target->w / 2 : 160;
+                int16_t y = target ? target->y + target->h / 2 : 120;
+                hal::setTouch(rawX(x), rawY(y), 1800);
+                touching = true;
+                releaseAt = now + TAP_MILLIS;
+                actAt = releaseAt + think(rng);
+            }
+            else
+            {
+                actAt = now + SIM_GLANCE_MILLIS;
+            }
+        }
+
+        loop();
+        ++passes;
+
+        // On to the next thing that can happen
+        now = millis();
+        uint32_t next = scheduler.millisUntilNext();
+        if (touching)
+            next = std::min(next, releaseAt - now);
+        else if (waiting)
+            next = std::min(next, actAt - now);
+        else if (nextToOrder < customers.size())
+            next = std::min(next, customers[nextToOrder].arrivedAt - now);
+        if ((int32_t)next > 0)
+            hal::advanceMillis(next);
+        else
+            hal::advanceMicros(LOOP_OVERHEAD_MICROS);
+    }
+    double hostSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - hostStart).count();
+    double simMillis = millis() - shiftStart;
+    double shiftHours = (shiftEnd - shiftStart) / 3600000.0;
+
+    std::vector<uint32_t> toOrder, toDrink, pour;
+    for (const Customer &c : customers)
+    {
+        if (c.orderedAt == 0)
+            continue;
+        toOrder.push_back(c.orderedAt - c.arrivedAt);
+        if (c.servedAt == 0)
+            continue;
+        toDrink.push_back(c.servedAt - c.arrivedAt);
+        pour.push_back(c.servedAt - c.orderedAt);
+    }
+
+    printf("== Shift: %.1f h, ", shiftHours);
+    if (options.trace)
+        printf("customers from %s", options.trace);
+    else
+        printf("%.0f customers/h", options.rate);
+    printf(", think %u ms, seed %u\n", options.thinkMillis, options.seed);
+    printf("%zu customers, %zu served, %zu ordered and waiting, %zu never ordered at the end\n", customers.size(),
+           toDrink.size(), toOrder.size() - toDrink.size(), customers.size() - toOrder.size());
+    printf("%.1f drinks/h over the shift, %u/h while busy (firmware), queue depth up to %u\n",
+           toDrink.size() / shiftHours, screen.orderQueue().drinksPerHour(), orders.maxDepth);
+    printPercentiles("arrival to order taken", toOrder);
+    printPercentiles("order taken to drink poured", pour);
+    printPercentiles("arrival to drink poured", toDrink);
+    printf("%u screen wakes, %u menu timeouts under a customer, %u bottle changes\n", wakes, timeouts, refills);
+    for (uint8_t p = 0; p < PUMP_COUNT; ++p)
+        printf("pump %u: %5.1f%% duty, %u ml in %u pours\n", p + 1, 100.0 * highMicros[p] / (simMillis * 1000.0),
+               pumps[p].dispensedMl, pumps[p].pours);
+    printf("%.1f h simulated in %.2f s (x%.0f), %u loop() passes\n", simMillis / 3600000.0, hostSeconds,
+           simMillis / 1000.0 / hostSeconds, passes);
+    return 0;
+}
+
+static int simulate(int argc, char **argv)
+{
+    SimOptions options;
+    for (int i = 0; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--hours") == 0)
+            options.hours = atof(argv[i + 1]);
+        else if (strcmp(argv[i], "--rate") == 0)
+            options.rate = atof(argv[i + 1]);
+        else if (strcmp(argv[i], "--think") == 0)
+            options.thinkMillis = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--seed") == 0)
+            options.seed = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--trace") == 0)
+            options.trace = argv[i + 1];
+        else
+            argc = -1;
+    }
+    if (argc % 2 != 0 || options.hours <= 0 || options.rate <= 0)
+    {
+        fprintf(stderr, "usage: program simulate [--hours H] [--rate PER_HOUR] [--think MS] [--seed N] [--trace FILE]\n");
+        return 2;
+    }
+    return runSimulation(options);
+}
+
+// Runs the firmware on the wall clock with Serial on a new pty, whose path
+// is printed for tools/dispenser_client.py. The far end stays open, raw,
+// so clients can come and go.
+static int runPty()
+{
+    int pty = posix_openpt(O_RDWR | O_NOCTTY);
+    if (pty < 0 || grantpt(pty) != 0 || unlockpt(pty) != 0)
+    {
+        perror("pty");
+        return 1;
+    }
+    int far = open(ptsname(pty), O_RDWR | O_NOCTTY);
+    struct termios raw;
+    tcgetattr(far, &raw);
+    cfmakeraw(&raw);
+    tcsetattr(far, TCSANOW, &raw);
+    fcntl(pty, F_SETFL, O_NONBLOCK);
+    printf("%s\n", ptsname(pty));
+    fflush(stdout);
+
+    hal::setSerialFd(pty);
+    hal::setSerialInput(pty);
+    setup();
+    auto start = std::chrono::steady_clock::now();
+    uint32_t startMicros = hal::nowMicros();
+    while (true)
+    {
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        int32_t behind = (int32_t)(startMicros + (uint32_t)elapsed.count() - hal::nowMicros());
+        if (behind > 0)
+            hal::advanceMicros(behind);
+        loop();
+        usleep(100);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const char *mode = argc > 1 ? argv[1] : "bench";
+    if (strcmp(mode, "bench") == 0)
+        return runBenchmarks();
+    if (strcmp(mode, "simulate") == 0)
+        return simulate(argc - 2, argv + 2);
+    if (strcmp(mode, "pty") == 0)
+        return runPty();
+    fprintf(stderr, "usage: %s [bench|simulate|pty]\n", argv[0]);
+    return 2;
+}
+
+#endif // PIO_UNIT_TESTING
@@ -0,0 +1,30 @@
+// Native stand-in for the SPI library; bus traffic is accounted by the
+// display sink and touch source directly.
+#ifndef NATIVE_SPI_H
+#define NATIVE_SPI_H
+
+#include <stdint.h>
+
+#define SPI_MODE0 0x00
+#define MSBFIRST 1
+
+class SPISettings
+{
+public:
+    SPISettings() {}
+    SPISettings(uint32_t clock, uint8_t, uint8_t) : clock(clock) {}
+    uint32_t clock = 4000000;
+};
+
+class SPIClass
+{
+public:
+    void begin() {}
+    void beginTransaction(SPISettings s) { current = s; }
+    void endTransaction() {}
+    uint8_t transfer(uint8_t) { return 0; }
+    SPISettings current;
+};
+extern SPIClass SPI;
+
+#endif // NATIVE_SPI_H
@@ -0,0 +1,26 @@
+// Native stand-in for the Servo library.
+#ifndef NATIVE_SERVO_H
+#define NATIVE_SERVO_H
+
+#include <stdint.h>
+
+class Servo
+{
+public:
+    uint8_t attach(int pin)
+    {
+        attachedPin = pin;
+        return 0;
+    }
+    void detach() { attachedPin = -1; }
+    void write(int value) { angle = value; }
+    void writeMicroseconds(int value) { angle = (value - 544) * 180 / (2400 - 544); }
+    int read() { return angle; }
+    bool attached() { return attachedPin >= 0; }
+
+private:
+    int attachedPin = -1;
+    int angle = 90;
+};
+
+#endif // NATIVE_SERVO_H
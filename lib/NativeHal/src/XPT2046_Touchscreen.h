@@ -0,0 +1,35 @@
+// Native stand-in for XPT2046_Touchscreen fed by the HAL touch source.
+#ifndef NATIVE_XPT2046_TOUCHSCREEN_H
+#define NATIVE_XPT2046_TOUCHSCREEN_H
+
+#include <Arduino.h>
+
+class TS_Point
+{
+public:
+    TS_Point() : x(0), y(0), z(0) {}
+    TS_Point(int16_t x, int16_t y, int16_t z) : x(x), y(y), z(z) {}
+    int16_t x, y, z;
+};
+
+class XPT2046_Touchscreen
+{
+public:
+    XPT2046_Touchscreen(uint8_t cspin, uint8_t tirq = 255) : tirqPin(tirq) {}
+    bool begin() { return true; }
+    TS_Point getPoint();
+    bool tirqTouched();
+    bool touched();
+    void readData(uint16_t *x, uint16_t *y, uint8_t *z);
+    bool bufferEmpty() { return true; }
+    uint8_t bufferSize() { return 1; }
+    void setRotation(uint8_t n) { rotation = n % 4; }
+
+    uint32_t transactions = 0;
+
+private:
+    uint8_t tirqPin;
+    uint8_t rotation = 1;
+};
+
+#endif // NATIVE_XPT2046_TOUCHSCREEN_H
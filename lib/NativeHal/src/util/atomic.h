@@ -0,0 +1,9 @@
+// Native stand-in for <util/atomic.h>: the virtual clock runs ISRs inline.
+#ifndef NATIVE_ATOMIC_H
+#define NATIVE_ATOMIC_H
+
+#define ATOMIC_RESTORESTATE
+#define ATOMIC_FORCEON
+#define ATOMIC_BLOCK(type) for (int __atomic_once = 1; __atomic_once; __atomic_once = 0)
+
+#endif // NATIVE_ATOMIC_H
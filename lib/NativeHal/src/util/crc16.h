@@ -0,0 +1,16 @@
+// Native stand-in for <util/crc16.h>: the same updates as avr-libc's, in C.
+#ifndef NATIVE_CRC16_H
+#define NATIVE_CRC16_H
+
+#include <stdint.h>
+
+// CRC-16, polynomial 0x1021, MSB first
+static inline uint16_t _crc_xmodem_update(uint16_t crc, uint8_t data)
+{
+    crc ^= (uint16_t)data << 8;
+    for (uint8_t i = 0; i < 8; ++i)
+        crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+    return crc;
+}
+
+#endif // NATIVE_CRC16_H
@@ -1,33 +1,143 @@
 #include <Arduino.h>
 #include <FastLED.h>
+#include <EEPROM.h>
 #include "leds/LEDController.h"
+#include "sched/BusArbiter.h"
+#include "sched/PerfStats.h"
 
-#define DATA_PIN A0
-#define numLEDs 16
+// Palette shared by every effect; cell 0 is the background
+enum LEDColor
+{
+    LED_BLACK,
+    LED_ORANGE_RED,
+    LED_WHITE,
+    LED_GREEN,
+    LED_COLOR_COUNT
+};
+static const uint32_t palette[LED_COLOR_COUNT] PROGMEM = {
+    CRGB::Black,
+    CRGB::OrangeRed,
+    CRGB::White,
+    CRGB::Green,
+};
+
+struct LEDKeyframe
+{
+    uint8_t cells[LED_PATTERN_CELLS]; // Palette indices
+};
+
+struct LEDEffect
+{
+    uint16_t stepMillis;   // Frame budget: the pattern changes at most this often
+    uint8_t patternLength; // Pixels before the pattern repeats, 0 for the whole strip
+    int8_t shift;          // Pixels the pattern moves along per step
+    uint8_t firstKeyframe;
+    uint8_t keyframeCount; // Played one per step, then round again
+};
+
+static const LEDKeyframe keyframes[] PROGMEM = {
+    // Idle: one pixel wiping round
+    {{LED_ORANGE_RED, LED_BLACK, LED_BLACK, LED_BLACK}},
+    // Dispensing: theater chase
+    {{LED_WHITE, LED_BLACK, LED_BLACK, LED_BLACK}},
+    // Finished: flash
+    {{LED_GREEN, LED_BLACK, LED_BLACK, LED_BLACK}},
+    {{LED_BLACK, LED_BLACK, LED_BLACK, LED_BLACK}},
+};
+
+// Indexed by LEDMode
+static const LEDEffect effects[] PROGMEM = {
+    {100, 0, 1, 0, 1},
+    {100, 3, -1, 1, 1},
+    {250, 1, 0, 2, 2},
+};
 
 LEDController::LEDController()
 {
-    leds = new CRGB[numLEDs];
 }
 
+static_assert(LED_CAPACITY >= LED_COUNT, "The frame buffer must hold the fitted ring");
+static_assert((uint32_t)LED_CAPACITY * LED_MICROS_PER_PIXEL <= 0xFFFF, "A full push must fit an arbiter slot");
+
 void LEDController::begin()
 {
-    FastLED.addLeds<NEOPIXEL, DATA_PIN>(leds, numLEDs);
+    uint16_t stored;
+    EEPROM.get(LED_LENGTH_EEPROM_ADDRESS, stored);
+    count = stored <= LED_CAPACITY ? stored : LED_COUNT;
+    FastLED.addLeds<NEOPIXEL, LED_DATA_PIN>(leds, count);
     FastLED.setBrightness(100); // Set initial brightness to 50%
     // Default to IDLE mode
     mode = IDLE_LEDS;
 
-    lastUpdate = millis();
-    idleIndex = 0;
-    rainbowHue = 0;
-    finishedOn = false;
+    scheduler.cancel(frameTask);
+    frameTask = scheduler.every(framePeriod(), onFrame, this);
+    restart();
+}
+
+bool LEDController::setLength(uint16_t newCount)
+{
+    if (newCount > LED_CAPACITY)
+        return false;
+    // Pixels past the new end would keep their colour: update() pushes them
+    // once more, black
+    for (uint16_t i = newCount; i < count; ++i)
+        leds[i] = CRGB::Black;
+    count = newCount;
+    EEPROM.put(LED_LENGTH_EEPROM_ADDRESS, count); // Only rewrites bytes that changed
+    scheduler.setPeriod(frameTask, framePeriod());
+    restart();
+    return true;
+}
+
+// The effect's own step, stretched if the strip is too long to show that often
+uint32_t LEDController::framePeriod() const
+{
+    uint32_t stepMillis = pgm_read_word(&effects[mode].stepMillis);
+    uint32_t minMillis = (uint32_t)count * LED_MICROS_PER_PIXEL / (10 * LED_MAX_BLACKOUT_PERCENT);
+    return stepMillis > minMillis ? stepMillis : minMillis;
+}
+
+void LEDController::restart()
+{
+    effectStart = millis();
+    dirty = true;
+    scheduler.reschedule(frameTask, 0); // Keep frames in step with the effect
+}
+
+void LEDController::setMode(LEDMode newMode)
+{
+    mode = newMode;
+    scheduler.cancel(modeTask);
+    scheduler.setPeriod(frameTask, framePeriod());
+    restart();
+}
+
+void LEDController::setModeAfter(LEDMode newMode, uint32_t delayMillis)
+{
+    nextUpdateMode = newMode;
+    scheduler.cancel(modeTask);
+    modeTask = scheduler.after(delayMillis, onModeTimer, this);
+}
+
+void LEDController::onModeTimer(void *context)
+{
+    LEDController *self = static_cast<LEDController *>(context);
+    self->modeTask = TASK_NONE;
+    self->setMode(self->nextUpdateMode);
+}
+
+void LEDController::onFrame(void *context)
+{
+    PERF_SCOPE(PERF_LEDS);
+    static_cast<LEDController *>(context)->update();
 }
 
 void LEDController::setColor(int index, CRGB color)
 {
-    if (index >= 0 && index < numLEDs)
+    if (index >= 0 && index < count)
     {
         leds[index] = color;
+        dirty = true;
     }
 }
 
@@ -36,50 +146,55 @@ void LEDController::show()
     FastLED.show();
 }
 
+// Draws the effect's current frame if the strip isn't already showing it;
+// runs as a periodic task at framePeriod()
 void LEDController::update()
 {
-    uint32_t now = millis();
+    uint16_t pushed = lit > count ? lit : count; // Blanks what a shorter length cut off
+    if (pushed == 0)
+        return;
+    LEDEffect effect;
+    memcpy_P(&effect, &effects[mode], sizeof(LEDEffect));
+
+    uint32_t step = (millis() - effectStart) / effect.stepMillis;
+    uint8_t keyframe = effect.firstKeyframe + step % effect.keyframeCount;
+    uint16_t patternLength = effect.patternLength ? effect.patternLength : count;
+    int32_t offset = patternLength ? (int32_t)(step % patternLength) * effect.shift % patternLength : 0;
+    if (offset < 0)
+        offset += patternLength;
 
-    if (nextUpdateTime !=0 && now > nextUpdateTime) {
-        mode = nextUpdateMode;
-        nextUpdateTime = 0;
+    if (!dirty && keyframe == shownKeyframe && offset == shownOffset)
+    {
+        ++framesSkipped;
+        return;
     }
+    if (!arbiter.acquire(ARBITER_LED, pushed * LED_MICROS_PER_PIXEL))
+    {
+        // A pump or servo edge is due inside the blackout; try again shortly
+        scheduler.reschedule(frameTask, ARBITER_RETRY_MILLIS);
+        return;
+    }
+
+    LEDKeyframe frame;
+    memcpy_P(&frame, &keyframes[keyframe], sizeof(LEDKeyframe));
+    CRGB colors[LED_PATTERN_CELLS];
+    for (uint8_t c = 0; c < LED_PATTERN_CELLS; ++c)
+        colors[c] = CRGB(pgm_read_dword(&palette[frame.cells[c]]));
 
-    switch (mode) {
-        case IDLE_LEDS:
-            // Slow blue color wipe
-            if (now - lastUpdate > 100) {
-                for (int i = 0; i < numLEDs; ++i) leds[i] = CRGB::Black;
-                leds[idleIndex] = CRGB::OrangeRed;
-                idleIndex = (idleIndex + 1) % numLEDs;
-                show();
-                lastUpdate = now;
-            }
-            break;
-        case DISPENSING_LEDS:
-            // Theater chase white
-            if (now - lastUpdate > 30) {
-                for (int i = 0; i < numLEDs; ++i) {
-                    if ((i + (now / 100)) % 3 == 0) {
-                        leds[i] = CRGB::White;
-                    } else {
-                        leds[i] = CRGB::Black;
-                    }
-                }
-                show();
-                lastUpdate = now;
-            }
-            break;
-        case FINISHED_LEDS:
-            // All LEDs flash green
-            if (now - lastUpdate > 250) {
-                finishedOn = !finishedOn;
-                for (int i = 0; i < numLEDs; ++i) {
-                    leds[i] = finishedOn ? CRGB::Green : CRGB::Black;
-                }
-                show();
-                lastUpdate = now;
-            }
-            break;
+    // Pixel i shows pattern cell (i - offset) mod patternLength
+    uint16_t cell = offset ? patternLength - offset : 0;
+    for (uint16_t i = 0; i < count; ++i)
+    {
+        leds[i] = cell < LED_PATTERN_CELLS ? colors[cell] : CRGB(CRGB::Black);
+        if (++cell == patternLength)
+            cell = 0;
     }
-}
\ No newline at end of file
+    FastLED[0].setLeds(leds, pushed);
+    show();
+    arbiter.release(ARBITER_LED);
+    lit = count;
+    ++framesShown;
+    shownKeyframe = keyframe;
+    shownOffset = offset;
+    dirty = false;
+}
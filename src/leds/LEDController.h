@@ -3,6 +3,17 @@
 
 #include <Arduino.h>
 #include <FastLED.h>
+#include "sched/Scheduler.h"
+
+#define LED_DATA_PIN A0
+#define LED_COUNT 16                // The fitted ring
+#ifndef LED_CAPACITY
+#define LED_CAPACITY 144            // Frame buffer, 3 bytes a pixel: the 144-pixel bar, 384 bytes more than the ring
+#endif
+#define LED_LENGTH_EEPROM_ADDRESS 1022 // u16 strip length, after the inventory journal; blank reads as LED_COUNT
+#define LED_MICROS_PER_PIXEL 30     // show() holds interrupts off this long per pixel
+#define LED_MAX_BLACKOUT_PERCENT 5  // Share of the time show() may hold interrupts off
+#define LED_PATTERN_CELLS 4         // Palette cells per keyframe; later cells are black
 
 enum LEDMode
 {
@@ -10,26 +21,53 @@ enum LEDMode
     DISPENSING_LEDS,
     FINISHED_LEDS
 };
+
+/**
+ * Table-driven strip animation. Each mode plays an effect from flash: a
+ * short pattern of palette cells repeated along the strip, stepped every
+ * stepMillis by moving it and moving on to the next keyframe. A frame is a
+ * function of (keyframe, offset) alone, so update() only renders and calls
+ * FastLED.show() when one of those has changed. Frames are also spaced far
+ * enough apart that show() never keeps interrupts off for more than
+ * LED_MAX_BLACKOUT_PERCENT of the time, however long the strip.
+ *
+ * The strip length is set at run time (LINK_LEDS), up to LED_CAPACITY, and
+ * kept in EEPROM for begin(). Pixels a shorter length leaves off the end
+ * are blanked by the next frame, inside its arbiter slot like any other.
+ */
 class LEDController
 {
 public:
     LEDController();
 
     void begin();
+    bool setLength(uint16_t count); // Pixels driven, up to LED_CAPACITY; kept for the next begin()
+    uint16_t length() const { return count; }
     void setColor(int index, CRGB color);
     void show();
     void update();
+    void setMode(LEDMode newMode);
+    void setModeAfter(LEDMode newMode, uint32_t delayMillis);
     LEDMode mode; // Add mode member to track current state
 
-    uint32_t nextUpdateTime = 0;
     LEDMode nextUpdateMode;
+    uint32_t framesShown = 0;
+    uint32_t framesSkipped = 0; // Ticks whose frame was already on the strip
 private:
-    CRGB *leds;
-    uint32_t lastUpdate;
-    int idleIndex;
-    uint8_t rainbowHue;
-    bool finishedOn;
+    static void onFrame(void *context);
+    static void onModeTimer(void *context);
+    uint32_t framePeriod() const;
+    void restart();
 
+    CRGB leds[LED_CAPACITY];
+    uint16_t count = LED_COUNT;
+    uint16_t lit = 0; // Pixels the last frame pushed
+    TaskHandle frameTask = TASK_NONE;
+    TaskHandle modeTask = TASK_NONE;
+    uint32_t effectStart = 0;
+    uint8_t shownKeyframe = 0;
+    uint16_t shownOffset = 0;
+    bool dirty = true; // The strip no longer shows (shownKeyframe, shownOffset)
 };
 
-#endif // LEDCONTROLLER_H
\ No newline at end of file
+#endif // LEDCONTROLLER_H
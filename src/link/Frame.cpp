@@ -0,0 +1,33 @@
+#include <Arduino.h>
+#include "link/Frame.h"
+
+uint16_t encodeFrame(const uint8_t *payload, uint16_t length, uint8_t *out)
+{
+    uint16_t crc = FRAME_CRC_INIT;
+    for (uint16_t i = 0; i < length; ++i)
+        crc = _crc_xmodem_update(crc, payload[i]);
+
+    // Each block starts with a code byte: one more than the non-zero bytes
+    // that follow, standing in for the zero after them
+    uint16_t codeAt = 0;
+    uint8_t code = 1;
+    uint16_t n = 1;
+    for (uint16_t i = 0; i < length + 2; ++i)
+    {
+        uint8_t byte = i < length ? payload[i] : i == length ? crc >> 8 : crc & 0xFF;
+        if (byte != 0)
+        {
+            out[n++] = byte;
+            ++code;
+        }
+        if (byte == 0 || code == 0xFF)
+        {
+            out[codeAt] = code;
+            codeAt = n++;
+            code = 1;
+        }
+    }
+    out[codeAt] = code;
+    out[n++] = 0;
+    return n;
+}
@@ -0,0 +1,106 @@
+#ifndef FRAME_H
+#define FRAME_H
+
+#include <Arduino.h>
+
+#include <util/crc16.h>
+
+#define FRAME_MAX_PAYLOAD 32
+#define FRAME_CRC_INIT 0xFFFF
+// COBS adds one code byte per 254 bytes or part of them, here payload and
+// CRC, then the delimiter
+#define FRAME_ENCODED_SIZE(payload) ((payload) + 2 + ((payload) + 2) / 254 + 1 + 1)
+#define FRAME_MAX_ENCODED FRAME_ENCODED_SIZE(FRAME_MAX_PAYLOAD)
+
+/**
+ * Frames on the serial link: the payload and its CRC-16 (CCITT, sent high
+ * byte first) are COBS encoded, so the only zero on the wire is the
+ * delimiter that ends each frame. A receiver that joins mid-stream, or
+ * loses bytes, is back in step at the next zero.
+ */
+uint16_t encodeFrame(const uint8_t *payload, uint16_t length, uint8_t *out); // Returns the bytes to send
+
+/**
+ * Incremental frame receiver. feed() takes one byte at a time, undoes the
+ * COBS encoding into a fixed buffer and runs the CRC as it goes, so a frame
+ * is checked the moment its delimiter arrives. Frames that overflow the
+ * buffer, break the encoding or fail the CRC are counted and dropped.
+ * The link's own is FrameDecoder; hosts and tests may take longer frames.
+ */
+template <uint16_t MaxPayload>
+class BasicFrameDecoder
+{
+public:
+    bool feed(uint8_t byte); // True when byte completed a good frame
+    const uint8_t *payload() const { return buffer; }
+    uint16_t length() const { return size - 2; }
+
+    uint16_t frames = 0; // Good frames received
+    uint16_t errors = 0; // Bad frames dropped
+
+private:
+    uint8_t buffer[MaxPayload + 2];
+    uint16_t size = 0;
+    uint8_t code = 0; // Code byte of the current block, 0 before the first
+    uint8_t left = 0; // Bytes of the block still to come
+    bool overflow = false;
+    uint16_t crc = FRAME_CRC_INIT;
+
+    void append(uint8_t byte);
+    void restart();
+};
+
+typedef BasicFrameDecoder<FRAME_MAX_PAYLOAD> FrameDecoder;
+
+template <uint16_t MaxPayload>
+bool BasicFrameDecoder<MaxPayload>::feed(uint8_t byte)
+{
+    if (byte == 0)
+    {
+        // The CRC, run over the payload and the CRC itself, leaves zero
+        bool good = code != 0 && left == 0 && !overflow && size > 2 && crc == 0;
+        if (good)
+            ++frames;
+        else if (code != 0)
+            ++errors; // Back-to-back delimiters aren't an error
+        code = 0;
+        left = 0;
+        return good;
+    }
+    if (left == 0)
+    {
+        if (code == 0)
+            restart();
+        else if (code != 0xFF)
+            append(0); // A full block of 254 stands for no zero
+        code = byte;
+        left = byte - 1;
+        return false;
+    }
+    append(byte);
+    --left;
+    return false;
+}
+
+template <uint16_t MaxPayload>
+void BasicFrameDecoder<MaxPayload>::append(uint8_t byte)
+{
+    if (size == sizeof(buffer))
+    {
+        overflow = true;
+        return;
+    }
+    buffer[size++] = byte;
+    crc = _crc_xmodem_update(crc, byte);
+}
+
+// The last frame stays readable until the next one starts
+template <uint16_t MaxPayload>
+void BasicFrameDecoder<MaxPayload>::restart()
+{
+    size = 0;
+    overflow = false;
+    crc = FRAME_CRC_INIT;
+}
+
+#endif // FRAME_H
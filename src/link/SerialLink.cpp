@@ -0,0 +1,171 @@
+#include <Arduino.h>
+#include "link/SerialLink.h"
+#include "sched/Scheduler.h"
+#include "sched/PerfStats.h"
+#include "sched/StackGauge.h"
+#include "telemetry/Telemetry.h"
+
+SerialLink serialLink;
+
+// A text telemetry build keeps the port as a plain serial console
+void SerialLink::begin()
+{
+#if !TELEMETRY_TEXT
+    Serial.begin(LINK_BAUD);
+    scheduler.onIdle(onIdle);
+#endif
+}
+
+void SerialLink::setHandler(LinkHandler handler, void *context)
+{
+    this->handler = handler;
+    handlerContext = context;
+}
+
+void SerialLink::onIdle()
+{
+    serialLink.service();
+    telemetry.drain();
+}
+
+void SerialLink::service()
+{
+    while (true)
+    {
+        if (replyLength != 0)
+        {
+            if (!send(reply, replyLength))
+                return; // Requests behind it wait in the UART's buffer
+            replyLength = 0;
+            ++replies;
+        }
+        if (Serial.available() <= 0)
+            return;
+        if (decoder.feed(Serial.read()))
+        {
+            PERF_SCOPE(PERF_LINK);
+            answer(decoder.payload(), decoder.length());
+        }
+    }
+}
+
+void SerialLink::answer(const uint8_t *request, uint8_t length)
+{
+    if (length < LINK_HEADER || (request[0] & LINK_REPLY))
+        return; // Not a request
+    uint8_t message = request[0];
+    const uint8_t *args = request + LINK_HEADER;
+    uint8_t argCount = length - LINK_HEADER;
+    uint8_t *data = reply + 3;
+    uint8_t dataLength = 0;
+    uint8_t status;
+
+    if (message == LINK_PING)
+    {
+        dataLength = min(argCount, (uint8_t)LINK_MAX_DATA);
+        memcpy(data, args, dataLength);
+        status = LINK_OK;
+    }
+    else if (message == LINK_TELEMETRY)
+    {
+        status = argCount == 1 && args[0] <= 1 ? LINK_OK : LINK_BAD_ARGS;
+        if (status == LINK_OK)
+            streaming = args[0];
+    }
+    else if (message == LINK_MEMORY)
+    {
+        uint8_t *out = put16(data, StackGauge::ramBytes());
+        out = put16(out, StackGauge::staticBytes());
+        out = put16(out, StackGauge::freeNow());
+        out = put16(out, stackGauge.headroom());
+        dataLength = out - data;
+        status = LINK_OK;
+    }
+#if PERF_STATS
+    else if (message == LINK_PERF)
+    {
+        status = answerPerf(args, argCount, data, dataLength);
+    }
+#endif
+    else if (handler != nullptr)
+    {
+        status = handler(handlerContext, message, args, argCount, data, dataLength);
+    }
+    else
+    {
+        status = LINK_UNKNOWN;
+    }
+
+    reply[0] = message | LINK_REPLY;
+    reply[1] = request[1];
+    reply[2] = status;
+    replyLength = 3 + dataLength;
+}
+
+#if PERF_STATS
+uint8_t SerialLink::answerPerf(const uint8_t *args, uint8_t argCount, uint8_t *data, uint8_t &dataLength)
+{
+    static_assert(4 + 2 * PERF_BUCKETS <= LINK_MAX_DATA, "LINK_PERF reply too long");
+    uint8_t *out = data;
+    if (argCount == 0)
+    {
+        *out++ = PERF_PROBE_COUNT;
+        *out++ = PERF_BUCKETS;
+        out = put16(out, perf.missed);
+    }
+    else if (argCount == 1 && args[0] == 0xFF)
+    {
+        perf.reset();
+    }
+    else if (argCount == 1 && args[0] < PERF_PROBE_COUNT)
+    {
+        const PerfStats::Probe &probe = perf.probes[args[0]];
+        out = put32(out, probe.maxMicros);
+        for (uint8_t i = 0; i < PERF_BUCKETS; ++i)
+            out = put16(out, probe.buckets[i]);
+    }
+    else
+    {
+        return LINK_BAD_ARGS;
+    }
+    dataLength = out - data;
+    return LINK_OK;
+}
+#endif
+
+// Whole frames or nothing, so the port never blocks mid-frame
+bool SerialLink::send(const uint8_t *payload, uint8_t length)
+{
+    if (Serial.availableForWrite() < length + (FRAME_MAX_ENCODED - FRAME_MAX_PAYLOAD))
+        return false;
+    uint8_t frame[FRAME_MAX_ENCODED];
+    uint8_t n = encodeFrame(payload, length, frame);
+    Serial.write(frame, n);
+    return true;
+}
+
+uint8_t SerialLink::sendEvents(const uint8_t *data, uint8_t length)
+{
+    if (!streaming)
+        return length; // Nobody is listening, let the ring empty
+    if (replyLength != 0)
+        return 0;
+    uint8_t payload[FRAME_MAX_PAYLOAD];
+    uint8_t n = min(length, (uint8_t)(FRAME_MAX_PAYLOAD - 1));
+    payload[0] = LINK_EVENTS;
+    memcpy(payload + 1, data, n);
+    return send(payload, n + 1) ? n : 0;
+}
+
+uint8_t *SerialLink::put16(uint8_t *out, uint16_t value)
+{
+    out[0] = value;
+    out[1] = value >> 8;
+    return out + 2;
+}
+
+uint8_t *SerialLink::put32(uint8_t *out, uint32_t value)
+{
+    out = put16(out, value);
+    return put16(out, value >> 16);
+}
@@ -0,0 +1,80 @@
+#ifndef SERIAL_LINK_H
+#define SERIAL_LINK_H
+
+#include <Arduino.h>
+#include "link/Frame.h"
+
+#define LINK_BAUD 115200
+
+// First payload byte. Requests are [message, seq, args...]; the reply is
+// [message | LINK_REPLY, seq, status, data...], numbers little-endian.
+enum LinkMessage : uint8_t
+{
+    LINK_PING = 0x01,        // Replies with its arguments
+    LINK_ORDER = 0x02,       // u8 recipe -> u8 orders waiting
+    LINK_PUMP_STATE = 0x03,  // [u8 first pump] -> u8 pumps, then from the first, up to 2 of: u8 running, u32 ms left, u32 ml poured since boot, u16 prime ms, u16 ms/ml Q8
+    LINK_ORDER_STATE = 0x04, // -> u8 screen state, u8 waiting, u16 served, u16 drinks/h, u32 longest wait ms, u8 longest queue
+    LINK_TELEMETRY = 0x05,   // u8 0 stops, 1 starts the event stream
+    LINK_PERF = 0x06,        // -> u8 probes, u8 buckets, u16 missed; u8 probe -> u32 max us, u16 per bucket; u8 0xFF clears
+    LINK_INVENTORY = 0x07,   // [u8 first pump] -> u8 pumps, then up to 2 of: u32 ml poured, u32 pours, u16 ml left, u16 capacity; u8 pump, u16 ml -> refilled to that size
+    LINK_MEMORY = 0x08,      // -> u16 RAM, u16 static, u16 free now, u16 never used by the stack
+    LINK_LEDS = 0x09,        // [u16 pixels, kept across power cycles] -> u16 pixels driven, u16 most
+    LINK_EVENTS = 0x40,      // Unsolicited: [LINK_EVENTS, telemetry bytes...], records may span frames
+    LINK_REPLY = 0x80
+};
+
+enum LinkStatus : uint8_t
+{
+    LINK_OK,
+    LINK_UNKNOWN,   // Message not recognised
+    LINK_BAD_ARGS,
+    LINK_REFUSED    // Valid, but not now (queue full, ...)
+};
+
+#define LINK_HEADER 2                        // Message and sequence number
+#define LINK_MAX_DATA (FRAME_MAX_PAYLOAD - 3) // Reply data after message, seq and status
+
+// Answers the messages the link doesn't handle itself. Returns the status
+// and leaves up to LINK_MAX_DATA bytes of reply data in data.
+typedef uint8_t (*LinkHandler)(void *context, uint8_t message, const uint8_t *args, uint8_t argCount, uint8_t *data, uint8_t &dataLength);
+
+/**
+ * Control protocol on the serial port, in framed binary (see Frame.h). It
+ * runs from the scheduler's idle hook: service() takes only the bytes that
+ * have arrived, answers each complete request, and leaves a reply pending
+ * until the transmit buffer has room for all of it, so nothing here waits
+ * on the UART. Telemetry rides the same port as LINK_EVENTS frames, sent
+ * only while no reply is waiting.
+ */
+class SerialLink
+{
+public:
+    void begin();
+    void setHandler(LinkHandler handler, void *context);
+    void service();
+    uint8_t sendEvents(const uint8_t *data, uint8_t length); // Bytes taken, 0 while the port is busy
+
+    const FrameDecoder &received() const { return decoder; }
+
+    bool streaming = true; // LINK_EVENTS frames on, set by LINK_TELEMETRY
+    uint16_t replies = 0;
+
+    static uint8_t *put16(uint8_t *out, uint16_t value);
+    static uint8_t *put32(uint8_t *out, uint32_t value);
+
+private:
+    FrameDecoder decoder;
+    LinkHandler handler = nullptr;
+    void *handlerContext = nullptr;
+    uint8_t reply[FRAME_MAX_PAYLOAD];
+    uint8_t replyLength = 0; // Non-zero while a reply waits for room
+
+    void answer(const uint8_t *request, uint8_t length);
+    uint8_t answerPerf(const uint8_t *args, uint8_t argCount, uint8_t *data, uint8_t &dataLength);
+    bool send(const uint8_t *payload, uint8_t length);
+    static void onIdle();
+};
+
+extern SerialLink serialLink;
+
+#endif // SERIAL_LINK_H
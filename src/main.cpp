@@ -1,40 +1,52 @@
 #include <Arduino.h>
 #include "screen/ScreenController.h"
 #include "leds/LEDController.h"
-#include "pump/PumpController.h"
+#include "pump/PumpBank.h"
+#include "pump/PumpCalibration.h"
+#include "recipes/Inventory.h"
 #include "servo/ServoController.h"
+#include "sched/Scheduler.h"
+#include "sched/StackGauge.h"
+#include "telemetry/Telemetry.h"
+#include "link/SerialLink.h"
 
 // For the Adafruit shield, these are the default.
 #define TFT_DC 9
 #define TFT_CS 10
 #define TFT_RST 8
 #define TOUCH_CS 7
+#define TOUCH_IRQ 2 // XPT2046 T_IRQ, on INT0
 
 
-PumpController pump1(A1);
-PumpController pump2(A2);
-// PumpController pump3(A5);
+PumpBank<PUMP_PINS> pumps;
 
 ServoController servoController(3);
 
 LEDController ledController;
-ScreenController screen(TFT_CS, TFT_DC, TFT_RST, TOUCH_CS, &ledController, &pump1, &pump2, &servoController);
+ScreenController screen(TFT_CS, TFT_DC, TFT_RST, TOUCH_CS, TOUCH_IRQ, &ledController, pumps.pumps, &servoController);
 
 void setup() {
-  // Serial.begin(9600);
-  // Serial.println("Dispenser Starting..."); 
+  // Framed control protocol on Serial, carrying the binary event log,
+  // both serviced while the scheduler is idle
+  serialLink.begin();
+  telemetry.begin();
+
+  // Pumps are switched from the Timer2 ISR so pours don't depend on loop latency
+  pumps.begin();
+  for (uint8_t i = 0; i < PUMP_COUNT; ++i)
+    PumpCalibration::load(i, pumps[i].profile);
+  inventory.begin(pumps.pumps); // Reservoir levels, saved from idle time
 
   ledController.begin();
-  screen.begin();
+  screen.begin(); // Most of the boot: the panel's init sequence and the first clear
+  TELEMETRY(READY, millis());
+  stackGauge.begin(); // Stack headroom, from the paint left since reset
 }
 
 
 void loop() {
-  screen.update();
-  ledController.update();
-  pump1.update();
-  pump2.update();
-  // pump3.update();
-  servoController.update();
+  // Runs whatever is due (screen, eye, LEDs, servo, pump and state timers)
+  // and idles the CPU until the next deadline
+  scheduler.run();
 }
 
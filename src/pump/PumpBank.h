@@ -0,0 +1,163 @@
+#ifndef PUMP_BANK_H
+#define PUMP_BANK_H
+
+#include <Arduino.h>
+#include "pump/PumpController.h"
+#include "pump/PumpTimer.h"
+
+// Pump output pins in ingredient order (Recipes.h pump 0 first). Up to 8;
+// -D 'PUMP_PINS=A1,A2,A3,A4' adds pumps with nothing else to change.
+#ifndef PUMP_PINS
+#define PUMP_PINS A1, A2
+#endif
+
+// ATmega328P: D0-D7 are PORTD, D8-D13 PORTB, A0-A5 (14-19) PORTC
+enum PumpPort : uint8_t
+{
+    PUMP_PORT_B,
+    PUMP_PORT_C,
+    PUMP_PORT_D,
+    PUMP_PORT_COUNT
+};
+
+constexpr uint8_t pumpPinPort(uint8_t pin)
+{
+    return pin < 8 ? PUMP_PORT_D : pin < 14 ? PUMP_PORT_B : PUMP_PORT_C;
+}
+
+constexpr uint8_t pumpPinBit(uint8_t pin)
+{
+    return 1 << (pin < 8 ? pin : pin < 14 ? pin - 8 : pin - 14);
+}
+
+constexpr uint8_t pumpPortMask(uint8_t)
+{
+    return 0;
+}
+
+template <typename... Rest>
+constexpr uint8_t pumpPortMask(uint8_t port, uint8_t pin, Rest... rest)
+{
+    return (pumpPinPort(pin) == port ? pumpPinBit(pin) : 0) | pumpPortMask(port, rest...);
+}
+
+constexpr uint8_t pumpBitCount(uint8_t mask)
+{
+    return mask == 0 ? 0 : (mask & 1) + pumpBitCount(mask >> 1);
+}
+
+constexpr bool pumpPinsValid()
+{
+    return true;
+}
+
+template <typename... Rest>
+constexpr bool pumpPinsValid(uint8_t pin, Rest... rest)
+{
+    return pin < 20 && pumpPinsValid(rest...);
+}
+
+/**
+ * The dispenser's pumps, one PumpController per pin. The pins are resolved
+ * to port bits at compile time, and the Timer2 ISR services every pump in
+ * one loop, then writes each port the pumps use once: pumps due together
+ * switch on the same instruction, and no pin is looked up at run time.
+ *
+ * A port is only written when its pump bits change, with interrupts off,
+ * but code that read-modify-writes the same port with interrupts on could
+ * still put a stale pump bit back until the next tick. The default pins are
+ * on PORTC, which nothing else in the dispenser drives.
+ */
+template <uint8_t... Pins>
+class PumpBank {
+public:
+    static const uint8_t COUNT = sizeof...(Pins);
+    static_assert(COUNT > 0 && COUNT <= 8, "PourPlanner masks hold 8 pumps");
+    static_assert(pumpPinsValid(Pins...), "Pump pins must be D0-D13 or A0-A5");
+    static_assert(pumpBitCount(pumpPortMask(PUMP_PORT_B, Pins...)) + pumpBitCount(pumpPortMask(PUMP_PORT_C, Pins...)) +
+                      pumpBitCount(pumpPortMask(PUMP_PORT_D, Pins...)) == COUNT,
+                  "A pump pin is listed twice");
+
+    PumpController pumps[COUNT];
+
+    PumpBank() : pumps{Pins...} {}
+
+    PumpController &operator[](uint8_t i) { return pumps[i]; }
+
+    // All off, then handed to the Timer2 ISR
+    void begin() {
+        on[PUMP_PORT_B] = on[PUMP_PORT_C] = on[PUMP_PORT_D] = 0;
+#if defined(__AVR__)
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            if (pumpPortMask(PUMP_PORT_B, Pins...)) {
+                PORTB &= ~pumpPortMask(PUMP_PORT_B, Pins...);
+                DDRB |= pumpPortMask(PUMP_PORT_B, Pins...);
+            }
+            if (pumpPortMask(PUMP_PORT_C, Pins...)) {
+                PORTC &= ~pumpPortMask(PUMP_PORT_C, Pins...);
+                DDRC |= pumpPortMask(PUMP_PORT_C, Pins...);
+            }
+            if (pumpPortMask(PUMP_PORT_D, Pins...)) {
+                PORTD &= ~pumpPortMask(PUMP_PORT_D, Pins...);
+                DDRD |= pumpPortMask(PUMP_PORT_D, Pins...);
+            }
+        }
+#else
+        for (uint8_t i = 0; i < COUNT; ++i) {
+            pinMode(pins[i], OUTPUT);
+            digitalWrite(pins[i], LOW);
+        }
+#endif
+        PumpTimer::attach(service, this);
+        PumpTimer::begin();
+    }
+
+private:
+    static constexpr uint8_t pins[COUNT] = {Pins...};
+    static constexpr uint8_t ports[COUNT] = {pumpPinPort(Pins)...};
+    static constexpr uint8_t bits[COUNT] = {pumpPinBit(Pins)...};
+    uint8_t on[PUMP_PORT_COUNT]; // Pump bits last written, per port
+
+    static uint32_t service(void *context, uint32_t nowMicros) {
+        PumpBank *bank = static_cast<PumpBank *>(context);
+        uint32_t earliest = 0xFFFFFFFF;
+        uint8_t level[PUMP_PORT_COUNT] = {0, 0, 0};
+        for (uint8_t i = 0; i < COUNT; ++i) {
+            uint32_t untilNext = bank->pumps[i].service(nowMicros);
+            if (untilNext < earliest) earliest = untilNext;
+            if (bank->pumps[i].running()) level[ports[i]] |= bits[i];
+        }
+        bank->write(level);
+        return earliest;
+    }
+
+    // Ports with no pumps drop out at compile time
+    void write(const uint8_t *level) {
+#if defined(__AVR__)
+        if (pumpPortMask(PUMP_PORT_B, Pins...) && level[PUMP_PORT_B] != on[PUMP_PORT_B])
+            PORTB = (PORTB & ~pumpPortMask(PUMP_PORT_B, Pins...)) | level[PUMP_PORT_B];
+        if (pumpPortMask(PUMP_PORT_C, Pins...) && level[PUMP_PORT_C] != on[PUMP_PORT_C])
+            PORTC = (PORTC & ~pumpPortMask(PUMP_PORT_C, Pins...)) | level[PUMP_PORT_C];
+        if (pumpPortMask(PUMP_PORT_D, Pins...) && level[PUMP_PORT_D] != on[PUMP_PORT_D])
+            PORTD = (PORTD & ~pumpPortMask(PUMP_PORT_D, Pins...)) | level[PUMP_PORT_D];
+#else
+        for (uint8_t i = 0; i < COUNT; ++i)
+            if ((level[ports[i]] ^ on[ports[i]]) & bits[i])
+                digitalWrite(pins[i], (level[ports[i]] & bits[i]) != 0);
+#endif
+        on[PUMP_PORT_B] = level[PUMP_PORT_B];
+        on[PUMP_PORT_C] = level[PUMP_PORT_C];
+        on[PUMP_PORT_D] = level[PUMP_PORT_D];
+    }
+};
+
+template <uint8_t... Pins>
+constexpr uint8_t PumpBank<Pins...>::pins[];
+template <uint8_t... Pins>
+constexpr uint8_t PumpBank<Pins...>::ports[];
+template <uint8_t... Pins>
+constexpr uint8_t PumpBank<Pins...>::bits[];
+
+#define PUMP_COUNT (PumpBank<PUMP_PINS>::COUNT)
+
+#endif // PUMP_BANK_H
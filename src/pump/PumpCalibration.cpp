@@ -0,0 +1,74 @@
+#include <Arduino.h>
+#include <EEPROM.h>
+#include "pump/PumpCalibration.h"
+#include "telemetry/Telemetry.h"
+
+uint8_t PumpCalibration::checksum(const Record &record)
+{
+    // Complemented so an erased (all 0xFF) record never passes
+    const uint8_t *bytes = (const uint8_t *)&record;
+    uint8_t sum = 0;
+    for (uint8_t i = 0; i < offsetof(Record, checksum); ++i)
+    {
+        sum += bytes[i];
+    }
+    return ~sum;
+}
+
+bool PumpCalibration::load(uint8_t pump, PumpProfile &profile)
+{
+    Record record;
+    EEPROM.get(PUMP_CAL_EEPROM_ADDRESS + pump * sizeof(Record), record);
+    if (record.magic != PUMP_CAL_MAGIC || record.checksum != checksum(record))
+    {
+        TELEMETRY(PUMP_UNCALIBRATED, pump + 1);
+        return false;
+    }
+    profile = record.profile;
+    return true;
+}
+
+void PumpCalibration::save(uint8_t pump, const PumpProfile &profile)
+{
+    Record record;
+    record.magic = PUMP_CAL_MAGIC;
+    record.profile = profile;
+    record.checksum = checksum(record);
+    EEPROM.put(PUMP_CAL_EEPROM_ADDRESS + pump * sizeof(Record), record); // Only rewrites bytes that changed
+}
+
+// The long run minus the short one gives the rate, free of priming time;
+// whatever the short run lost beyond that rate is the priming offset.
+bool PumpCalibration::fit(uint16_t shortRunMl, uint16_t longRunMl, PumpProfile &profile)
+{
+    if (shortRunMl == 0 || longRunMl <= shortRunMl)
+    {
+        return false;
+    }
+    uint32_t msPerMlQ8 = ((uint32_t)(PUMP_CAL_LONG_RUN_MILLIS - PUMP_CAL_SHORT_RUN_MILLIS) << 8) / (longRunMl - shortRunMl);
+    if (msPerMlQ8 > 0xFFFF)
+    {
+        return false; // Slower than 255 ms/ml, the measurement is off
+    }
+    uint32_t flowingMillis = ((uint32_t)shortRunMl * msPerMlQ8 + 128) >> 8;
+    profile.msPerMlQ8 = msPerMlQ8;
+    profile.primeMillis = flowingMillis < PUMP_CAL_SHORT_RUN_MILLIS ? PUMP_CAL_SHORT_RUN_MILLIS - flowingMillis : 0;
+    return true;
+}
+
+// The trickle run starts on a primed line, so its volume is all trickle
+bool PumpCalibration::fitTrickle(uint16_t trickleRunMl, PumpProfile &profile)
+{
+    if (trickleRunMl == 0)
+    {
+        profile.trickleMsPerMlQ8 = 0;
+        return true;
+    }
+    uint32_t msPerMlQ8 = ((uint32_t)PUMP_CAL_TRICKLE_RUN_MILLIS << 8) / trickleRunMl;
+    if (msPerMlQ8 > 0xFFFF || msPerMlQ8 <= profile.msPerMlQ8)
+    {
+        return false; // A trickle no slower than full drive is a misreading
+    }
+    profile.trickleMsPerMlQ8 = msPerMlQ8;
+    return true;
+}
@@ -0,0 +1,57 @@
+#ifndef PUMP_CALIBRATION_H
+#define PUMP_CALIBRATION_H
+
+#include <Arduino.h>
+
+#define PUMP_CAL_EEPROM_ADDRESS 0    // One record per pump from here
+#define PUMP_CAL_EEPROM_SIZE 96      // Room for 8 pumps; the inventory journal follows
+#define PUMP_CAL_MAGIC 0xC8         // 0xC7 records, from before the trickle tail, read as uncalibrated
+#define PUMP_CAL_SHORT_RUN_MILLIS 2000 // The two timed runs of a calibration
+#define PUMP_CAL_LONG_RUN_MILLIS 8000
+#define PUMP_CAL_TRICKLE_RUN_MILLIS 4000 // The third, at trickle duty, after priming at full
+#define PUMP_TRICKLE_DUTY 96 // Of 255, slow enough to stop within a fraction of a ml
+#define PUMP_TRICKLE_ML 5    // The last ml of a pour are trickled
+
+// Time to pour v ml: primeMillis + v * msPerMlQ8 / 256. primeMillis covers
+// filling the tube and spinning the pump up before liquid reaches the glass.
+// With a trickle rate, the last trickleMl of the pour (all of a smaller
+// one) run at trickleDuty instead and take trickleMsPerMlQ8 each.
+struct PumpProfile
+{
+    uint16_t primeMillis;
+    uint16_t msPerMlQ8;        // ms per ml in 8.8 fixed point
+    uint16_t trickleMsPerMlQ8; // At trickleDuty; 0 until measured, and no trickle tail
+    uint8_t trickleDuty;
+    uint8_t trickleMl;
+};
+
+#define PUMP_DEFAULT_PROFILE {0, 30 << 8, 0, PUMP_TRICKLE_DUTY, PUMP_TRICKLE_ML} // 30 ms/ml, no priming
+
+/**
+ * Per-pump flow profiles kept in EEPROM. A calibration times two runs of
+ * different length, the volumes poured are measured by hand, and fit()
+ * turns the two points into a priming offset and a flow rate. A third run
+ * trickles for a fixed time once primed, and fitTrickle() takes its rate.
+ */
+class PumpCalibration
+{
+public:
+    static bool load(uint8_t pump, PumpProfile &profile); // Leaves profile alone if none is stored
+    static void save(uint8_t pump, const PumpProfile &profile);
+    static bool fit(uint16_t shortRunMl, uint16_t longRunMl, PumpProfile &profile);
+    static bool fitTrickle(uint16_t trickleRunMl, PumpProfile &profile); // After fit(); 0 ml turns the tail off
+
+private:
+    struct Record
+    {
+        uint8_t magic;
+        PumpProfile profile;
+        uint8_t checksum;
+    };
+
+    static_assert(8 * sizeof(Record) <= PUMP_CAL_EEPROM_SIZE, "Calibration records overlap the journal");
+
+    static uint8_t checksum(const Record &record);
+};
+
+#endif // PUMP_CALIBRATION_H
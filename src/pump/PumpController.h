@@ -2,48 +2,249 @@
 #define PUMP_CONTROLLER_H
 
 #include <Arduino.h>
+#include <util/atomic.h>
+#include "pump/PumpTimer.h"
+#include "sched/Scheduler.h"
+#include "pump/PumpCalibration.h"
+#include "telemetry/Telemetry.h"
 
+#define PUMP_RAMP_START_DUTY 64 // Soft start: duty of the first ms, of 255
+#define PUMP_RAMP_MILLIS 48     // Up to full drive over this long
+
+// Duty rises this much per PumpTimer tick during the ramp
+#define PUMP_RAMP_STEP_DUTY ((255 - PUMP_RAMP_START_DUTY + PUMP_RAMP_MILLIS - 1) / PUMP_RAMP_MILLIS)
+
+enum PumpPhase : uint8_t
+{
+    PUMP_IDLE,
+    PUMP_RAMP,    // Soft start, duty rising every tick
+    PUMP_BULK,    // Full drive
+    PUMP_TRICKLE  // profile.trickleDuty until the stop
+};
+
+// One pump's pours: deadlines armed here are switched by the Timer2 ISR
+// through its PumpBank, which owns the pin (see PumpBank.h).
+//
+// Every timer is spoken for (Timer0 millis(), Timer1 the servo, Timer2 the
+// pumps) and the pump pins have no PWM anyway, so below full drive the pin
+// is pulse-density modulated from the 1 ms PumpTimer tick: the duty is
+// added to an 8-bit accumulator each tick and the pump runs on the ticks
+// that carry. The pump's inertia smooths that into a lower speed.
 class PumpController
 {
 private:
-    float flowRate = 30; // in ms per ml
-    uint16_t pumpPin;
+    uint8_t pumpPin; // Identifies the pump in telemetry
+
+    // Armed by runFor(), serviced by PumpTimer
+    volatile bool startArmed = false;
+    volatile bool stopArmed = false;
+    volatile bool trickleArmed = false;
+    volatile bool pourComplete = false;
+    volatile bool on = false; // Level the bank drives the pin to
+    volatile PumpPhase phase = PUMP_IDLE;
+    volatile uint8_t duty = 0;
+    volatile uint8_t dither = 0; // Pulse-density accumulator
+    volatile uint32_t startAtMicros = 0;
+    volatile uint32_t trickleAtMicros = 0;
+    volatile uint32_t stopAtMicros = 0;
+    volatile uint32_t stepAtMicros = 0; // Next duty step while below full drive
+
+    TaskHandle stopTask = TASK_NONE;
+
+    static void onPourDeadline(void *context) {
+        static_cast<PumpController *>(context)->reportPour();
+    }
+
     public:
-    uint32_t timeToStopMillis = 0;
-    uint32_t timeToStartMillis = 0;
+    volatile int16_t startJitterMicros = 0; // Measured lateness of the last start
+    volatile int16_t stopJitterMicros = 0;  // Measured lateness of the last stop
+    PumpProfile profile = PUMP_DEFAULT_PROFILE; // Loaded from EEPROM by PumpCalibration::load()
+    uint32_t dispensedMl = 0; // Volume of every pour started since boot
+    uint32_t pours = 0;       // and how many there were
 
-    PumpController(uint16_t pumpPin) {
+    PumpController(uint8_t pumpPin) {
         this->pumpPin = pumpPin;
-        pinMode(pumpPin, OUTPUT);
-        digitalWrite(pumpPin, LOW); // Ensure pump is off initially
     }
 
-    void startPump() {
-        digitalWrite(pumpPin, HIGH); // Activate pump
+    bool running() const { return on; }
+
+    // Priming time plus volume at the calibrated rates, rounded to the nearest ms
+    uint32_t runTimeMillis(uint16_t volumeMiliLiters) const {
+        uint16_t tail = trickleMl(volumeMiliLiters);
+        return profile.primeMillis +
+               (((uint32_t)(volumeMiliLiters - tail) * profile.msPerMlQ8 + (uint32_t)tail * profile.trickleMsPerMlQ8 + 128) >> 8);
+    }
+
+    // The part of a pour trickled at the end
+    uint16_t trickleMl(uint16_t volumeMiliLiters) const {
+        return profile.trickleMsPerMlQ8 ? min(volumeMiliLiters, (uint16_t)profile.trickleMl) : 0;
+    }
+
+    uint32_t trickleMillis(uint16_t volumeMiliLiters) const {
+        return ((uint32_t)trickleMl(volumeMiliLiters) * profile.trickleMsPerMlQ8 + 128) >> 8;
+    }
+
+    // What a run of this length pours at the calibrated rates, the inverse
+    // of runTimeMillis(): priming first, the last trickleMillis at trickle
+    // duty. Until the trickle rate is measured it is taken as the full rate
+    // slowed by the duty.
+    uint16_t volumeMl(uint32_t timeToRunMillis, uint32_t trickleMillis = 0) const {
+        trickleMillis = min(trickleMillis, timeToRunMillis);
+        uint32_t fullMillis = timeToRunMillis - trickleMillis;
+        fullMillis = fullMillis > profile.primeMillis ? fullMillis - profile.primeMillis : 0;
+        uint32_t trickleQ8 = profile.trickleMsPerMlQ8 ? profile.trickleMsPerMlQ8 : (uint32_t)profile.msPerMlQ8 * 255 / max(profile.trickleDuty, (uint8_t)1);
+        return (fullMillis << 8) / profile.msPerMlQ8 + (trickleMillis << 8) / trickleQ8;
+    }
+
+    // True while a pour is armed or running; arming another would replace it
+    bool busy() const {
+        return startArmed || stopArmed;
     }
 
-    void stopPump() {
-        digitalWrite(pumpPin, LOW); // Deactivate pump
+    // Milliseconds until the armed pour stops, from the deadlines the timer
+    // actually switches on; 0 once stopped
+    uint32_t millisLeft() const {
+        bool armed;
+        uint32_t stopAt;
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            armed = stopArmed;
+            stopAt = stopAtMicros;
+        }
+        if (!armed) return 0;
+        int32_t left = (int32_t)(stopAt - micros());
+        return left > 0 ? (left + 999) / 1000 : 0;
+    }
+
+    uint32_t dispenseVolume(uint16_t volumeMiliLiters, uint32_t delayBeforeStartMillis = 0) {
+        return dispenseFor(volumeMiliLiters, runTimeMillis(volumeMiliLiters), delayBeforeStartMillis);
+    }
+
+    // A volume in a run time worked out by the caller, e.g. shortened by
+    // priming; the tail is still trickled
+    uint32_t dispenseFor(uint16_t volumeMiliLiters, uint32_t timeToRunMillis, uint32_t delayBeforeStartMillis = 0) {
+        dispensedMl += volumeMiliLiters;
+        ++pours;
+        return runFor(timeToRunMillis, delayBeforeStartMillis, trickleMillis(volumeMiliLiters));
     }
 
-    uint32_t dispenseVolume(float volumeMiliLiters, uint32_t delayBeforeStartMillis = 0) {
-        float timeToRunMillis = 30.0 * volumeMiliLiters; // Calculate time to run based on flow rate
-        timeToStartMillis = millis() + delayBeforeStartMillis;
-        timeToStopMillis = timeToStartMillis + timeToRunMillis;
-        if (delayBeforeStartMillis == 0) startPump();
+    // A run timed rather than measured, e.g. for a calibration: still liquid
+    // out of the reservoir, so counted as a pour of what the profile says
+    uint32_t pourFor(uint32_t timeToRunMillis, uint32_t trickleMillis = 0) {
+        dispensedMl += volumeMl(timeToRunMillis, trickleMillis);
+        ++pours;
+        return runFor(timeToRunMillis, 0, trickleMillis);
+    }
 
+    // Runs the pump for a fixed time, uncounted, e.g. priming ahead of a pour,
+    // the last trickleMillis of it (all of it, if longer) at trickle duty
+    uint32_t runFor(uint32_t timeToRunMillis, uint32_t delayBeforeStartMillis = 0, uint32_t trickleMillis = 0) {
+        uint32_t timeToStopMillis = delayBeforeStartMillis + timeToRunMillis;
+        uint32_t now = micros();
+        trickleMillis = min(trickleMillis, timeToRunMillis);
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            startAtMicros = now + delayBeforeStartMillis * 1000UL;
+            stopAtMicros = startAtMicros + timeToRunMillis * 1000UL;
+            trickleAtMicros = stopAtMicros - trickleMillis * 1000UL;
+            startArmed = true;
+            stopArmed = true;
+            trickleArmed = trickleMillis != 0;
+            pourComplete = false;
+        }
+        PumpTimer::arm(); // Starts immediately if due, otherwise on compare match
+        scheduler.cancel(stopTask);
+        stopTask = scheduler.after(timeToStopMillis + 1, onPourDeadline, this);
         return timeToRunMillis;
     }
 
-    void update() {
-        if (timeToStartMillis != 0 && millis() >= timeToStartMillis) {
-            startPump();
-            timeToStartMillis = 0; // Reset
+    // Called by the bank with interrupts disabled. Moves the pump through
+    // its phases as deadlines are reached and sets the level for the bank
+    // to write out, then returns the microseconds until the next armed
+    // deadline (0xFFFFFFFF if none). Duty steps wait for the next tick.
+    uint32_t service(uint32_t nowMicros) {
+        uint32_t untilNext = 0xFFFFFFFF;
+        if (startArmed) {
+            int32_t late = (int32_t)(nowMicros - startAtMicros);
+            if (late >= -PUMP_TIMER_EARLY_MICROS) {
+                startArmed = false;
+                startJitterMicros = late;
+                enter(PUMP_RAMP, PUMP_RAMP_START_DUTY, nowMicros);
+            } else {
+                untilNext = -late;
+            }
+        }
+        if (trickleArmed && !startArmed) {
+            int32_t late = (int32_t)(nowMicros - trickleAtMicros);
+            if (late >= -PUMP_TIMER_EARLY_MICROS) {
+                trickleArmed = false;
+                enter(PUMP_TRICKLE, profile.trickleDuty, nowMicros);
+            } else if ((uint32_t)-late < untilNext) {
+                untilNext = -late;
+            }
+        }
+        if (stopArmed && !startArmed) {
+            int32_t late = (int32_t)(nowMicros - stopAtMicros);
+            if (late >= -PUMP_TIMER_EARLY_MICROS) {
+                phase = PUMP_IDLE;
+                on = false;
+                stopArmed = false;
+                stopJitterMicros = late;
+                pourComplete = true;
+            } else if ((uint32_t)-late < untilNext) {
+                untilNext = -late;
+            }
+        }
+        if ((phase == PUMP_RAMP || phase == PUMP_TRICKLE) && (int32_t)(nowMicros - stepAtMicros) >= -PUMP_TIMER_EARLY_MICROS) {
+            stepAtMicros += PUMP_TIMER_TICK_MICROS;
+            if (phase == PUMP_RAMP) {
+                duty = duty < 255 - PUMP_RAMP_STEP_DUTY ? duty + PUMP_RAMP_STEP_DUTY : 255;
+                if (duty == 255) phase = PUMP_BULK;
+            }
+            modulate();
+        }
+        return untilNext;
+    }
+
+private:
+    // A trickle tail from the start skips the ramp; so does a full trickle
+    // duty. A pour armed while the pump still ramps or runs at full drive,
+    // e.g. straight after priming, carries on where the flow is: the
+    // calibration timed one ramp per run, not one per arming.
+    void enter(PumpPhase next, uint8_t nextDuty, uint32_t nowMicros) {
+        if (next == PUMP_RAMP && trickleArmed && (int32_t)(nowMicros - trickleAtMicros) >= -PUMP_TIMER_EARLY_MICROS) {
+            next = PUMP_TRICKLE;
+            nextDuty = profile.trickleDuty;
+            trickleArmed = false;
+        } else if (next == PUMP_RAMP && (phase == PUMP_RAMP || phase == PUMP_BULK)) {
+            return;
+        }
+        phase = nextDuty == 255 ? PUMP_BULK : next;
+        duty = nextDuty;
+        dither = -nextDuty; // The first tick of a phase always drives
+        stepAtMicros = nowMicros + PUMP_TIMER_TICK_MICROS;
+        modulate();
+    }
+
+    void modulate() {
+        uint16_t sum = (uint16_t)dither + duty;
+        dither = sum;
+        on = duty == 255 || (sum >> 8);
+    }
+
+public:
+    // Reports the ISR-measured jitter once the pour has finished
+    void reportPour() {
+        if (!pourComplete) {
+            stopTask = scheduler.after(1, onPourDeadline, this); // Stop not serviced yet
+            return;
         }
-        if (timeToStopMillis != 0 && millis() >= timeToStopMillis) {
-            stopPump();
-            timeToStopMillis = 0; // Reset
+        stopTask = TASK_NONE;
+        int16_t startJitter, stopJitter;
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            pourComplete = false;
+            startJitter = startJitterMicros;
+            stopJitter = stopJitterMicros;
         }
+        TELEMETRY(PUMP_JITTER, pumpPin, startJitter, stopJitter);
     }
 };
-#endif // PUMP_CONTROLLER_H
\ No newline at end of file
+#endif // PUMP_CONTROLLER_H
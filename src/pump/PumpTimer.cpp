@@ -0,0 +1,113 @@
+#include <Arduino.h>
+#include <util/atomic.h>
+#include "pump/PumpTimer.h"
+#if defined(NATIVE_HAL)
+#include "Hal.h"
+#endif
+
+PumpService PumpTimer::pumpService = nullptr;
+void *PumpTimer::pumpContext = nullptr;
+uint8_t PumpTimer::holds = 0;
+volatile bool PumpTimer::deadlineArmed = false;
+volatile uint32_t PumpTimer::nextDeadlineMicros = 0;
+
+void PumpTimer::attach(PumpService service, void *context)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        pumpService = service;
+        pumpContext = context;
+    }
+}
+
+void PumpTimer::begin()
+{
+#if defined(__AVR__)
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        TCCR2A = _BV(WGM21);             // CTC, TOP = OCR2A
+        TCCR2B = _BV(CS22);              // clk/64 -> 4us per count
+        OCR2A = (PUMP_TIMER_TICK_MICROS / PUMP_TIMER_COUNT_MICROS) - 1;
+        TCNT2 = 0;
+        TIFR2 = _BV(OCF2A) | _BV(OCF2B);
+        TIMSK2 = _BV(OCIE2A);
+    }
+#elif defined(NATIVE_HAL)
+    // The virtual clock raises the tick; deadlines resolve to the tick
+    hal::setTickHook(service, PUMP_TIMER_TICK_MICROS);
+#endif
+}
+
+void PumpTimer::arm()
+{
+    if (holds != 0)
+        return;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        service();
+    }
+}
+
+void PumpTimer::hold()
+{
+    ++holds;
+}
+
+void PumpTimer::release()
+{
+    if (holds != 0 && --holds == 0)
+        arm();
+}
+
+// Runs with interrupts disabled: switch every pump that is due, then point
+// COMPB at the earliest deadline left inside the current tick.
+void PumpTimer::service()
+{
+    uint32_t now = micros();
+    uint32_t earliest = pumpService ? pumpService(pumpContext, now) : 0xFFFFFFFF;
+    deadlineArmed = earliest != 0xFFFFFFFF;
+    nextDeadlineMicros = now + earliest;
+
+#if defined(__AVR__)
+    if (earliest < PUMP_TIMER_TICK_MICROS)
+    {
+        uint16_t target = TCNT2 + (earliest + PUMP_TIMER_COUNT_MICROS - 1) / PUMP_TIMER_COUNT_MICROS;
+        if (target > TCNT2 && target <= OCR2A)
+        {
+            OCR2B = target;
+            TIFR2 = _BV(OCF2B);
+            TIMSK2 |= _BV(OCIE2B);
+            return;
+        }
+    }
+    // Nothing due before the next COMPA tick
+    TIMSK2 &= ~_BV(OCIE2B);
+#endif
+}
+
+uint32_t PumpTimer::microsUntilNext()
+{
+    bool armed;
+    uint32_t deadline;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        armed = deadlineArmed;
+        deadline = nextDeadlineMicros;
+    }
+    if (!armed)
+        return 0xFFFFFFFF;
+    int32_t until = (int32_t)(deadline - micros());
+    return until > 0 ? until : 0;
+}
+
+#if defined(__AVR__)
+ISR(TIMER2_COMPA_vect)
+{
+    PumpTimer::service();
+}
+
+ISR(TIMER2_COMPB_vect)
+{
+    PumpTimer::service();
+}
+#endif
@@ -0,0 +1,45 @@
+#ifndef PUMP_TIMER_H
+#define PUMP_TIMER_H
+
+#include <Arduino.h>
+
+#define PUMP_TIMER_TICK_MICROS 1000 // Timer2 CTC period (OCR2A = 249 at /64)
+#define PUMP_TIMER_COUNT_MICROS 4   // One Timer2 count at /64
+#define PUMP_TIMER_EARLY_MICROS 4   // Tolerance for compare rounding
+
+// Switches whatever is due at nowMicros, with interrupts disabled, and
+// returns the microseconds until the next deadline (0xFFFFFFFF if none)
+typedef uint32_t (*PumpService)(void *context, uint32_t nowMicros);
+
+/**
+ * Timer2 compare-match scheduler for pump start/stop deadlines.
+ *
+ * COMPA fires every millisecond as a coarse tick. Whenever a deadline falls
+ * inside the current tick, COMPB is programmed to the exact Timer2 count so
+ * the pump pins switch within a few microseconds of their deadlines, no
+ * matter how long loop() is busy drawing. Between hold() and release(),
+ * arm() waits, so pumps armed together go out in one service.
+ *
+ * Timer1 belongs to the Servo library and Timer0 to millis(), so Timer2 is
+ * the only free one. Taking it disables analogWrite() on pins 3 and 11.
+ */
+class PumpTimer
+{
+public:
+    static void attach(PumpService service, void *context);
+    static void begin();
+    static void arm();
+    static void hold();
+    static void release();
+    static void service();
+    static uint32_t microsUntilNext(); // 0xFFFFFFFF when nothing is armed
+
+private:
+    static PumpService pumpService;
+    static void *pumpContext;
+    static uint8_t holds;
+    static volatile bool deadlineArmed;
+    static volatile uint32_t nextDeadlineMicros; // Refreshed on every service()
+};
+
+#endif // PUMP_TIMER_H
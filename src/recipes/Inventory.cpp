@@ -0,0 +1,201 @@
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <util/crc16.h>
+#if defined(__AVR__)
+#include <avr/eeprom.h>
+#endif
+#include "recipes/Inventory.h"
+#include "recipes/Recipes.h"
+#include "sched/Scheduler.h"
+#include "telemetry/Telemetry.h"
+
+Inventory inventory;
+
+void Inventory::begin(PumpController *pumps)
+{
+    this->pumps = pumps;
+    for (uint8_t i = 0; i < PUMP_COUNT; ++i)
+    {
+        seenMl[i] = pumps[i].dispensedMl;
+        seenPours[i] = pumps[i].pours;
+    }
+    load();
+    scheduler.onIdle(onIdle);
+}
+
+uint16_t Inventory::slotCount()
+{
+    return (INVENTORY_EEPROM_END - INVENTORY_EEPROM_ADDRESS) / sizeof(Record);
+}
+
+uint16_t Inventory::address(uint16_t slot)
+{
+    return INVENTORY_EEPROM_ADDRESS + slot * sizeof(Record);
+}
+
+// Padding, where the compiler adds any, is written and checked like the rest
+uint16_t Inventory::crc(const Record &record)
+{
+    const uint8_t *bytes = (const uint8_t *)&record;
+    uint16_t crc = INVENTORY_CRC_SEED;
+    for (uint8_t i = 0; i < offsetof(Record, crc); ++i)
+        crc = _crc_xmodem_update(crc, bytes[i]);
+    return crc;
+}
+
+// Sequence numbers are compared by their difference, so they can wrap
+bool Inventory::load()
+{
+    bool found = false;
+    for (uint16_t s = 0; s < slotCount(); ++s)
+    {
+        Record record;
+        EEPROM.get(address(s), record);
+        if (record.crc != crc(record) || (found && (int16_t)(record.sequence - sequence) <= 0))
+            continue;
+        found = true;
+        slot = s;
+        sequence = record.sequence;
+        memcpy(reservoirs, record.reservoirs, sizeof(reservoirs));
+    }
+    if (found)
+    {
+        TELEMETRY(INVENTORY_LOADED, sequence, slot, slotCount());
+        return true;
+    }
+    for (uint8_t i = 0; i < PUMP_COUNT; ++i)
+        reservoirs[i] = {0, 0, INVENTORY_RESERVOIR_ML, INVENTORY_RESERVOIR_ML};
+    slot = slotCount() - 1; // The first record goes to slot 0
+    sequence = 0;
+    TELEMETRY(INVENTORY_BLANK);
+    return false;
+}
+
+uint16_t Inventory::remainingMl(uint8_t pump) const
+{
+    uint32_t uncollected = pumps ? pumps[pump].dispensedMl - seenMl[pump] : 0;
+    uint16_t left = reservoirs[pump].remainingMl;
+    return uncollected < left ? left - uncollected : 0;
+}
+
+void Inventory::refill(uint8_t pump, uint16_t capacityMl)
+{
+    reservoirs[pump].capacityMl = capacityMl;
+    reservoirs[pump].remainingMl = capacityMl;
+    markDirty();
+    TELEMETRY(RESERVOIR_FILLED, pump + 1, capacityMl);
+}
+
+void Inventory::refillAll()
+{
+    for (uint8_t i = 0; i < PUMP_COUNT; ++i)
+        refill(i, reservoirs[i].capacityMl);
+}
+
+void Inventory::addNeeds(uint8_t recipeIndex, uint16_t *needMl)
+{
+    Recipe recipe;
+    Recipes::read(recipeIndex, recipe);
+    for (uint8_t i = 0; i < recipe.ingredientCount; ++i)
+    {
+        Ingredient ingredient;
+        Recipes::readIngredient(recipe, i, ingredient);
+        if (ingredient.pump < PUMP_COUNT)
+            needMl[ingredient.pump] += ingredient.volumeMl;
+    }
+}
+
+// The drink pouring now has already been taken off, apart from layers not
+// started yet, which is as close as a bottle level gets anyway
+uint8_t Inventory::dryPump(uint8_t recipeIndex, const OrderQueue &waiting) const
+{
+    uint16_t needMl[PUMP_COUNT] = {0};
+    addNeeds(recipeIndex, needMl);
+    for (uint8_t i = 0; i < waiting.depth(); ++i)
+        addNeeds(waiting.at(i), needMl);
+    for (uint8_t i = 0; i < PUMP_COUNT; ++i)
+    {
+        if (needMl[i] > remainingMl(i))
+            return i;
+    }
+    return PUMP_COUNT;
+}
+
+void Inventory::onIdle()
+{
+    inventory.service();
+}
+
+void Inventory::service()
+{
+    collect();
+    if (writing)
+    {
+        writeNext();
+        return;
+    }
+    if (!dirty || !timeReached(millis(), dirtySince + INVENTORY_BATCH_MILLIS))
+        return;
+    for (uint8_t i = 0; i < PUMP_COUNT; ++i)
+    {
+        if (pumps[i].busy())
+            return; // Saved once the pumps are quiet
+    }
+    pending.sequence = sequence + 1;
+    memcpy(pending.reservoirs, reservoirs, sizeof(reservoirs));
+    pending.crc = crc(pending);
+    written = 0;
+    writing = true;
+    dirty = false;
+}
+
+// Takes the pours started since the last pass off the reservoirs
+void Inventory::collect()
+{
+    for (uint8_t i = 0; i < PUMP_COUNT; ++i)
+    {
+        uint32_t pours = pumps[i].pours - seenPours[i];
+        if (pours == 0)
+            continue;
+        uint32_t ml = pumps[i].dispensedMl - seenMl[i];
+        seenPours[i] += pours;
+        seenMl[i] += ml;
+
+        Reservoir &reservoir = reservoirs[i];
+        bool wasLow = reservoir.remainingMl < INVENTORY_LOW_ML;
+        reservoir.pouredMl += ml;
+        reservoir.pours += pours;
+        reservoir.remainingMl = ml < reservoir.remainingMl ? reservoir.remainingMl - ml : 0;
+        if (!wasLow && reservoir.remainingMl < INVENTORY_LOW_ML)
+            TELEMETRY(RESERVOIR_LOW, i + 1, reservoir.remainingMl);
+        markDirty();
+    }
+}
+
+void Inventory::markDirty()
+{
+    if (!dirty)
+    {
+        dirty = true;
+        dirtySince = millis();
+    }
+}
+
+// EEPROM.update() leaves bytes that already match alone, which spares
+// both the wear and the wait
+void Inventory::writeNext()
+{
+#if defined(__AVR__)
+    if (!eeprom_is_ready())
+        return; // The last byte is still being programmed
+#endif
+    uint16_t next = (slot + 1) % slotCount();
+    EEPROM.update(address(next) + written, ((const uint8_t *)&pending)[written]);
+    if (++written < sizeof(Record))
+        return;
+    writing = false;
+    slot = next;
+    sequence = pending.sequence;
+    ++records;
+    TELEMETRY(INVENTORY_SAVED, sequence, slot);
+}
@@ -0,0 +1,84 @@
+#ifndef INVENTORY_H
+#define INVENTORY_H
+
+#include <Arduino.h>
+#include "pump/PumpBank.h"
+#include "pump/PumpCalibration.h"
+#include "recipes/OrderQueue.h"
+
+#define INVENTORY_EEPROM_ADDRESS (PUMP_CAL_EEPROM_ADDRESS + PUMP_CAL_EEPROM_SIZE) // Journal from here
+#define INVENTORY_EEPROM_END 1022     // up to the LED strip length in the ATmega328P's last two bytes
+#define INVENTORY_BATCH_MILLIS 10000  // Pours this close after the first unsaved one share its record
+#define INVENTORY_RESERVOIR_ML 1000   // Capacity until a bottle size is set over the link
+#define INVENTORY_LOW_ML 100          // Warn once a reservoir drops below this
+#define INVENTORY_CRC_SEED (0x1D00 | PUMP_COUNT) // A journal written for another pump count never matches
+
+/**
+ * What each reservoir has poured and has left, kept across power cycles in
+ * an append-only EEPROM journal. Every record is a full snapshot with a
+ * sequence number and a CRC, written to the slot after the last one, so
+ * the writes rotate over the whole region; begin() takes the newest valid
+ * record, and a write cut short by a power loss only loses that record.
+ *
+ * Pours are picked up from the pumps' counters and written out from the
+ * scheduler's idle time, one byte per pass while the EEPROM is ready, once
+ * INVENTORY_BATCH_MILLIS have passed and no pump is running: a rush of
+ * drinks costs one record, and nothing waits for the 3.4 ms byte writes.
+ */
+class Inventory
+{
+public:
+    struct Reservoir
+    {
+        uint32_t pouredMl; // Since the journal was started
+        uint32_t pours;
+        uint16_t remainingMl;
+        uint16_t capacityMl;
+    };
+
+    void begin(PumpController *pumps); // Loads the journal and starts saving from idle time
+    bool load();                       // false, and every reservoir full, without a valid record
+
+    const Reservoir &reservoir(uint8_t pump) const { return reservoirs[pump]; }
+    uint16_t remainingMl(uint8_t pump) const; // Pours not yet picked up included
+    void refill(uint8_t pump, uint16_t capacityMl); // A new bottle of this size
+    void refillAll();                               // Each back to its capacity
+    uint8_t dryPump(uint8_t recipeIndex, const OrderQueue &waiting) const; // First pump that can't pour it after the waiting orders, or PUMP_COUNT
+    bool saved() const { return !dirty && !writing; }
+
+    static uint16_t slotCount();
+    static uint16_t address(uint16_t slot); // Of the record in that slot
+    uint16_t slot = 0;     // Of the newest record
+    uint16_t sequence = 0;
+    uint32_t records = 0;  // Written since boot
+
+private:
+    struct Record
+    {
+        uint16_t sequence;
+        Reservoir reservoirs[PUMP_COUNT];
+        uint16_t crc;
+    };
+
+    PumpController *pumps = nullptr;
+    Reservoir reservoirs[PUMP_COUNT];
+    uint32_t seenMl[PUMP_COUNT];    // Pump counters already taken into reservoirs
+    uint32_t seenPours[PUMP_COUNT];
+    bool dirty = false;
+    uint32_t dirtySince = 0;
+    Record pending;                 // Being written, a byte per idle pass
+    uint8_t written = 0;
+    bool writing = false;
+
+    static void onIdle();
+    void service();
+    void collect();
+    void markDirty();
+    void writeNext();
+    static uint16_t crc(const Record &record);
+    static void addNeeds(uint8_t recipeIndex, uint16_t *needMl);
+};
+
+extern Inventory inventory;
+
+#endif // INVENTORY_H
@@ -0,0 +1,55 @@
+#include "recipes/OrderQueue.h"
+
+bool OrderQueue::push(uint8_t recipeIndex)
+{
+    if (size == ORDER_QUEUE_CAPACITY)
+        return false;
+    uint32_t now = millis();
+    if (size == 0 && pouring == 0)
+        busySince = now;
+    uint8_t tail = (head + size) % ORDER_QUEUE_CAPACITY;
+    recipes[tail] = recipeIndex;
+    queuedAt[tail] = now;
+    ++size;
+    ++stats.ordered;
+    if (size > stats.maxDepth)
+        stats.maxDepth = size;
+    return true;
+}
+
+uint8_t OrderQueue::pop(uint32_t &waitMillis)
+{
+    uint8_t recipeIndex = recipes[head];
+    waitMillis = millis() - queuedAt[head];
+    head = (head + 1) % ORDER_QUEUE_CAPACITY;
+    --size;
+    ++pouring;
+    stats.totalWaitMillis += waitMillis;
+    if (waitMillis > stats.maxWaitMillis)
+        stats.maxWaitMillis = waitMillis;
+    return recipeIndex;
+}
+
+// Pours that didn't come from the queue, like a pump test, aren't counted.
+// The last drink of a run closes the busy span.
+bool OrderQueue::served()
+{
+    if (pouring == 0)
+        return false;
+    --pouring;
+    ++stats.served;
+    if (size == 0 && pouring == 0)
+        stats.busyMillis += millis() - busySince;
+    return true;
+}
+
+uint16_t OrderQueue::drinksPerHour() const
+{
+    uint32_t busy = stats.busyMillis;
+    if (size != 0 || pouring != 0)
+        busy += millis() - busySince;
+    uint32_t tenths = (busy + 50) / 100; // 0.1 s units keep the product in 32 bits
+    if (tenths == 0)
+        return 0;
+    return (uint32_t)stats.served * 36000UL / tenths;
+}
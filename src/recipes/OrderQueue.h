@@ -0,0 +1,47 @@
+#ifndef ORDER_QUEUE_H
+#define ORDER_QUEUE_H
+
+#include <Arduino.h>
+
+#define ORDER_QUEUE_CAPACITY 4 // Drinks waiting behind the one pouring
+
+/**
+ * Drinks ordered while another one pours, oldest first. Besides the ring of
+ * recipe indices it keeps the service counters: how deep the queue got, how
+ * long orders waited to start, and drinks per hour over the time the
+ * dispenser had work, so idle time between rushes doesn't dilute it.
+ */
+class OrderQueue
+{
+public:
+    struct Stats
+    {
+        uint16_t ordered;         // Orders taken
+        uint16_t served;          // Drinks finished
+        uint8_t maxDepth;         // Most orders waiting at once
+        uint32_t totalWaitMillis; // Order to pour start, summed over started orders
+        uint32_t maxWaitMillis;
+        uint32_t busyMillis;      // Closed busy spans: first order to the last drink of a run
+    };
+
+    bool push(uint8_t recipeIndex); // false when full
+    uint8_t pop(uint32_t &waitMillis);
+    uint8_t next() const { return recipes[head]; } // Oldest order; the queue must not be empty
+    uint8_t at(uint8_t i) const { return recipes[(head + i) % ORDER_QUEUE_CAPACITY]; } // i < depth()
+    uint8_t depth() const { return size; }
+    bool empty() const { return size == 0; }
+    bool served(); // A drink has finished; false if it wasn't an order
+    uint16_t drinksPerHour() const;
+
+    Stats stats = {0, 0, 0, 0, 0, 0};
+
+private:
+    uint8_t recipes[ORDER_QUEUE_CAPACITY];
+    uint32_t queuedAt[ORDER_QUEUE_CAPACITY];
+    uint8_t head = 0;
+    uint8_t size = 0;
+    uint8_t pouring = 0;   // Popped and not yet served
+    uint32_t busySince = 0;
+};
+
+#endif // ORDER_QUEUE_H
@@ -0,0 +1,224 @@
+#include "recipes/PourPlanner.h"
+#include "telemetry/Telemetry.h"
+#include "sched/PerfStats.h"
+
+PourPlanner::PourPlanner(PumpController *pumps)
+{
+    this->pumps = pumps;
+}
+
+// Lanes are the number of pumps that may run at once
+uint8_t PourPlanner::lanes() const
+{
+    uint8_t n = maxConcurrentPumps;
+    uint8_t byCurrent = currentBudgetMa / POUR_PUMP_CURRENT_MA;
+    if (byCurrent < n)
+        n = byCurrent;
+    if (n > PUMP_COUNT)
+        n = PUMP_COUNT;
+    return n ? n : 1;
+}
+
+uint32_t PourPlanner::plan(uint8_t recipeIndex)
+{
+    Recipe recipe;
+    Recipes::read(recipeIndex, recipe);
+
+    uint8_t layers[POUR_MAX_STEPS];
+    uint16_t gaps[POUR_MAX_STEPS];
+    uint8_t credited = 0; // Bit per pump whose priming has been taken off a step
+    count = 0;
+    for (uint8_t i = 0; i < recipe.ingredientCount && count < POUR_MAX_STEPS; ++i)
+    {
+        Ingredient ingredient;
+        Recipes::readIngredient(recipe, i, ingredient);
+        if (ingredient.pump >= PUMP_COUNT)
+        {
+            continue;
+        }
+        PourStep &step = steps[count];
+        step.pump = ingredient.pump;
+        step.volumeMl = ingredient.volumeMl;
+        step.runMillis = pumps[ingredient.pump].runTimeMillis(ingredient.volumeMl);
+        if (!(credited & (1 << ingredient.pump)))
+        {
+            step.runMillis -= primedMillis[ingredient.pump]; // Never more than the step's own priming
+            credited |= 1 << ingredient.pump;
+        }
+        layers[count] = keepLayers ? ingredient.layer : 0;
+        gaps[count] = ingredient.gapMs;
+        ++count;
+    }
+
+    uint8_t laneCount = lanes();
+    uint32_t laneFree[PUMP_COUNT] = {0};
+    uint32_t pumpFree[PUMP_COUNT] = {0};
+    uint8_t placed = 0; // Bit per step
+    uint8_t allPlaced = (1 << count) - 1;
+    uint32_t layerStart = 0;
+    total = 0;
+
+    while (placed != allPlaced)
+    {
+        // Lowest layer still to place
+        uint8_t layer = 0xFF;
+        for (uint8_t i = 0; i < count; ++i)
+        {
+            if (!(placed & (1 << i)) && layers[i] < layer)
+                layer = layers[i];
+        }
+
+        // Longest remaining ingredient of this layer first, onto the lane that frees up first
+        while (true)
+        {
+            int8_t next = -1;
+            for (uint8_t i = 0; i < count; ++i)
+            {
+                if (!(placed & (1 << i)) && layers[i] == layer && (next < 0 || steps[i].runMillis > steps[next].runMillis))
+                    next = i;
+            }
+            if (next < 0)
+                break;
+
+            uint8_t lane = 0;
+            for (uint8_t l = 1; l < laneCount; ++l)
+            {
+                if (laneFree[l] < laneFree[lane])
+                    lane = l;
+            }
+            PourStep &step = steps[next];
+            uint32_t start = max(layerStart + gaps[next], max(laneFree[lane], pumpFree[step.pump]));
+            step.startMillis = start;
+            laneFree[lane] = pumpFree[step.pump] = start + step.runMillis;
+            total = max(total, start + step.runMillis);
+            placed |= 1 << next;
+        }
+        layerStart = total;
+    }
+
+    // Order by start so start() can hand out each pump's steps in turn
+    for (uint8_t i = 1; i < count; ++i)
+    {
+        PourStep step = steps[i];
+        uint8_t j = i;
+        for (; j > 0 && steps[j - 1].startMillis > step.startMillis; --j)
+            steps[j] = steps[j - 1];
+        steps[j] = step;
+    }
+    return total;
+}
+
+uint32_t PourPlanner::start()
+{
+    scheduler.cancel(armTask);
+    startedAt = millis();
+    armedMask = 0;
+    memset(primedMillis, 0, sizeof(primedMillis));
+    armDue();
+    return total;
+}
+
+uint32_t PourPlanner::pour(uint8_t recipeIndex)
+{
+    plan(recipeIndex);
+    return start();
+}
+
+// Runs each idle pump the recipe uses for its priming time, less the
+// margin and at most the window, so the liquid waits just short of the
+// outlet while there is no cup under it
+void PourPlanner::prime(uint8_t recipeIndex, uint32_t windowMillis)
+{
+    Recipe recipe;
+    Recipes::read(recipeIndex, recipe);
+    memset(primedMillis, 0, sizeof(primedMillis));
+    PumpTimer::hold(); // Pumps primed together switch on in one port write
+    for (uint8_t i = 0; i < recipe.ingredientCount; ++i)
+    {
+        Ingredient ingredient;
+        Recipes::readIngredient(recipe, i, ingredient);
+        uint8_t pump = ingredient.pump;
+        if (pump >= PUMP_COUNT || primedMillis[pump] != 0 || pumps[pump].busy())
+            continue;
+        uint16_t primeMillis = pumps[pump].profile.primeMillis;
+        if (primeMillis <= POUR_PRIME_MARGIN_MILLIS)
+            continue;
+        uint32_t run = min((uint32_t)(primeMillis - POUR_PRIME_MARGIN_MILLIS), windowMillis);
+        if (run == 0)
+            continue;
+        pumps[pump].runFor(run);
+        primedMillis[pump] = run;
+        TELEMETRY(PUMP_PRIMED, pump + 1, run);
+    }
+    PumpTimer::release();
+}
+
+uint32_t PourPlanner::millisRemaining() const
+{
+    uint32_t remaining = 0;
+    for (uint8_t i = 0; i < count; ++i)
+        remaining = max(remaining, stepMillisLeft(i));
+    return remaining;
+}
+
+// Armed steps go by the pump's own stop deadline, so late starts show up;
+// steps not armed yet by the plan
+uint32_t PourPlanner::stepMillisLeft(uint8_t i) const
+{
+    const PourStep &step = steps[i];
+    if (!(armedMask & (1 << i)))
+    {
+        uint32_t elapsed = millis() - startedAt;
+        return (step.startMillis > elapsed ? step.startMillis - elapsed : 0) + step.runMillis;
+    }
+    for (uint8_t j = i + 1; j < count; ++j)
+    {
+        if (steps[j].pump == step.pump && (armedMask & (1 << j)))
+            return 0; // The pump has moved on to a later step
+    }
+    return pumps[step.pump].millisLeft();
+}
+
+// A pump holds one pour at a time, so a step is armed only once the pump's
+// previous step has stopped; the rest wait for the next wake-up. Steps
+// due now go out together, in one service of the pump timer.
+void PourPlanner::armDue()
+{
+    uint32_t elapsed = millis() - startedAt;
+    uint32_t wake = 0xFFFFFFFF;
+
+    PumpTimer::hold();
+    for (uint8_t i = 0; i < count; ++i)
+    {
+        if (armedMask & (1 << i))
+            continue;
+
+        PourStep &step = steps[i];
+        int8_t previous = -1;
+        for (uint8_t j = 0; j < i; ++j)
+        {
+            if (steps[j].pump == step.pump)
+                previous = j;
+        }
+        if (previous >= 0 && (!(armedMask & (1 << previous)) || pumps[step.pump].busy()))
+        {
+            uint32_t previousEnd = steps[previous].startMillis + steps[previous].runMillis;
+            uint32_t wait = previousEnd >= elapsed ? previousEnd - elapsed + 1 : 1;
+            wake = min(wake, wait);
+            continue;
+        }
+
+        uint32_t delayMillis = step.startMillis > elapsed ? step.startMillis - elapsed : 0;
+        pumps[step.pump].dispenseFor(step.volumeMl, step.runMillis, delayMillis); // Less any priming done
+        armedMask |= 1 << i;
+    }
+    PumpTimer::release();
+
+    armTask = wake != 0xFFFFFFFF ? scheduler.after(wake, onArm, this) : TASK_NONE;
+}
+
+void PourPlanner::onArm(void *context)
+{
+    PERF_SCOPE(PERF_POUR);
+    static_cast<PourPlanner *>(context)->armDue();
+}
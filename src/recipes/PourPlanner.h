@@ -0,0 +1,69 @@
+#ifndef POUR_PLANNER_H
+#define POUR_PLANNER_H
+
+#include <Arduino.h>
+#include "pump/PumpBank.h"
+#include "recipes/Recipes.h"
+#include "sched/Scheduler.h"
+
+#define POUR_MAX_STEPS 8
+#define POUR_MAX_CONCURRENT_PUMPS 2 // Pumps allowed to run at once
+#define POUR_PUMP_CURRENT_MA 1000   // Draw of one running pump
+#define POUR_CURRENT_BUDGET_MA 2000 // What the pump supply can deliver
+#define POUR_PRIME_MARGIN_MILLIS 100 // Priming stops this far short of liquid reaching the glass
+
+struct PourStep
+{
+    uint8_t pump;
+    uint16_t volumeMl;
+    uint32_t startMillis; // From the start of the pour
+    uint32_t runMillis;
+};
+
+/**
+ * Turns a recipe into a pump schedule. Ingredients of one layer are list
+ * scheduled longest first onto as many lanes as the pump and current limits
+ * allow, which keeps the pour within 4/3 of the shortest possible. start()
+ * then hands each pump its steps, one at a time, from a single task.
+ *
+ * prime() lets a queued drink fill its lines while the previous cup is
+ * swapped; the next plan takes the priming already done off the first step
+ * of each primed pump.
+ */
+class PourPlanner
+{
+public:
+    uint8_t maxConcurrentPumps = POUR_MAX_CONCURRENT_PUMPS;
+    uint16_t currentBudgetMa = POUR_CURRENT_BUDGET_MA;
+    bool keepLayers = true; // false lets every ingredient overlap
+
+    PourPlanner(PumpController *pumps);
+
+    uint32_t plan(uint8_t recipeIndex); // Returns the predicted pour time
+    uint32_t start();                   // Runs the last plan, returns its pour time
+    uint32_t pour(uint8_t recipeIndex);
+    void prime(uint8_t recipeIndex, uint32_t windowMillis); // Fill its lines ahead of the pour
+
+    uint32_t totalMillis() const { return total; }
+    uint32_t millisRemaining() const;          // Longest stepMillisLeft()
+    uint32_t stepMillisLeft(uint8_t i) const;  // Until step i stops, waiting included
+    uint8_t stepCount() const { return count; }
+    const PourStep &step(uint8_t i) const { return steps[i]; }
+
+private:
+    PumpController *pumps; // PUMP_COUNT of them
+    PourStep steps[POUR_MAX_STEPS]; // Ordered by start time once planned
+    uint8_t count = 0;
+    uint32_t total = 0;
+    uint16_t primedMillis[PUMP_COUNT] = {0}; // Credit for the next plan, cleared by start()
+
+    uint32_t startedAt = 0;
+    uint8_t armedMask = 0;
+    TaskHandle armTask = TASK_NONE;
+
+    uint8_t lanes() const;
+    void armDue();
+    static void onArm(void *context);
+};
+
+#endif // POUR_PLANNER_H
@@ -0,0 +1,37 @@
+#include <Arduino.h>
+#include "Adafruit_ILI9341.h"
+#include "recipes/Recipes.h"
+
+// Pump 0 is on A1 (cranberry), pump 1 on A2 (vodka)
+static const Ingredient ingredients[] PROGMEM = {
+    // Vod (Dbl)+Cran
+    {1, 50, 0, 0},
+    {0, 150, 0, 0},
+    // Vod (Dbl)
+    {1, 50, 0, 0},
+};
+
+static const Recipe recipes[] PROGMEM = {
+    {"Vod (Dbl)+Cran", ILI9341_WHITE, ILI9341_RED, 0, 2},
+    {"Vod (Dbl)", ILI9341_BLUE, ILI9341_WHITE, 2, 1},
+};
+
+uint8_t Recipes::count()
+{
+    return sizeof(recipes) / sizeof(recipes[0]);
+}
+
+void Recipes::read(uint8_t index, Recipe &recipe)
+{
+    memcpy_P(&recipe, &recipes[index], sizeof(Recipe));
+}
+
+void Recipes::readIngredient(const Recipe &recipe, uint8_t n, Ingredient &ingredient)
+{
+    memcpy_P(&ingredient, &ingredients[recipe.firstIngredient + n], sizeof(Ingredient));
+}
+
+const char *Recipes::label(uint8_t index)
+{
+    return recipes[index].label;
+}
@@ -0,0 +1,39 @@
+#ifndef RECIPES_H
+#define RECIPES_H
+
+#include <Arduino.h>
+
+#define RECIPE_LABEL_LENGTH 16
+
+// One pour of one pump. PourPlanner runs ingredients of the same layer
+// concurrently where it can; a layer starts once every lower layer is done.
+struct Ingredient
+{
+    uint8_t pump;      // Index into the pump list (0 = pump1)
+    uint16_t volumeMl;
+    uint16_t gapMs;    // Earliest start, counted from the start of its layer
+    uint8_t layer;     // 0 pours first
+};
+
+struct Recipe
+{
+    char label[RECIPE_LABEL_LENGTH];
+    uint16_t color, bg;
+    uint8_t firstIngredient; // Index into the ingredient table
+    uint8_t ingredientCount;
+};
+
+/**
+ * Drink definitions kept in flash. The regular menu is generated from this
+ * table, so adding a drink is one Recipe row plus its Ingredient rows.
+ */
+class Recipes
+{
+public:
+    static uint8_t count();
+    static void read(uint8_t index, Recipe &recipe);
+    static void readIngredient(const Recipe &recipe, uint8_t n, Ingredient &ingredient);
+    static const char *label(uint8_t index); // PROGMEM pointer
+};
+
+#endif // RECIPES_H
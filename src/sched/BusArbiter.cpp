@@ -0,0 +1,105 @@
+#include <Arduino.h>
+#include <util/atomic.h>
+#include "sched/BusArbiter.h"
+#include "pump/PumpTimer.h"
+#include "telemetry/Telemetry.h"
+
+BusArbiter arbiter;
+
+void BusArbiter::begin(Adafruit_SPITFT *tft)
+{
+    this->tft = tft;
+    resetStats();
+    if (TELEMETRY_ENABLED(BUS_LOAD))
+    {
+        scheduler.cancel(reportTask);
+        reportTask = scheduler.every(ARBITER_REPORT_MILLIS, onReport, this, ARBITER_REPORT_MILLIS);
+    }
+}
+
+bool BusArbiter::acquire(uint8_t resource, uint16_t blackoutMicros)
+{
+    if (owner == resource)
+    {
+        ++depth;
+        return true;
+    }
+    if (owner != ARBITER_NONE || (blackoutMicros != 0 && !blackoutClear(blackoutMicros)))
+    {
+        ++stats[resource].deferred;
+        return false;
+    }
+    owner = resource;
+    depth = 1;
+    slotStart = micros();
+    ++stats[resource].slots;
+    if (resource == ARBITER_DISPLAY && tft != nullptr)
+    {
+        tft->startWrite();
+    }
+    return true;
+}
+
+void BusArbiter::release(uint8_t resource)
+{
+    if (owner != resource || --depth != 0)
+        return;
+    if (resource == ARBITER_DISPLAY && tft != nullptr)
+    {
+        tft->endWrite();
+    }
+    uint32_t held = micros() - slotStart;
+    Stats &s = stats[resource];
+    s.busyMicros += held;
+    if (held > s.maxMicros)
+        s.maxMicros = held;
+    owner = ARBITER_NONE;
+}
+
+uint16_t BusArbiter::busyPermille(uint8_t resource) const
+{
+    uint32_t elapsedMillis = (micros() - statsSince) / 1000;
+    if (elapsedMillis == 0)
+        return 0;
+    return stats[resource].busyMicros / elapsedMillis;
+}
+
+void BusArbiter::resetStats()
+{
+    memset(stats, 0, sizeof(stats));
+    statsSince = micros();
+}
+
+// True if interrupts can go off for blackoutMicros without delaying a pump
+// edge or stretching a servo pulse
+bool BusArbiter::blackoutClear(uint16_t blackoutMicros)
+{
+    if (PumpTimer::microsUntilNext() < (uint32_t)blackoutMicros + ARBITER_GUARD_MICROS)
+        return false;
+#if defined(__AVR__)
+    // The Servo library resets Timer1 (0.5 us per count) as each 20 ms frame
+    // begins and raises the pulse straight away. Starting a frame late only
+    // shifts it; ending a pulse late would move the servo.
+    if (TIMSK1 & _BV(OCIE1A))
+    {
+        uint16_t count;
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+        {
+            count = TCNT1;
+        }
+        if (count < 2 * (ARBITER_SERVO_PULSE_MICROS + ARBITER_GUARD_MICROS))
+            return false;
+    }
+#endif
+    return true;
+}
+
+void BusArbiter::onReport(void *context)
+{
+    BusArbiter *self = static_cast<BusArbiter *>(context);
+    for (uint8_t r = 0; r < ARBITER_RESOURCE_COUNT; ++r)
+    {
+        TELEMETRY(BUS_LOAD, r, self->busyPermille(r), self->stats[r].deferred);
+    }
+    self->resetStats();
+}
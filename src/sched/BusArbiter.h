@@ -0,0 +1,65 @@
+#ifndef BUS_ARBITER_H
+#define BUS_ARBITER_H
+
+#include <Arduino.h>
+#include "Adafruit_GFX.h"
+#include "sched/Scheduler.h"
+
+#define ARBITER_GUARD_MICROS 100        // Margin kept clear around pump and servo edges
+#define ARBITER_SERVO_PULSE_MICROS 2400 // Longest Servo library pulse (MAX_PULSE_WIDTH)
+#define ARBITER_RETRY_MILLIS 1          // How soon a deferred slot should be asked for again
+#define ARBITER_REPORT_MILLIS 10000     // BUS_LOAD telemetry period, debug builds only
+
+enum ArbiterResource : uint8_t
+{
+    ARBITER_DISPLAY, // Bulk TFT writes on the shared SPI bus
+    ARBITER_TOUCH,   // XPT2046 conversions on the same bus
+    ARBITER_LED,     // FastLED.show(), interrupts off throughout
+    ARBITER_RESOURCE_COUNT,
+    ARBITER_NONE = 0xFF
+};
+
+/**
+ * Hands out time slots on the shared SPI bus and for interrupt blackouts.
+ *
+ * One resource owns a slot at a time. Acquiring the slot it already owns
+ * nests, so a display slot opened around several renders pushes them all in
+ * a single SPI transaction; the arbiter opens and closes that transaction.
+ * A slot that will keep interrupts off is refused while a pump deadline or
+ * a servo pulse falls inside it, and the caller tries again a little later.
+ * Every slot is timed, giving per-resource occupancy of the loop.
+ */
+class BusArbiter
+{
+public:
+    struct Stats
+    {
+        uint32_t slots;      // Slots granted
+        uint32_t deferred;   // Requests refused, bus taken or deadline close
+        uint32_t busyMicros; // Time spent holding the slot
+        uint32_t maxMicros;  // Longest single slot
+    };
+
+    void begin(Adafruit_SPITFT *tft);
+    bool acquire(uint8_t resource, uint16_t blackoutMicros = 0);
+    void release(uint8_t resource);
+    uint16_t busyPermille(uint8_t resource) const; // Share of the time since resetStats()
+    void resetStats();
+
+    Stats stats[ARBITER_RESOURCE_COUNT];
+
+private:
+    Adafruit_SPITFT *tft = nullptr;
+    uint8_t owner = ARBITER_NONE;
+    uint8_t depth = 0;
+    uint32_t slotStart = 0;
+    uint32_t statsSince = 0;
+    TaskHandle reportTask = TASK_NONE;
+
+    static bool blackoutClear(uint16_t blackoutMicros);
+    static void onReport(void *context);
+};
+
+extern BusArbiter arbiter;
+
+#endif // BUS_ARBITER_H
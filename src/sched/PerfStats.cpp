@@ -0,0 +1,51 @@
+#include <Arduino.h>
+#include "sched/PerfStats.h"
+
+#if PERF_STATS
+
+PerfStats perf;
+
+uint8_t PerfStats::bucketOf(uint32_t micros)
+{
+    if (micros < PERF_FIRST_BUCKET_MICROS)
+        return 0; // Most samples, and nearly every lateness
+    uint8_t bucket = 0;
+    micros /= PERF_FIRST_BUCKET_MICROS;
+    while (micros != 0 && bucket < PERF_BUCKETS - 1)
+    {
+        micros >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+void PerfStats::record(uint8_t probe, uint32_t micros)
+{
+    Probe &p = probes[probe];
+    uint16_t &count = p.buckets[bucketOf(micros)];
+    if (count == 0xFFFF)
+    {
+        for (uint8_t i = 0; i < PERF_BUCKETS; ++i)
+            p.buckets[i] >>= 1;
+    }
+    ++count;
+    if (micros > p.maxMicros)
+        p.maxMicros = micros;
+    ++records;
+}
+
+void PerfStats::late(uint32_t lateMillis)
+{
+    record(PERF_LATE, lateMillis * 1000);
+    if (lateMillis >= PERF_MISSED_MILLIS)
+        ++missed;
+}
+
+void PerfStats::reset()
+{
+    memset(probes, 0, sizeof(probes));
+    missed = 0;
+    records = 0;
+}
+
+#endif
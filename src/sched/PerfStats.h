@@ -0,0 +1,77 @@
+#ifndef PERF_STATS_H
+#define PERF_STATS_H
+
+#include <Arduino.h>
+
+// 1: time the loop and each task into histograms, shown on the test menu's
+// Perf page and over the serial link. 0: every probe compiles to nothing.
+#ifndef PERF_STATS
+#define PERF_STATS 1
+#endif
+
+#define PERF_BUCKETS 12
+#define PERF_FIRST_BUCKET_MICROS 16 // Bucket 0 is under this, bucket n under 16 << n, the last unbounded
+#define PERF_MISSED_MILLIS 4        // A task run this late has missed its deadline
+
+enum PerfProbe : uint8_t
+{
+    PERF_LOOP,   // Busy part of a scheduler pass, when it ran anything
+    PERF_SCREEN, // UI update, progress and Perf page ticks
+    PERF_EYE,
+    PERF_LEDS,
+    PERF_TOUCH,
+    PERF_POUR,   // Arming the planner's next steps
+    PERF_SERVO,
+    PERF_LINK,   // Answering a serial request
+    PERF_LATE,   // How late each task ran, in place of how long
+    PERF_PROBE_COUNT
+};
+
+#if PERF_STATS
+
+/**
+ * Latency histograms with log2 buckets, one per probe, plus the longest
+ * sample. A bucket about to overflow halves every bucket of its probe, so
+ * the shape stays right and leans towards recent samples. Recording is a
+ * shift loop and an increment; the two micros() reads around it cost more.
+ */
+class PerfStats
+{
+public:
+    struct Probe
+    {
+        uint16_t buckets[PERF_BUCKETS];
+        uint32_t maxMicros;
+    };
+
+    void record(uint8_t probe, uint32_t micros);
+    void late(uint32_t lateMillis);
+    void reset();
+    static uint8_t bucketOf(uint32_t micros);
+
+    Probe probes[PERF_PROBE_COUNT];
+    uint16_t missed = 0; // Tasks run PERF_MISSED_MILLIS or more after their deadline
+    uint32_t records = 0;
+};
+
+extern PerfStats perf;
+
+// Times the rest of the enclosing block
+struct PerfScope
+{
+    uint8_t probe;
+    uint32_t start;
+
+    explicit PerfScope(uint8_t probe) : probe(probe), start(micros()) {}
+    ~PerfScope() { perf.record(probe, micros() - start); }
+};
+
+#define PERF_SCOPE(probe) PerfScope perfScope(probe)
+
+#else
+
+#define PERF_SCOPE(probe) ((void)0)
+
+#endif
+
+#endif // PERF_STATS_H
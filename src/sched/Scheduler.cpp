@@ -0,0 +1,230 @@
+#include <Arduino.h>
+#if defined(__AVR__)
+#include <avr/sleep.h>
+#endif
+#include "sched/Scheduler.h"
+#include "telemetry/Telemetry.h"
+#include "sched/PerfStats.h"
+
+Scheduler scheduler;
+
+Scheduler::Scheduler()
+{
+    heapSize = 0;
+    idleHookCount = 0;
+    for (uint8_t i = 0; i < SCHEDULER_MAX_TASKS; ++i)
+    {
+        tasks[i].callback = nullptr;
+        tasks[i].generation = 1;
+    }
+}
+
+TaskHandle Scheduler::every(uint32_t periodMillis, TaskCallback callback, void *context, uint32_t firstDelayMillis)
+{
+    return add(firstDelayMillis, periodMillis, callback, context);
+}
+
+TaskHandle Scheduler::after(uint32_t delayMillis, TaskCallback callback, void *context)
+{
+    return add(delayMillis, 0, callback, context);
+}
+
+TaskHandle Scheduler::add(uint32_t delayMillis, uint32_t periodMillis, TaskCallback callback, void *context)
+{
+    for (uint8_t slot = 0; slot < SCHEDULER_MAX_TASKS; ++slot)
+    {
+        Task &task = tasks[slot];
+        if (task.callback != nullptr)
+            continue;
+        task.deadline = millis() + delayMillis;
+        task.period = periodMillis;
+        task.callback = callback;
+        task.context = context;
+        place(heapSize, slot);
+        siftUp(heapSize++);
+        return ((TaskHandle)task.generation << 8) | slot;
+    }
+    TELEMETRY(SCHED_FULL);
+    return TASK_NONE;
+}
+
+void Scheduler::cancel(TaskHandle &handle)
+{
+    int8_t slot = slotOf(handle);
+    if (slot >= 0)
+    {
+        removeAt(tasks[slot].heapIndex);
+    }
+    handle = TASK_NONE;
+}
+
+bool Scheduler::reschedule(TaskHandle handle, uint32_t delayMillis)
+{
+    int8_t slot = slotOf(handle);
+    if (slot < 0)
+        return false;
+    tasks[slot].deadline = millis() + delayMillis;
+    siftUp(tasks[slot].heapIndex);
+    siftDown(tasks[slot].heapIndex);
+    return true;
+}
+
+bool Scheduler::setPeriod(TaskHandle handle, uint32_t periodMillis)
+{
+    int8_t slot = slotOf(handle);
+    if (slot < 0)
+        return false;
+    tasks[slot].period = periodMillis;
+    return true;
+}
+
+bool Scheduler::pending(TaskHandle handle) const
+{
+    return slotOf(handle) >= 0;
+}
+
+uint32_t Scheduler::millisUntilNext() const
+{
+    if (heapSize == 0)
+        return 0xFFFFFFFF;
+    uint32_t now = millis();
+    uint32_t deadline = tasks[heap[0]].deadline;
+    return timeReached(now, deadline) ? 0 : deadline - now;
+}
+
+void Scheduler::run()
+{
+#if PERF_STATS
+    uint32_t passStart = micros();
+    bool ran = false;
+#endif
+    uint32_t now = millis();
+    while (heapSize > 0 && timeReached(now, tasks[heap[0]].deadline))
+    {
+        uint8_t slot = heap[0];
+        Task &task = tasks[slot];
+        TaskCallback callback = task.callback;
+        void *context = task.context;
+#if PERF_STATS
+        perf.late(now - task.deadline);
+        ran = true;
+#endif
+
+        // Requeue or free before the callback so it can cancel or add tasks
+        if (task.period != 0)
+        {
+            task.deadline += task.period;
+            if (timeReached(now, task.deadline))
+                task.deadline = now + task.period; // Overran: skip missed periods, don't burst
+            siftDown(0);
+        }
+        else
+        {
+            removeAt(0);
+        }
+
+        callback(context);
+        now = millis();
+    }
+#if PERF_STATS
+    if (ran)
+        perf.record(PERF_LOOP, micros() - passStart);
+#endif
+    idle();
+}
+
+int8_t Scheduler::slotOf(TaskHandle handle) const
+{
+    uint8_t slot = handle & 0xFF;
+    if (handle == TASK_NONE || slot >= SCHEDULER_MAX_TASKS)
+        return -1;
+    const Task &task = tasks[slot];
+    if (task.callback == nullptr || task.generation != (handle >> 8))
+        return -1;
+    return slot;
+}
+
+bool Scheduler::earlier(uint8_t a, uint8_t b) const
+{
+    return (int32_t)(tasks[heap[a]].deadline - tasks[heap[b]].deadline) < 0;
+}
+
+void Scheduler::place(uint8_t index, uint8_t slot)
+{
+    heap[index] = slot;
+    tasks[slot].heapIndex = index;
+}
+
+void Scheduler::siftUp(uint8_t index)
+{
+    while (index > 0)
+    {
+        uint8_t parent = (index - 1) / 2;
+        if (!earlier(index, parent))
+            break;
+        uint8_t slot = heap[index];
+        place(index, heap[parent]);
+        place(parent, slot);
+        index = parent;
+    }
+}
+
+void Scheduler::siftDown(uint8_t index)
+{
+    for (;;)
+    {
+        uint8_t smallest = index;
+        uint8_t left = 2 * index + 1;
+        uint8_t right = left + 1;
+        if (left < heapSize && earlier(left, smallest))
+            smallest = left;
+        if (right < heapSize && earlier(right, smallest))
+            smallest = right;
+        if (smallest == index)
+            break;
+        uint8_t slot = heap[index];
+        place(index, heap[smallest]);
+        place(smallest, slot);
+        index = smallest;
+    }
+}
+
+void Scheduler::removeAt(uint8_t index)
+{
+    uint8_t slot = heap[index];
+    tasks[slot].callback = nullptr;
+    if (++tasks[slot].generation == 0)
+        tasks[slot].generation = 1; // Generation 0 would make handle 0 look valid
+
+    --heapSize;
+    if (index < heapSize)
+    {
+        place(index, heap[heapSize]);
+        siftUp(index);
+        siftDown(tasks[heap[index]].heapIndex);
+    }
+}
+
+bool Scheduler::onIdle(IdleHook hook)
+{
+    if (idleHookCount == SCHEDULER_MAX_IDLE_HOOKS)
+        return false;
+    idleHooks[idleHookCount++] = hook;
+    return true;
+}
+
+void Scheduler::idle()
+{
+    if (heapSize > 0 && millisUntilNext() == 0)
+        return;
+    for (uint8_t i = 0; i < idleHookCount; ++i)
+        idleHooks[i]();
+#if defined(__AVR__)
+    // Timer0 overflows every 1.024 ms, so idling for one interrupt at a time
+    // wakes us in time for any millisecond deadline.
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    sleep_enable();
+    sleep_cpu();
+    sleep_disable();
+#endif
+}
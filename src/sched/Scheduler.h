@@ -0,0 +1,74 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <Arduino.h>
+
+#define SCHEDULER_MAX_TASKS 12
+#define SCHEDULER_MAX_IDLE_HOOKS 4
+#define TASK_NONE 0
+
+typedef void (*TaskCallback)(void *context);
+typedef void (*IdleHook)();
+
+// Slot index in the low byte, generation in the high byte so a stale handle
+// to a finished one-shot can never cancel whichever task reused its slot.
+typedef uint16_t TaskHandle;
+
+// Wraparound-safe deadline check: valid while now and deadline are less than
+// 2^31 ms (~24 days) apart, which every timer in the dispenser is.
+inline bool timeReached(uint32_t now, uint32_t deadline)
+{
+    return (int32_t)(now - deadline) >= 0;
+}
+
+/**
+ * Cooperative deadline scheduler. Periodic and one-shot tasks sit in a
+ * binary min-heap keyed by deadline; run() executes only what is due and
+ * then idles the CPU until the next interrupt.
+ */
+class Scheduler
+{
+public:
+    Scheduler();
+
+    TaskHandle every(uint32_t periodMillis, TaskCallback callback, void *context, uint32_t firstDelayMillis = 0);
+    TaskHandle after(uint32_t delayMillis, TaskCallback callback, void *context);
+    void cancel(TaskHandle &handle);
+    bool reschedule(TaskHandle handle, uint32_t delayMillis);
+    bool setPeriod(TaskHandle handle, uint32_t periodMillis);
+    bool pending(TaskHandle handle) const;
+    bool onIdle(IdleHook hook); // Runs when nothing is due, before the CPU sleeps; false when all hooks are taken
+
+    uint32_t millisUntilNext() const;
+    void run();
+
+private:
+    struct Task
+    {
+        uint32_t deadline;
+        uint32_t period; // 0 for one-shot
+        TaskCallback callback;
+        void *context;
+        uint8_t generation;
+        uint8_t heapIndex;
+    };
+
+    Task tasks[SCHEDULER_MAX_TASKS];
+    uint8_t heap[SCHEDULER_MAX_TASKS]; // Task slots ordered by deadline
+    uint8_t heapSize;
+    IdleHook idleHooks[SCHEDULER_MAX_IDLE_HOOKS]; // In the order added
+    uint8_t idleHookCount;
+
+    TaskHandle add(uint32_t delayMillis, uint32_t periodMillis, TaskCallback callback, void *context);
+    int8_t slotOf(TaskHandle handle) const;
+    bool earlier(uint8_t a, uint8_t b) const;
+    void place(uint8_t index, uint8_t slot);
+    void siftUp(uint8_t index);
+    void siftDown(uint8_t index);
+    void removeAt(uint8_t index);
+    void idle();
+};
+
+extern Scheduler scheduler;
+
+#endif // SCHEDULER_H
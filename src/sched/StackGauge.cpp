@@ -0,0 +1,105 @@
+#include <Arduino.h>
+#include "sched/StackGauge.h"
+#include "telemetry/Telemetry.h"
+
+StackGauge stackGauge;
+
+#if defined(__AVR__)
+extern uint8_t __data_start;
+extern uint8_t __heap_start;
+extern uint8_t *__brkval; // malloc()'s break, 0 until something is allocated
+
+// Runs from .init1, before .data, .bss and the stack pointer are set up and
+// before r1 is zeroed, so nothing here may touch the stack: it is assembly,
+// painting from _end (the end of .bss and .noinit) up to __stack (RAMEND)
+void paintStack() __attribute__((naked, used, section(".init1")));
+void paintStack()
+{
+    asm volatile("    ldi r30, lo8(_end)\n"
+                 "    ldi r31, hi8(_end)\n"
+                 "    ldi r24, %0\n"
+                 "    ldi r25, hi8(__stack)\n"
+                 "    rjmp 2f\n"
+                 "1:  st Z+, r24\n"
+                 "2:  cpi r30, lo8(__stack)\n"
+                 "    cpc r31, r25\n"
+                 "    brlo 1b\n"
+                 "    breq 1b\n"
+                 :
+                 : "M"(STACK_PAINT));
+}
+
+static const volatile uint8_t *heapEnd()
+{
+    return __brkval ? __brkval : &__heap_start;
+}
+#endif
+
+void StackGauge::begin()
+{
+    TELEMETRY(MEMORY, staticBytes(), freeNow(), headroom());
+    if (ramBytes() != 0) // Nothing painted on the host
+        scheduler.onIdle(onIdle);
+}
+
+// The paint is only worn away from the top, so the first byte that isn't
+// paint, counting up from the heap, is as deep as the stack has been
+uint16_t StackGauge::headroom() const
+{
+#if defined(__AVR__)
+    const volatile uint8_t *p = heapEnd();
+    const volatile uint8_t *top = (const volatile uint8_t *)SP;
+    uint16_t bytes = 0;
+    while (p + bytes < top && p[bytes] == STACK_PAINT)
+        ++bytes;
+    return bytes;
+#else
+    return 0;
+#endif
+}
+
+uint16_t StackGauge::freeNow()
+{
+#if defined(__AVR__)
+    return (const volatile uint8_t *)SP - heapEnd();
+#else
+    return 0;
+#endif
+}
+
+uint16_t StackGauge::staticBytes()
+{
+#if defined(__AVR__)
+    return &__heap_start - &__data_start;
+#else
+    return 0;
+#endif
+}
+
+uint16_t StackGauge::ramBytes()
+{
+#if defined(__AVR__)
+    return RAMEND - RAMSTART + 1;
+#else
+    return 0;
+#endif
+}
+
+void StackGauge::onIdle()
+{
+    stackGauge.check();
+}
+
+void StackGauge::check()
+{
+    uint32_t now = millis();
+    if (!timeReached(now, lastCheck + STACK_CHECK_PERIOD))
+        return;
+    lastCheck = now;
+    uint16_t bytes = headroom();
+    if (!warned && bytes < STACK_LOW_BYTES)
+    {
+        warned = true;
+        TELEMETRY(STACK_LOW, bytes, freeNow());
+    }
+}
@@ -0,0 +1,42 @@
+#ifndef STACK_GAUGE_H
+#define STACK_GAUGE_H
+
+#include <Arduino.h>
+#include "sched/Scheduler.h"
+
+#define STACK_PAINT 0xC5         // Filled in before main(); the stack wears it away
+#define STACK_CHECK_PERIOD 1000  // Between scans of the paint (ms)
+#define STACK_LOW_BYTES 128      // STACK_LOW is logged once headroom falls under this
+
+/**
+ * How close the stack has come to the static data. Before the C runtime
+ * sets up .data and .bss, everything from the end of .bss to the top of RAM
+ * is painted with STACK_PAINT; whatever the stack or an interrupt frame
+ * ever writes there wears the paint away, so the paint left just above
+ * the heap is the headroom that was never used since reset. A scan is a
+ * few hundred byte compares, made from idle time once a second.
+ *
+ * The build checks the static side against the RAM size with
+ * tools/memory_budget.py; this is the measured side of the same budget.
+ * The host build has no paint and reports zeros.
+ */
+class StackGauge
+{
+public:
+    void begin();
+    uint16_t headroom() const;         // Paint left: bytes the stack has never reached
+    static uint16_t freeNow();         // Between the heap and the stack pointer, now
+    static uint16_t staticBytes();     // .data, .bss and .noinit
+    static uint16_t ramBytes();
+
+private:
+    uint32_t lastCheck = 0;
+    bool warned = false;
+
+    static void onIdle();
+    void check();
+};
+
+extern StackGauge stackGauge;
+
+#endif // STACK_GAUGE_H
@@ -0,0 +1,35 @@
+#include <Arduino.h>
+#include "screen/DisplayBatcher.h"
+
+void DisplayBatcher::begin(uint32_t freq)
+{
+    rangesKnown = false;
+    Adafruit_ILI9341::begin(freq);
+}
+
+void DisplayBatcher::setRotation(uint8_t r)
+{
+    rangesKnown = false;
+    Adafruit_ILI9341::setRotation(r);
+}
+
+// Called inside an open write, as upstream's is
+void DisplayBatcher::setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+    uint32_t nextColumns = ((uint32_t)x << 16) | (uint16_t)(x + w - 1);
+    uint32_t nextPages = ((uint32_t)y << 16) | (uint16_t)(y + h - 1);
+    if (!rangesKnown || nextColumns != columns)
+    {
+        writeCommand(ILI9341_CASET);
+        SPI_WRITE32(nextColumns);
+        columns = nextColumns;
+    }
+    if (!rangesKnown || nextPages != pages)
+    {
+        writeCommand(ILI9341_PASET);
+        SPI_WRITE32(nextPages);
+        pages = nextPages;
+    }
+    rangesKnown = true;
+    writeCommand(ILI9341_RAMWR); // Starts at the top left of both ranges
+}
@@ -0,0 +1,39 @@
+#ifndef DISPLAY_BATCHER_H
+#define DISPLAY_BATCHER_H
+
+#include <Arduino.h>
+#include "Adafruit_ILI9341.h"
+
+// The fastest the AVR's SPI runs (F_CPU / 2). The XPT2046 sets its own,
+// slower clock in each of its transactions on the shared bus.
+#define DISPLAY_SPI_HZ 8000000
+
+/**
+ * The ILI9341 with address windows sent only where they change. Every
+ * primitive ends in setAddrWindow(), which upstream sends as CASET, PASET
+ * and RAMWR, 11 bytes, even when it fills a pixel or two. The controller
+ * keeps the column and page ranges until they are set again, so here only
+ * the range that differs from the last one goes out: the runs along one
+ * row of the eye, or a column of bars, cost 6 bytes of setup instead.
+ *
+ * Anything that resets or remaps the controller's registers (begin(),
+ * setRotation()) forgets the ranges, so the next window sends both.
+ * Transactions are unchanged: the arbiter's display slot still opens one
+ * around everything drawn in it.
+ */
+class DisplayBatcher : public Adafruit_ILI9341
+{
+public:
+    DisplayBatcher(int8_t cs, int8_t dc, int8_t rst = -1) : Adafruit_ILI9341(cs, dc, rst) {}
+
+    void begin(uint32_t freq = DISPLAY_SPI_HZ);
+    void setRotation(uint8_t r) override;
+    void setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) override;
+
+private:
+    uint32_t columns = 0; // As sent with CASET: first << 16 | last
+    uint32_t pages = 0;   // and with PASET
+    bool rangesKnown = false;
+};
+
+#endif // DISPLAY_BATCHER_H
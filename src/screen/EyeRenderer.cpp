@@ -0,0 +1,169 @@
+#include <Arduino.h>
+#include "Adafruit_ILI9341.h"
+#include "screen/EyeRenderer.h"
+#include "sched/BusArbiter.h"
+
+// Half-width of each row of a filled circle, indexed by distance from centre
+static const uint8_t scleraSpan[EYE_RADIUS + 1] PROGMEM = {
+    60, 60, 60, 60, 60, 60, 60, 60, 59, 59, 59, 59, 59, 59, 58, 58, 58, 58, 57, 57, 57,
+    56, 56, 55, 55, 55, 54, 54, 53, 53, 52, 51, 51, 50, 49, 49, 48, 47, 46, 46, 45,
+    44, 43, 42, 41, 40, 39, 37, 36, 35, 33, 32, 30, 28, 26, 24, 22, 19, 15, 11, 0};
+
+static const uint8_t pupilSpan[PUPIL_RADIUS + 1] PROGMEM = {
+    30, 30, 30, 30, 30, 30, 29, 29, 29, 29, 28, 28, 27, 27, 27, 26,
+    25, 25, 24, 23, 22, 21, 20, 19, 18, 17, 15, 13, 11, 8, 0};
+
+EyeRenderer::EyeRenderer(Adafruit_SPITFT *tft)
+{
+    this->tft = tft;
+    reset();
+}
+
+void EyeRenderer::reset()
+{
+    drawn.visible = false;
+}
+
+void EyeRenderer::draw(int16_t x, int16_t y, bool blink)
+{
+    Pose next = {x, y, blink, true};
+    render(next);
+}
+
+void EyeRenderer::erase()
+{
+    Pose next = drawn;
+    next.visible = false;
+    render(next);
+}
+
+Rect EyeRenderer::bounds() const
+{
+    Rect r = {0, 0, 0, 0};
+    if (drawn.visible)
+    {
+        r = {(int16_t)(drawn.x - EYE_RADIUS), (int16_t)(drawn.y - EYE_RADIUS), 2 * EYE_RADIUS + 1, 2 * EYE_RADIUS + 1};
+    }
+    return r;
+}
+
+// Writes the white (sclera) intervals of one row as half-open [start, end)
+// pairs and returns how many pairs there are (0-2).
+uint8_t EyeRenderer::rowSpans(const Pose &pose, int16_t y, int16_t *spans)
+{
+    if (!pose.visible)
+        return 0;
+    int16_t dy = abs(y - pose.y);
+    if (dy > EYE_RADIUS)
+        return 0;
+    if (pose.blink && dy <= BLINK_HALF_HEIGHT)
+        return 0; // Eyelid covers the middle band
+
+    int16_t outer = pgm_read_byte(&scleraSpan[dy]);
+    if (pose.blink || dy > PUPIL_RADIUS)
+    {
+        spans[0] = pose.x - outer;
+        spans[1] = pose.x + outer + 1;
+        return 1;
+    }
+    int16_t inner = pgm_read_byte(&pupilSpan[dy]);
+    spans[0] = pose.x - outer;
+    spans[1] = pose.x - inner;
+    spans[2] = pose.x + inner + 1;
+    spans[3] = pose.x + outer + 1;
+    return 2;
+}
+
+void EyeRenderer::render(const Pose &next)
+{
+    if (next.visible == drawn.visible && (!next.visible || (next.x == drawn.x && next.y == drawn.y && next.blink == drawn.blink)))
+    {
+        pixelsLastFrame = 0;
+        return;
+    }
+
+    int16_t top = 0x7FFF, bottom = -0x7FFF;
+    if (drawn.visible)
+    {
+        top = drawn.y - EYE_RADIUS;
+        bottom = drawn.y + EYE_RADIUS;
+    }
+    if (next.visible)
+    {
+        top = min(top, (int16_t)(next.y - EYE_RADIUS));
+        bottom = max(bottom, (int16_t)(next.y + EYE_RADIUS));
+    }
+
+    if (!arbiter.acquire(ARBITER_DISPLAY))
+        return; // drawn is unchanged, so the next frame covers this one
+    uint16_t pixels = 0;
+    for (int16_t y = top; y <= bottom; ++y)
+    {
+        int16_t oldSpans[4], newSpans[4];
+        uint8_t oldCount = rowSpans(drawn, y, oldSpans);
+        uint8_t newCount = rowSpans(next, y, newSpans);
+
+        // Merge both sets of boundaries into one sorted list
+        int16_t edges[8];
+        uint8_t edgeCount = 0;
+        for (uint8_t i = 0; i < oldCount * 2; ++i)
+            edges[edgeCount++] = oldSpans[i];
+        for (uint8_t i = 0; i < newCount * 2; ++i)
+            edges[edgeCount++] = newSpans[i];
+        for (uint8_t i = 1; i < edgeCount; ++i)
+        {
+            int16_t e = edges[i];
+            uint8_t j = i;
+            for (; j > 0 && edges[j - 1] > e; --j)
+                edges[j] = edges[j - 1];
+            edges[j] = e;
+        }
+
+        // Walk the segments between boundaries; emit only those whose colour
+        // differs between the old and new eye, joining neighbours of one colour
+        int16_t runStart = 0, runEnd = 0;
+        uint16_t runColor = 0;
+        bool inRun = false;
+        uint8_t oldIdx = 0, newIdx = 0;
+        for (uint8_t i = 0; i + 1 < edgeCount; ++i)
+        {
+            int16_t a = edges[i], b = edges[i + 1];
+            if (a == b)
+                continue;
+            while (oldIdx < oldCount && oldSpans[oldIdx * 2 + 1] <= a)
+                ++oldIdx;
+            while (newIdx < newCount && newSpans[newIdx * 2 + 1] <= a)
+                ++newIdx;
+            bool wasWhite = oldIdx < oldCount && oldSpans[oldIdx * 2] <= a;
+            bool isWhite = newIdx < newCount && newSpans[newIdx * 2] <= a;
+            if (wasWhite == isWhite)
+                continue;
+            uint16_t color = isWhite ? ILI9341_WHITE : ILI9341_BLACK;
+            if (inRun && runEnd == a && runColor == color)
+            {
+                runEnd = b;
+                continue;
+            }
+            if (inRun)
+            {
+                tft->writeFastHLine(runStart, y, runEnd - runStart, runColor);
+                pixels += runEnd - runStart;
+            }
+            runStart = a;
+            runEnd = b;
+            runColor = color;
+            inRun = true;
+        }
+        if (inRun)
+        {
+            tft->writeFastHLine(runStart, y, runEnd - runStart, runColor);
+            pixels += runEnd - runStart;
+        }
+    }
+    arbiter.release(ARBITER_DISPLAY);
+
+    drawn = next;
+    pixelsLastFrame = pixels;
+    pixelsTotal += pixels;
+    ++frames;
+}
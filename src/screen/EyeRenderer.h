@@ -0,0 +1,54 @@
+#ifndef EYE_RENDERER_H
+#define EYE_RENDERER_H
+
+#include <Arduino.h>
+#include "Adafruit_GFX.h"
+#include "screen/Scene.h"
+
+#define EYE_RADIUS 60
+#define PUPIL_RADIUS 30
+#define BLINK_HALF_HEIGHT 10
+
+// Eye positions are kept in fixed point with 4 fractional bits (1/16 px)
+#define EYE_SUBPIXEL_SHIFT 4
+#define EYE_TO_FIXED(px) ((int16_t)((px) << EYE_SUBPIXEL_SHIFT))
+#define EYE_FROM_FIXED(fx) ((int16_t)(((fx) + (1 << (EYE_SUBPIXEL_SHIFT - 1))) >> EYE_SUBPIXEL_SHIFT))
+
+/**
+ * Delta renderer for the idle eye.
+ *
+ * Remembers the pose it last drew and, for each row the old and new eye
+ * cover, writes only the pixels whose colour changes: the leading crescent
+ * of sclera and pupil is filled, the trailing crescent cleared. Row extents
+ * come from precomputed half-width tables in flash.
+ */
+class EyeRenderer
+{
+public:
+    EyeRenderer(Adafruit_SPITFT *tft);
+
+    void reset(); // Screen was cleared, nothing of the eye is on it
+    void draw(int16_t x, int16_t y, bool blink);
+    void erase();
+    Rect bounds() const; // Area the drawn eye covers, empty if none
+
+    uint16_t pixelsLastFrame = 0; // Pixels pushed by the last draw()/erase()
+    uint32_t pixelsTotal = 0;
+    uint32_t frames = 0;
+
+private:
+    struct Pose
+    {
+        int16_t x, y;
+        bool blink;
+        bool visible;
+    };
+
+    Adafruit_SPITFT *tft;
+    Pose drawn;
+
+    void render(const Pose &next);
+    static uint8_t rowSpans(const Pose &pose, int16_t y, int16_t *spans);
+};
+
+#endif // EYE_RENDERER_H
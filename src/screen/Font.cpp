@@ -0,0 +1,96 @@
+#include <Arduino.h>
+#include "screen/Font.h"
+
+FontRenderer::FontRenderer(const Font *fontInFlash)
+{
+    memcpy_P(&font, fontInFlash, sizeof(Font));
+}
+
+const FontGlyph &FontRenderer::glyph(uint8_t c, FontGlyph &out) const
+{
+    if (c < font.first || c > font.last)
+        c = font.first;
+    memcpy_P(&out, &font.glyphs[c - font.first], sizeof(FontGlyph));
+    return out;
+}
+
+uint8_t FontRenderer::glyphWidth(char c) const
+{
+    FontGlyph g;
+    return glyph(c, g).width;
+}
+
+uint8_t FontRenderer::layout(const char *text, bool inFlash, int16_t maxWidth, GlyphRuns *glyphs, uint8_t maxGlyphs, int16_t &width) const
+{
+    uint8_t count = 0;
+    width = 0;
+    for (const char *p = text; count < maxGlyphs; ++p)
+    {
+        uint8_t c = inFlash ? pgm_read_byte(p) : *p;
+        if (c == '\0')
+            break;
+        FontGlyph g;
+        glyph(c, g);
+        if (width + g.width > maxWidth)
+            break;
+        glyphs[count].next = font.data + g.offset;
+        glyphs[count].remaining = 0;
+        glyphs[count].width = g.width;
+        width += g.width;
+        ++count;
+    }
+    return count;
+}
+
+void FontRenderer::row(GlyphRuns *glyphs, uint8_t count, const uint16_t *shades, RunWriter &out)
+{
+    for (uint8_t i = 0; i < count; ++i)
+    {
+        GlyphRuns &g = glyphs[i];
+        uint8_t left = g.width;
+        while (left != 0)
+        {
+            if (g.remaining == 0)
+            {
+                uint8_t run = pgm_read_byte(g.next++);
+                g.level = FONT_RUN_LEVEL(run);
+                g.remaining = FONT_RUN_LENGTH(run);
+            }
+            uint8_t n = min(left, g.remaining);
+            out.push(shades[g.level], n);
+            g.remaining -= n;
+            left -= n;
+        }
+    }
+}
+
+// Level l of 3 is l/3 of the way from bg to fg, per RGB565 channel
+void FontRenderer::shades(uint16_t bg, uint16_t fg, uint16_t *out)
+{
+    for (uint8_t level = 0; level < FONT_LEVELS; ++level)
+    {
+        uint8_t keep = FONT_LEVELS - 1 - level;
+        uint16_t r = ((bg >> 11) * keep + (fg >> 11) * level) / (FONT_LEVELS - 1);
+        uint16_t g = (((bg >> 5) & 0x3F) * keep + ((fg >> 5) & 0x3F) * level) / (FONT_LEVELS - 1);
+        uint16_t b = ((bg & 0x1F) * keep + (fg & 0x1F) * level) / (FONT_LEVELS - 1);
+        out[level] = r << 11 | g << 5 | b;
+    }
+}
+
+void FontRenderer::drawText(Adafruit_SPITFT *tft, int16_t x, int16_t y, int16_t w, const char *text, uint16_t fg, uint16_t bg) const
+{
+    GlyphRuns glyphs[FONT_MAX_LINE];
+    int16_t textWidth;
+    uint8_t count = layout(text, false, w, glyphs, FONT_MAX_LINE, textWidth);
+    uint16_t colors[FONT_LEVELS];
+    shades(bg, fg, colors);
+
+    RunWriter out = {tft, 0, 0};
+    tft->setAddrWindow(x, y, w, font.height);
+    for (uint8_t line = 0; line < font.height; ++line)
+    {
+        row(glyphs, count, colors, out);
+        out.push(bg, w - textWidth);
+    }
+    out.flush();
+}
@@ -0,0 +1,99 @@
+#ifndef FONT_H
+#define FONT_H
+
+#include <Arduino.h>
+#include "Adafruit_GFX.h"
+
+// One character cell: its runs start at data[offset], and it is width
+// pixels wide (the advance) by the font's height
+struct FontGlyph
+{
+    uint16_t offset;
+    uint8_t width;
+};
+
+/**
+ * Anti-aliased proportional font in flash, generated by
+ * tools/font_rasterize.py. Each glyph is coded row-major as runs of one
+ * byte: coverage level 0-3 in the top two bits, length - 1 in the low six.
+ * A run may carry on from one row of the glyph into the next, so a line of
+ * text is drawn by keeping one GlyphRuns per character and pulling each
+ * row's pixels from them in turn.
+ */
+struct Font
+{
+    uint8_t first, last; // Character range; others draw as the first
+    uint8_t height;
+    const FontGlyph *glyphs;
+    const uint8_t *data;
+};
+
+#define FONT_LEVELS 4
+#define FONT_RUN_LEVEL(run) ((run) >> 6)
+#define FONT_RUN_LENGTH(run) (((run) & 0x3F) + 1)
+
+// Decoder for one glyph's runs
+struct GlyphRuns
+{
+    const uint8_t *next; // Next run byte in flash
+    uint8_t level;
+    uint8_t remaining;   // Pixels left in the current run
+    uint8_t width;
+};
+
+// Joins neighbouring pixels of one colour, across rows too, into a single
+// writeColor() on the open address window
+struct RunWriter
+{
+    Adafruit_SPITFT *tft;
+    uint16_t color;
+    uint16_t length;
+
+    void push(uint16_t c, uint16_t n)
+    {
+        if (c != color && length != 0)
+        {
+            tft->writeColor(color, length);
+            length = 0;
+        }
+        color = c;
+        length += n;
+    }
+    void flush()
+    {
+        if (length != 0)
+            tft->writeColor(color, length);
+        length = 0;
+    }
+};
+
+/**
+ * Lays out and streams text in a flash font. layout() sets up one
+ * GlyphRuns per character; row() then emits the next pixel row of all of
+ * them, so callers can wrap text rows in whatever else shares the window.
+ */
+class FontRenderer
+{
+public:
+    explicit FontRenderer(const Font *fontInFlash);
+
+    uint8_t height() const { return font.height; }
+    uint8_t glyphWidth(char c) const;
+    // Characters that fit in maxWidth, up to maxGlyphs; width gets their total
+    uint8_t layout(const char *text, bool inFlash, int16_t maxWidth, GlyphRuns *glyphs, uint8_t maxGlyphs, int16_t &width) const;
+    static void row(GlyphRuns *glyphs, uint8_t count, const uint16_t *shades, RunWriter &out);
+    static void shades(uint16_t bg, uint16_t fg, uint16_t *out); // FONT_LEVELS colours
+    // One line in a window of its own, left aligned and padded to w with bg
+    void drawText(Adafruit_SPITFT *tft, int16_t x, int16_t y, int16_t w, const char *text, uint16_t fg, uint16_t bg) const;
+
+private:
+    Font font;
+    const FontGlyph &glyph(uint8_t c, FontGlyph &out) const;
+};
+
+#define FONT_MAX_LINE 16 // Characters drawText() lays out
+
+// Font tables live in flash; FontRenderer copies the header out
+extern const Font buttonFont PROGMEM;
+
+#endif // FONT_H
@@ -0,0 +1,101 @@
+#include <Arduino.h>
+#include "Adafruit_ILI9341.h"
+#include "screen/Menus.h"
+
+static const char labelP1[] PROGMEM = "P1";
+static const char labelP2[] PROGMEM = "P2";
+static const char labelServo[] PROGMEM = "Servo";
+static const char labelLeds[] PROGMEM = "LEDS";
+static const char labelBack[] PROGMEM = "Back...";
+static const char labelCal1[] PROGMEM = "Cal 1";
+static const char labelCal2[] PROGMEM = "Cal 2";
+static const char labelFill[] PROGMEM = "Fill";
+static const char labelShort[] PROGMEM = "2 s";
+static const char labelLong[] PROGMEM = "8 s";
+static const char labelTrickle[] PROGMEM = "Trickle";
+static const char labelDown[] PROGMEM = "-";
+static const char labelUp[] PROGMEM = "+";
+static const char labelSave[] PROGMEM = "Save";
+static const char labelTest[] PROGMEM = "Test";
+static const char labelMore[] PROGMEM = "More...";
+#if PERF_STATS
+static const char labelPerf[] PROGMEM = "Perf";
+static const char labelReset[] PROGMEM = "Reset";
+#endif
+
+// Pumps past the second are tested over the link
+static const Button testMenu[] PROGMEM = {
+    {20, 30, 70, 50, labelP1, ILI9341_WHITE, ILI9341_CYAN, ACTION_TEST_PUMP, 0, true},
+    {100, 30, 70, 50, labelP2, ILI9341_WHITE, ILI9341_MAGENTA, ACTION_TEST_PUMP, 1, true},
+    {20, 90, 70, 50, labelServo, ILI9341_WHITE, ILI9341_ORANGE, ACTION_TEST_SERVO, 0, true},
+    {100, 90, 70, 50, labelLeds, ILI9341_WHITE, ILI9341_PURPLE, ACTION_TEST_LEDS, 0, true},
+    {20, 150, 230, 50, labelBack, ILI9341_WHITE, ILI9341_RED, ACTION_BACK, 0, true},
+    {180, 30, 70, 50, labelCal1, ILI9341_WHITE, ILI9341_DARKCYAN, ACTION_CALIBRATE, 0, true},
+    {180, 90, 70, 50, labelCal2, ILI9341_WHITE, ILI9341_DARKCYAN, ACTION_CALIBRATE, 1, true},
+    {260, 30, 50, 110, labelFill, ILI9341_WHITE, ILI9341_NAVY, ACTION_REFILL, 0, true},
+#if PERF_STATS
+    {260, 150, 50, 50, labelPerf, ILI9341_WHITE, ILI9341_DARKGREEN, ACTION_PERF_MENU, 0, true},
+#endif
+};
+
+// Three timed runs, the volume measured for the selected one, and save/back.
+// The runs are all unselected here, and the volume button has no label yet.
+static const Button calibrateMenu[] PROGMEM = {
+    {20, 35, 90, 50, labelShort, ILI9341_WHITE, ILI9341_BLUE, ACTION_CAL_RUN, 0, true},
+    {115, 35, 90, 50, labelLong, ILI9341_WHITE, ILI9341_BLUE, ACTION_CAL_RUN, 1, true},
+    {20, 95, 60, 50, labelDown, ILI9341_WHITE, ILI9341_DARKGREY, ACTION_CAL_ADJUST, 0, true},
+    {90, 95, 140, 50, nullptr, ILI9341_BLACK, ILI9341_WHITE, ACTION_NONE, 0, false},
+    {240, 95, 60, 50, labelUp, ILI9341_WHITE, ILI9341_DARKGREY, ACTION_CAL_ADJUST, 1, true},
+    {20, 160, 135, 50, labelSave, ILI9341_WHITE, ILI9341_GREEN, ACTION_CAL_SAVE, 0, true},
+    {165, 160, 135, 50, labelBack, ILI9341_WHITE, ILI9341_RED, ACTION_TEST_MENU, 0, true},
+    {210, 35, 90, 50, labelTrickle, ILI9341_WHITE, ILI9341_BLUE, ACTION_CAL_RUN, 2, true},
+};
+
+#if PERF_STATS
+// The histograms fill the top 200 px
+static const Button perfMenu[] PROGMEM = {
+    {20, 200, 135, 36, labelReset, ILI9341_WHITE, ILI9341_DARKGREY, ACTION_PERF_RESET, 0, true},
+    {165, 200, 135, 36, labelBack, ILI9341_WHITE, ILI9341_RED, ACTION_TEST_MENU, 0, true},
+};
+#endif
+
+static const Button navMenu[] PROGMEM = {
+    {0, 200, 320, 40, labelTest, ILI9341_WHITE, ILI9341_GREEN, ACTION_TEST_MENU, 0, true},
+};
+
+static const Button navPagedMenu[] PROGMEM = {
+    {0, 200, 160, 40, labelTest, ILI9341_WHITE, ILI9341_GREEN, ACTION_TEST_MENU, 0, true},
+    {160, 200, 160, 40, labelMore, ILI9341_WHITE, ILI9341_BLUE, ACTION_NEXT_PAGE, 0, true},
+};
+
+struct MenuTable
+{
+    const Button *buttons;
+    uint8_t count;
+};
+
+#define MENU_TABLE(table) {table, sizeof(table) / sizeof(Button)}
+
+// Indexed by MenuId
+static const MenuTable menus[MENU_COUNT] PROGMEM = {
+    MENU_TABLE(testMenu),
+    MENU_TABLE(calibrateMenu),
+#if PERF_STATS
+    MENU_TABLE(perfMenu),
+#else
+    {nullptr, 0},
+#endif
+    MENU_TABLE(navMenu),
+    MENU_TABLE(navPagedMenu),
+};
+
+static_assert(sizeof(testMenu) / sizeof(Button) <= MENU_MAX_BUTTONS && sizeof(calibrateMenu) / sizeof(Button) <= MENU_MAX_BUTTONS,
+              "MENU_MAX_BUTTONS is the longest menu");
+
+uint8_t Menus::read(uint8_t menu, Button *buttons)
+{
+    MenuTable table;
+    memcpy_P(&table, &menus[menu], sizeof(MenuTable));
+    memcpy_P(buttons, table.buttons, table.count * sizeof(Button));
+    return table.count;
+}
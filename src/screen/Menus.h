@@ -0,0 +1,52 @@
+#ifndef MENUS_H
+#define MENUS_H
+
+#include <Arduino.h>
+#include "screen/Scene.h"
+#include "sched/PerfStats.h"
+
+#define MENU_MAX_BUTTONS 9 // The longest table, and the buffer a menu is loaded into
+
+enum ActionId
+{
+    ACTION_NONE,
+    ACTION_POUR_RECIPE, // arg: recipe index
+    ACTION_NEXT_PAGE,
+    ACTION_TEST_MENU,
+    ACTION_BACK,
+    ACTION_TEST_PUMP,   // arg: pump index
+    ACTION_TEST_SERVO,
+    ACTION_TEST_LEDS,
+    ACTION_CALIBRATE,   // arg: pump index
+    ACTION_CAL_RUN,     // arg: 0 short run, 1 long run, 2 trickle
+    ACTION_CAL_ADJUST,  // arg: 0 down, 1 up
+    ACTION_CAL_SAVE,
+    ACTION_PERF_MENU,
+    ACTION_PERF_RESET,
+    ACTION_REFILL
+};
+
+enum MenuId
+{
+    MENU_TEST,
+    MENU_CALIBRATE,
+    MENU_PERF,      // Empty without PERF_STATS
+    MENU_NAV,       // The regular menu's bottom row: Test
+    MENU_NAV_PAGED, // Test and More... when the recipes take several pages
+    MENU_COUNT
+};
+
+/**
+ * The fixed menus, kept in flash with their labels and colours. A menu is
+ * copied into the one RAM buffer the screen hit-tests against when it is
+ * shown; what changes on a page (the selected run, a measured volume) is
+ * patched into the copy. The labels stay in flash, and Scene draws them
+ * from there.
+ */
+class Menus
+{
+public:
+    static uint8_t read(uint8_t menu, Button *buttons); // Returns the button count
+};
+
+#endif // MENUS_H
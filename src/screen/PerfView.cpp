@@ -0,0 +1,110 @@
+#include <Arduino.h>
+#include "Adafruit_ILI9341.h"
+#include "screen/PerfView.h"
+#include "sched/BusArbiter.h"
+
+#if PERF_STATS
+
+static const char probeNames[PERF_PROBE_COUNT][8] PROGMEM = {
+    "Loop", "Screen", "Eye", "LEDs", "Touch", "Pour", "Servo", "Link", "Late"};
+
+PerfView::PerfView(Adafruit_SPITFT *tft)
+    : font(&buttonFont)
+{
+    this->tft = tft;
+}
+
+Rect PerfView::bounds() const
+{
+    Rect r = {0, PERF_VIEW_TOP, tft->width(), PERF_PROBE_COUNT * PERF_VIEW_ROW_PITCH};
+    return r;
+}
+
+void PerfView::begin()
+{
+    // Heights start at 0, over the background the scene has just cleared;
+    // 0xFFFF is no figure, so every figure is drawn on the first tick
+    memset(shown, 0, sizeof(shown));
+    memset(shownFigure, 0xFF, sizeof(shownFigure));
+    if (arbiter.acquire(ARBITER_DISPLAY))
+    {
+        for (uint8_t p = 0; p < PERF_PROBE_COUNT; ++p)
+        {
+            char caption[8];
+            strcpy_P(caption, probeNames[p]);
+            font.drawText(tft, PERF_VIEW_CAPTION_X, PERF_VIEW_TOP + p * PERF_VIEW_ROW_PITCH, PERF_VIEW_CAPTION_W, caption,
+                          ILI9341_WHITE, ILI9341_BLACK);
+        }
+        arbiter.release(ARBITER_DISPLAY);
+    }
+    tick();
+
+    scheduler.cancel(task);
+    task = scheduler.every(PERF_VIEW_PERIOD, onTick, this, PERF_VIEW_PERIOD);
+}
+
+void PerfView::stop()
+{
+    scheduler.cancel(task);
+}
+
+void PerfView::onTick(void *context)
+{
+    PERF_SCOPE(PERF_SCREEN);
+    static_cast<PerfView *>(context)->tick();
+}
+
+void PerfView::tick()
+{
+    if (!arbiter.acquire(ARBITER_DISPLAY))
+        return; // The next tick catches up
+    for (uint8_t p = 0; p < PERF_PROBE_COUNT; ++p)
+    {
+        const PerfStats::Probe &probe = perf.probes[p];
+        int16_t top = PERF_VIEW_TOP + p * PERF_VIEW_ROW_PITCH;
+        int16_t base = top + PERF_VIEW_BAR_H; // Bars grow up from here
+        for (uint8_t b = 0; b < PERF_BUCKETS; ++b)
+        {
+            uint8_t height = 0;
+            for (uint16_t count = probe.buckets[b]; count != 0 && height < PERF_VIEW_BAR_H; count >>= 1)
+                ++height;
+            uint8_t was = shownHeight(p, b);
+            if (height == was)
+                continue;
+            int16_t x = PERF_VIEW_BARS_X + b * PERF_VIEW_BAR_PITCH;
+            if (height > was)
+                tft->writeFillRect(x, base - height, PERF_VIEW_BAR_W, height - was, ILI9341_GREEN);
+            else
+                tft->writeFillRect(x, base - was, PERF_VIEW_BAR_W, was - height, ILI9341_BLACK);
+            setShownHeight(p, b, height);
+        }
+
+        uint32_t tenths = p == PERF_LATE ? perf.missed : (probe.maxMicros + 50) / 100;
+        uint16_t figure = min(tenths, (uint32_t)0xFFFE);
+        if (figure != shownFigure[p])
+        {
+            char text[FONT_MAX_LINE];
+            if (p == PERF_LATE)
+                snprintf_P(text, sizeof(text), PSTR("%u missed"), figure);
+            else
+                snprintf_P(text, sizeof(text), PSTR("%u.%u ms"), figure / 10, figure % 10);
+            font.drawText(tft, PERF_VIEW_TEXT_X, top, PERF_VIEW_TEXT_W, text, ILI9341_WHITE, ILI9341_BLACK);
+            shownFigure[p] = figure;
+        }
+    }
+    arbiter.release(ARBITER_DISPLAY);
+}
+
+uint8_t PerfView::shownHeight(uint8_t probe, uint8_t bucket) const
+{
+    uint8_t pair = shown[probe][bucket / 2];
+    return bucket & 1 ? pair >> 4 : pair & 0x0F;
+}
+
+void PerfView::setShownHeight(uint8_t probe, uint8_t bucket, uint8_t height)
+{
+    uint8_t &pair = shown[probe][bucket / 2];
+    pair = bucket & 1 ? (pair & 0x0F) | (height << 4) : (pair & 0xF0) | height;
+}
+
+#endif
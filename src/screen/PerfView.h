@@ -0,0 +1,57 @@
+#ifndef PERF_VIEW_H
+#define PERF_VIEW_H
+
+#include <Arduino.h>
+#include "Adafruit_GFX.h"
+#include "sched/Scheduler.h"
+#include "sched/PerfStats.h"
+#include "screen/Font.h"
+#include "screen/Scene.h"
+
+#if PERF_STATS
+
+#define PERF_VIEW_PERIOD 500    // ms between refreshes
+#define PERF_VIEW_TOP 6
+#define PERF_VIEW_ROW_PITCH 21  // PERF_PROBE_COUNT rows above the buttons at y=200
+#define PERF_VIEW_CAPTION_X 4
+#define PERF_VIEW_CAPTION_W 64
+#define PERF_VIEW_BARS_X 70
+#define PERF_VIEW_BAR_PITCH 10  // 8 px column, 2 px gap
+#define PERF_VIEW_BAR_W 8
+#define PERF_VIEW_BAR_H 15      // A pixel per bit of the count
+#define PERF_VIEW_TEXT_X 196
+#define PERF_VIEW_TEXT_W 120
+
+/**
+ * The test menu's Perf page: a row per probe with its log2 histogram as a
+ * column per bucket, each as tall as its count has bits, and the longest
+ * sample (for PERF_LATE, the deadlines missed). begin() draws the captions;
+ * each refresh then redraws only the columns whose height changed and the
+ * figures that moved, which after the first few seconds is almost nothing.
+ */
+class PerfView
+{
+public:
+    PerfView(Adafruit_SPITFT *tft);
+
+    void begin();
+    void stop();
+    bool running() const { return scheduler.pending(task); }
+    Rect bounds() const; // Everything begin() and the ticks draw on
+
+private:
+    Adafruit_SPITFT *tft;
+    FontRenderer font;
+    TaskHandle task = TASK_NONE;
+    uint8_t shown[PERF_PROBE_COUNT][PERF_BUCKETS / 2]; // Column heights on screen, a nibble each
+    uint16_t shownFigure[PERF_PROBE_COUNT];           // Max in 0.1 ms, or missed count
+
+    static void onTick(void *context);
+    void tick();
+    uint8_t shownHeight(uint8_t probe, uint8_t bucket) const;
+    void setShownHeight(uint8_t probe, uint8_t bucket, uint8_t height);
+};
+
+#endif
+
+#endif // PERF_VIEW_H
@@ -0,0 +1,127 @@
+#include <Arduino.h>
+#include "Adafruit_ILI9341.h"
+#include "screen/ProgressView.h"
+#include "sched/BusArbiter.h"
+#include "sched/PerfStats.h"
+
+#define BAR_INNER_W (PROGRESS_BAR_W - 2)
+
+// Bar colour by pump, as on the test menu's P1/P2 buttons
+static const uint16_t pumpColors[] = {ILI9341_CYAN, ILI9341_MAGENTA, ILI9341_ORANGE, ILI9341_GREENYELLOW};
+
+ProgressView::ProgressView(Adafruit_SPITFT *tft)
+    : font(&buttonFont)
+{
+    this->tft = tft;
+}
+
+Rect ProgressView::bounds() const
+{
+    int16_t bottom = PROGRESS_TOP + bars * PROGRESS_ROW_PITCH;
+    Rect r = {0, PROGRESS_COUNTDOWN_Y, tft->width(), (int16_t)(bottom - PROGRESS_COUNTDOWN_Y)};
+    return r;
+}
+
+void ProgressView::begin(const PourPlanner *planner, uint32_t totalMillis)
+{
+    this->planner = planner;
+    deadline = millis() + totalMillis;
+    bars = planner ? planner->stepCount() : 0;
+    pixelsPushed = 0;
+    memset(shown, 0, sizeof(shown));
+
+    if (arbiter.acquire(ARBITER_DISPLAY))
+    {
+        for (uint8_t i = 0; i < bars; ++i)
+        {
+            const PourStep &step = planner->step(i);
+            int16_t y = PROGRESS_TOP + i * PROGRESS_ROW_PITCH;
+            char caption[FONT_MAX_LINE];
+            snprintf_P(caption, sizeof(caption), PSTR("P%u %u ml"), step.pump + 1, step.volumeMl);
+            font.drawText(tft, PROGRESS_CAPTION_X, y, PROGRESS_CAPTION_W, caption, ILI9341_WHITE, ILI9341_BLACK);
+            // Outline only; the inside is still background
+            tft->writeFastHLine(PROGRESS_BAR_X, y, PROGRESS_BAR_W, ILI9341_WHITE);
+            tft->writeFastHLine(PROGRESS_BAR_X, y + PROGRESS_BAR_H - 1, PROGRESS_BAR_W, ILI9341_WHITE);
+            tft->writeFastVLine(PROGRESS_BAR_X, y, PROGRESS_BAR_H, ILI9341_WHITE);
+            tft->writeFastVLine(PROGRESS_BAR_X + PROGRESS_BAR_W - 1, y, PROGRESS_BAR_H, ILI9341_WHITE);
+            filled[i] = 0;
+        }
+        int16_t unitX = PROGRESS_COUNTDOWN_X + 3 * font.glyphWidth('0') + font.glyphWidth('.');
+        font.drawText(tft, unitX, PROGRESS_COUNTDOWN_Y, font.glyphWidth(' ') + font.glyphWidth('s'), " s", ILI9341_WHITE, ILI9341_BLACK);
+        arbiter.release(ARBITER_DISPLAY);
+    }
+    tick();
+
+    scheduler.cancel(task);
+    task = scheduler.every(PROGRESS_PERIOD, onTick, this, PROGRESS_PERIOD);
+}
+
+void ProgressView::stop()
+{
+    scheduler.cancel(task);
+}
+
+void ProgressView::redraw()
+{
+    uint32_t now = millis();
+    begin(planner, timeReached(now, deadline) ? 0 : deadline - now);
+}
+
+void ProgressView::onTick(void *context)
+{
+    PERF_SCOPE(PERF_SCREEN);
+    static_cast<ProgressView *>(context)->tick();
+}
+
+void ProgressView::tick()
+{
+    if (!arbiter.acquire(ARBITER_DISPLAY))
+        return; // Nothing is lost: the next tick fills up to where the pour is then
+    for (uint8_t i = 0; i < bars; ++i)
+    {
+        const PourStep &step = planner->step(i);
+        uint32_t left = min(planner->stepMillisLeft(i), step.runMillis);
+        uint8_t columns = step.runMillis ? (uint32_t)BAR_INNER_W * (step.runMillis - left) / step.runMillis : BAR_INNER_W;
+        if (columns > filled[i])
+        {
+            int16_t y = PROGRESS_TOP + i * PROGRESS_ROW_PITCH + 1;
+            int16_t width = columns - filled[i];
+            tft->writeFillRect(PROGRESS_BAR_X + 1 + filled[i], y, width, PROGRESS_BAR_H - 2,
+                               pumpColors[step.pump % (sizeof(pumpColors) / sizeof(pumpColors[0]))]);
+            pixelsPushed += (uint32_t)width * (PROGRESS_BAR_H - 2);
+            filled[i] = columns;
+        }
+    }
+    if (planner)
+    {
+        drawCountdown(planner->millisRemaining());
+    }
+    else
+    {
+        int32_t left = (int32_t)(deadline - millis());
+        drawCountdown(left > 0 ? left : 0);
+    }
+    arbiter.release(ARBITER_DISPLAY);
+}
+
+// Tenths of a second as "dd.d", each character in a fixed cell so only the
+// ones that change are redrawn. DejaVu's digits all share one width.
+void ProgressView::drawCountdown(uint32_t millisLeft)
+{
+    uint16_t tenths = min((millisLeft + 99) / 100, (uint32_t)999);
+    char text[4] = {(char)(tenths >= 100 ? '0' + tenths / 100 : ' '), (char)('0' + tenths / 10 % 10), '.', (char)('0' + tenths % 10)};
+    int16_t digitWidth = font.glyphWidth('0');
+    int16_t x = PROGRESS_COUNTDOWN_X;
+    for (uint8_t i = 0; i < 4; ++i)
+    {
+        int16_t cellWidth = text[i] == '.' ? font.glyphWidth('.') : digitWidth;
+        if (text[i] != shown[i])
+        {
+            char cell[2] = {text[i], '\0'};
+            font.drawText(tft, x, PROGRESS_COUNTDOWN_Y, cellWidth, cell, ILI9341_WHITE, ILI9341_BLACK);
+            pixelsPushed += (uint32_t)cellWidth * font.height();
+            shown[i] = text[i];
+        }
+        x += cellWidth;
+    }
+}
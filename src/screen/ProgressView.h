@@ -0,0 +1,58 @@
+#ifndef PROGRESS_VIEW_H
+#define PROGRESS_VIEW_H
+
+#include <Arduino.h>
+#include "Adafruit_GFX.h"
+#include "sched/Scheduler.h"
+#include "screen/Font.h"
+#include "screen/Scene.h"
+#include "recipes/PourPlanner.h"
+
+#define PROGRESS_PERIOD 100      // ms; also the countdown's resolution
+#define PROGRESS_COUNTDOWN_X 220
+#define PROGRESS_COUNTDOWN_Y 12
+#define PROGRESS_TOP 50          // First bar row
+#define PROGRESS_ROW_PITCH 22    // POUR_MAX_STEPS rows still fit the screen
+#define PROGRESS_CAPTION_X 10
+#define PROGRESS_CAPTION_W 100
+#define PROGRESS_BAR_X 115
+#define PROGRESS_BAR_W 195
+#define PROGRESS_BAR_H 16
+
+/**
+ * Live view of a pour: a bar per planned step, filled by how long its pump
+ * has actually run, and a countdown to the last stop. begin() draws the
+ * captions and empty bars; after that each tick pushes only the columns
+ * newly filled and the countdown characters that changed, a few hundred
+ * bytes at most.
+ */
+class ProgressView
+{
+public:
+    ProgressView(Adafruit_SPITFT *tft);
+
+    // Without a planner (a single test pour) only the countdown is shown
+    void begin(const PourPlanner *planner, uint32_t totalMillis);
+    void stop();
+    void redraw(); // The screen was cleared under it: same pour, same countdown
+    bool running() const { return scheduler.pending(task); }
+    Rect bounds() const; // Everything begin() and the ticks draw on
+
+    uint32_t pixelsPushed = 0; // By ticks, since begin()
+
+private:
+    Adafruit_SPITFT *tft;
+    const PourPlanner *planner = nullptr;
+    FontRenderer font;
+    TaskHandle task = TASK_NONE;
+    uint32_t deadline = 0; // Countdown end when there is no planner
+    uint8_t bars = 0;
+    uint8_t filled[POUR_MAX_STEPS]; // Columns already filled inside each bar
+    char shown[4];                  // Countdown characters on screen: "12.3"
+
+    static void onTick(void *context);
+    void tick();
+    void drawCountdown(uint32_t millisLeft);
+};
+
+#endif // PROGRESS_VIEW_H
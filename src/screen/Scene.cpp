@@ -0,0 +1,326 @@
+#include <Arduino.h>
+#include <util/crc16.h>
+#include "Adafruit_ILI9341.h"
+#include "screen/Scene.h"
+#include "sched/BusArbiter.h"
+
+// Per-window overhead on the ILI9341: CASET + 4, PASET + 4, RAMWR
+#define WINDOW_BYTES 11
+// The classic 5x7 GFX font lights about 17 cells per glyph, each plotted as
+// its own size x size rectangle
+#define GLYPH_LIT_CELLS 17
+
+Scene::Scene(Adafruit_SPITFT *tft, uint16_t background)
+{
+    this->tft = tft;
+    this->background = background;
+    reset();
+}
+
+void Scene::reset()
+{
+    for (uint8_t i = 0; i < SCENE_MAX_WIDGETS; ++i)
+    {
+        widgets[i].kind = WIDGET_NONE;
+        widgets[i].dirty = false;
+    }
+    dirtyCount = 0;
+}
+
+// The dirty areas are dropped with the rest of the screen; the widgets
+// alone are drawn on the next render
+void Scene::redraw()
+{
+    for (uint8_t i = 0; i < SCENE_MAX_WIDGETS; ++i)
+    {
+        widgets[i].dirty = widgets[i].kind != WIDGET_NONE;
+    }
+    dirtyCount = 0;
+}
+
+void Scene::clear()
+{
+    for (uint8_t i = 0; i < SCENE_MAX_WIDGETS; ++i)
+    {
+        remove(i);
+    }
+}
+
+void Scene::setButton(uint8_t slot, const Button &btn)
+{
+    Widget widget = {{btn.x, btn.y, btn.w, btn.h}, btn.label, btn.color, btn.bg, WIDGET_BUTTON, 2, btn.labelInFlash, false, 0};
+    set(slot, widget);
+}
+
+void Scene::setLabel(uint8_t slot, int16_t x, int16_t y, const char *text, uint16_t color, uint8_t textSize)
+{
+    Widget widget = {{x, y, (int16_t)(strlen(text) * 6 * textSize), (int16_t)(8 * textSize)}, text, color, background, WIDGET_LABEL, textSize, false, false, 0};
+    set(slot, widget);
+}
+
+void Scene::setLabel(uint8_t slot, int16_t x, int16_t y, const __FlashStringHelper *text, uint16_t color, uint8_t textSize)
+{
+    const char *flash = reinterpret_cast<const char *>(text);
+    Widget widget = {{x, y, (int16_t)(strlen_P(flash) * 6 * textSize), (int16_t)(8 * textSize)}, flash, color, background, WIDGET_LABEL, textSize, true, false, 0};
+    set(slot, widget);
+}
+
+void Scene::remove(uint8_t slot)
+{
+    Widget &current = widgets[slot];
+    if (current.kind == WIDGET_NONE)
+        return;
+    invalidate(current.rect);
+    current.kind = WIDGET_NONE;
+    current.dirty = false;
+}
+
+// Text is compared by its hash: the caller's buffer may already hold the
+// new text, so the pointer alone says nothing
+void Scene::set(uint8_t slot, const Widget &widget)
+{
+    Widget &current = widgets[slot];
+    uint16_t hash = textHash(widget);
+    if (current.kind == widget.kind && memcmp(&current.rect, &widget.rect, sizeof(Rect)) == 0 &&
+        current.color == widget.color && current.bg == widget.bg && current.textSize == widget.textSize &&
+        current.textInFlash == widget.textInFlash && current.textHash == hash &&
+        (current.text == widget.text || !widget.textInFlash))
+    {
+        current.text = widget.text;
+        return; // Unchanged, keep what is on screen
+    }
+    remove(slot);
+    current = widget;
+    current.textHash = hash;
+    current.dirty = true;
+}
+
+void Scene::invalidate(const Rect &area)
+{
+    // Fold into an overlapping region so the list stays short
+    for (uint8_t i = 0; i < dirtyCount; ++i)
+    {
+        if (overlaps(dirty[i], area))
+        {
+            dirty[i] = unite(dirty[i], area);
+            return;
+        }
+    }
+    if (dirtyCount < SCENE_MAX_DIRTY)
+    {
+        dirty[dirtyCount++] = area;
+    }
+    else
+    {
+        dirty[dirtyCount - 1] = unite(dirty[dirtyCount - 1], area);
+    }
+}
+
+void Scene::render()
+{
+    bytesLastRender = 0;
+    if (!arbiter.acquire(ARBITER_DISPLAY))
+        return; // Still dirty, drawn by the next render()
+    for (uint8_t d = 0; d < dirtyCount; ++d)
+    {
+        clearUncovered(dirty[d]);
+        for (uint8_t i = 0; i < SCENE_MAX_WIDGETS; ++i)
+        {
+            if (widgets[i].kind != WIDGET_NONE && overlaps(widgets[i].rect, dirty[d]))
+            {
+                widgets[i].dirty = true;
+            }
+        }
+    }
+    dirtyCount = 0;
+
+    for (uint8_t i = 0; i < SCENE_MAX_WIDGETS; ++i)
+    {
+        if (widgets[i].kind != WIDGET_NONE && widgets[i].dirty)
+        {
+            drawWidget(widgets[i]);
+            widgets[i].dirty = false;
+        }
+    }
+    arbiter.release(ARBITER_DISPLAY);
+}
+
+void Scene::drawWidget(const Widget &widget)
+{
+    if (widget.kind == WIDGET_BUTTON)
+    {
+        drawButton(widget);
+        return;
+    }
+    tft->setTextColor(widget.color);
+    tft->setTextSize(widget.textSize);
+    tft->setCursor(widget.rect.x, widget.rect.y);
+    if (widget.textInFlash)
+    {
+        tft->print(reinterpret_cast<const __FlashStringHelper *>(widget.text));
+    }
+    else
+    {
+        tft->print(widget.text);
+    }
+    bytesLastRender += textLength(widget) * GLYPH_LIT_CELLS * (WINDOW_BYTES + 2 * widget.textSize * widget.textSize);
+}
+
+// Border, face and anti-aliased label in one window. Buttons lie wholly on
+// screen, so the window needs no clipping.
+void Scene::drawButton(const Widget &widget)
+{
+    const Rect &r = widget.rect;
+    if (r.x < 0 || r.y < 0 || r.x + r.w > tft->width() || r.y + r.h > tft->height() || r.w < 2 || r.h < 2)
+        return;
+    FontRenderer font(&buttonFont);
+
+    // As many characters as fit inside the border, centred
+    GlyphRuns glyphs[SCENE_MAX_LABEL];
+    int16_t textWidth;
+    uint8_t count = font.layout(widget.text, widget.textInFlash, r.w - 2, glyphs, SCENE_MAX_LABEL, textWidth);
+    int16_t textLeft = (r.w - textWidth) / 2;
+    int16_t textTop = (r.h - font.height()) / 2;
+    uint16_t shades[FONT_LEVELS];
+    FontRenderer::shades(widget.bg, widget.color, shades);
+
+    RunWriter out = {tft, 0, 0};
+    tft->setAddrWindow(r.x, r.y, r.w, r.h);
+    for (int16_t y = 0; y < r.h; ++y)
+    {
+        if (y == 0 || y == r.h - 1)
+        {
+            out.push(ILI9341_WHITE, r.w);
+            continue;
+        }
+        out.push(ILI9341_WHITE, 1);
+        if (count == 0 || y < textTop || y >= textTop + font.height())
+        {
+            out.push(widget.bg, r.w - 2);
+        }
+        else
+        {
+            out.push(widget.bg, textLeft - 1);
+            FontRenderer::row(glyphs, count, shades, out);
+            out.push(widget.bg, r.w - 1 - textLeft - textWidth);
+        }
+        out.push(ILI9341_WHITE, 1);
+    }
+    out.flush();
+    bytesLastRender += WINDOW_BYTES + 2 * (uint32_t)r.w * r.h;
+}
+
+// Fills area with the background except where a button will be drawn over
+// it: the area is cut into bands at the buttons' top and bottom edges, and
+// each band is filled between the buttons that span it
+void Scene::clearUncovered(const Rect &area)
+{
+    Rect covers[SCENE_MAX_WIDGETS];
+    uint8_t coverCount = 0;
+    int16_t edges[2 * SCENE_MAX_WIDGETS + 2];
+    uint8_t edgeCount = 0;
+    edges[edgeCount++] = area.y;
+    edges[edgeCount++] = area.y + area.h;
+    for (uint8_t i = 0; i < SCENE_MAX_WIDGETS; ++i)
+    {
+        const Rect &b = widgets[i].rect;
+        if (widgets[i].kind != WIDGET_BUTTON || !overlaps(b, area))
+            continue;
+        int16_t left = max(b.x, area.x);
+        int16_t top = max(b.y, area.y);
+        int16_t right = min(b.x + b.w, area.x + area.w);
+        int16_t bottom = min(b.y + b.h, area.y + area.h);
+        Rect clipped = {left, top, (int16_t)(right - left), (int16_t)(bottom - top)};
+        covers[coverCount++] = clipped;
+        edges[edgeCount++] = top;
+        edges[edgeCount++] = bottom;
+    }
+    for (uint8_t i = 1; i < edgeCount; ++i)
+    {
+        int16_t e = edges[i];
+        uint8_t j = i;
+        for (; j > 0 && edges[j - 1] > e; --j)
+            edges[j] = edges[j - 1];
+        edges[j] = e;
+    }
+
+    for (uint8_t e = 0; e + 1 < edgeCount; ++e)
+    {
+        int16_t top = edges[e];
+        int16_t bottom = edges[e + 1];
+        if (top == bottom)
+            continue;
+        // Covers spanning this band, left to right, and the gaps between them
+        int16_t spans[2 * SCENE_MAX_WIDGETS];
+        uint8_t spanCount = 0;
+        for (uint8_t c = 0; c < coverCount; ++c)
+        {
+            const Rect &b = covers[c];
+            if (b.y > top || b.y + b.h < bottom)
+                continue;
+            uint8_t j = spanCount++;
+            for (; j > 0 && spans[2 * (j - 1)] > b.x; --j)
+            {
+                spans[2 * j] = spans[2 * (j - 1)];
+                spans[2 * j + 1] = spans[2 * (j - 1) + 1];
+            }
+            spans[2 * j] = b.x;
+            spans[2 * j + 1] = b.x + b.w;
+        }
+        int16_t x = area.x;
+        for (uint8_t c = 0; c <= spanCount; ++c)
+        {
+            int16_t gapEnd = c < spanCount ? spans[2 * c] : area.x + area.w;
+            if (gapEnd > x)
+            {
+                Rect gap = {x, top, (int16_t)(gapEnd - x), (int16_t)(bottom - top)};
+                fillRect(gap, background);
+            }
+            if (c < spanCount)
+                x = max(x, spans[2 * c + 1]);
+        }
+    }
+}
+
+size_t Scene::textLength(const Widget &widget)
+{
+    return widget.textInFlash ? strlen_P(widget.text) : strlen(widget.text);
+}
+
+uint16_t Scene::textHash(const Widget &widget)
+{
+    uint16_t crc = 0xFFFF;
+    for (const char *c = widget.text;; ++c)
+    {
+        char ch = widget.textInFlash ? pgm_read_byte(c) : *c;
+        if (ch == '\0')
+            return crc;
+        crc = _crc_xmodem_update(crc, ch);
+    }
+}
+
+void Scene::fillRect(const Rect &r, uint16_t color)
+{
+    tft->fillRect(r.x, r.y, r.w, r.h, color);
+    int32_t w = min((int32_t)r.x + r.w, (int32_t)tft->width()) - max(r.x, (int16_t)0);
+    int32_t h = min((int32_t)r.y + r.h, (int32_t)tft->height()) - max(r.y, (int16_t)0);
+    if (w > 0 && h > 0)
+    {
+        bytesLastRender += WINDOW_BYTES + 2 * w * h;
+    }
+}
+
+bool Scene::overlaps(const Rect &a, const Rect &b)
+{
+    return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+}
+
+Rect Scene::unite(const Rect &a, const Rect &b)
+{
+    int16_t x = min(a.x, b.x);
+    int16_t y = min(a.y, b.y);
+    int16_t right = max(a.x + a.w, b.x + b.w);
+    int16_t bottom = max(a.y + a.h, b.y + b.h);
+    Rect r = {x, y, (int16_t)(right - x), (int16_t)(bottom - y)};
+    return r;
+}
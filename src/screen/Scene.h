@@ -0,0 +1,90 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+#include <Arduino.h>
+#include "Adafruit_GFX.h"
+#include "screen/Font.h"
+
+#define SCENE_MAX_WIDGETS 10
+#define SCENE_MAX_DIRTY 6
+#define SCENE_MAX_LABEL 16 // Characters drawn on a button; more are cut off
+
+struct Rect
+{
+    int16_t x, y, w, h;
+};
+
+struct Button
+{
+    int16_t x, y, w, h;
+    const char *label;
+    uint16_t color, bg;
+    uint8_t action;    // ActionId dispatched when pressed
+    uint8_t arg;       // Action argument, e.g. recipe or pump index
+    bool labelInFlash; // label points into PROGMEM
+};
+
+enum WidgetKind
+{
+    WIDGET_NONE,
+    WIDGET_BUTTON, // Opaque: filled background, border, centred label in buttonFont
+    WIDGET_LABEL   // Transparent text in the classic GFX font on the scene background
+};
+
+struct Widget
+{
+    Rect rect;
+    const char *text;
+    uint16_t color, bg;
+    uint8_t kind;
+    uint8_t textSize;
+    bool textInFlash;
+    bool dirty;
+    uint16_t textHash; // Of the text when set, as callers rewrite their buffers in place
+};
+
+/**
+ * Retained-mode scene for the menus and status text.
+ *
+ * Widgets live in numbered slots and are only redrawn when they change.
+ * Removing or moving a widget marks its old area dirty; render() clears the
+ * parts of the dirty areas that no button covers and redraws the widgets
+ * that changed or were touched by a clear, all in one pass. A button goes
+ * out through a single address window, streamed row by row as runs.
+ */
+class Scene
+{
+public:
+    Scene(Adafruit_SPITFT *tft, uint16_t background);
+
+    void reset();  // Screen was cleared externally, nothing retained is on it
+    void redraw(); // Screen was cleared externally, everything retained goes back on
+    void clear();
+    void setButton(uint8_t slot, const Button &btn);
+    void setLabel(uint8_t slot, int16_t x, int16_t y, const char *text, uint16_t color, uint8_t textSize);
+    void setLabel(uint8_t slot, int16_t x, int16_t y, const __FlashStringHelper *text, uint16_t color, uint8_t textSize);
+    void remove(uint8_t slot);
+    void invalidate(const Rect &area);
+    void render();
+
+    uint32_t bytesLastRender = 0; // SPI bytes pushed by the last render()
+
+private:
+    Adafruit_SPITFT *tft;
+    uint16_t background;
+    Widget widgets[SCENE_MAX_WIDGETS];
+    Rect dirty[SCENE_MAX_DIRTY];
+    uint8_t dirtyCount = 0;
+
+    void set(uint8_t slot, const Widget &widget);
+    void drawWidget(const Widget &widget);
+    void drawButton(const Widget &widget);
+    void clearUncovered(const Rect &area);
+    static size_t textLength(const Widget &widget);
+    static uint16_t textHash(const Widget &widget);
+    void fillRect(const Rect &r, uint16_t color);
+    static bool overlaps(const Rect &a, const Rect &b);
+    static Rect unite(const Rect &a, const Rect &b);
+};
+
+#endif // SCENE_H
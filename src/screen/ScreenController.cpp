@@ -2,17 +2,30 @@
 #include "Adafruit_GFX.h"
 #include "Adafruit_ILI9341.h"
 #include "ScreenController.h"
+#include "telemetry/Telemetry.h"
+#include "sched/BusArbiter.h"
+#include "sched/PerfStats.h"
 #include <XPT2046_Touchscreen.h>
 
-#define DEBUG_TOUCH true
-
-ScreenController::ScreenController(int8_t tftCsPin, int8_t dcPin, int8_t rstPin, int8_t touchCSPin, LEDController *ledCtrl, PumpController *pump1, PumpController *pump2, ServoController *servoCtrl)
-    : tft(Adafruit_ILI9341(tftCsPin, dcPin, rstPin)), ts(touchCSPin)
+#define DEBUG_TOUCH true // Circle at every accepted touch; the touch log is TELEMETRY_LEVEL_DEBUG
+
+#define SCREEN_UI_PERIOD 10 // Touch polling and state handling (ms)
+#define BLINK_DURATION 200
+#define ACTIVE_TIMEOUT 5000
+#define FINISHED_HOLD_TIME 5000 // Before returning to IDLE when no order is waiting
+#define ORDER_STRIP_Y 200       // Order buttons shown while a drink pours
+#define ORDER_STRIP_H 40
+#define LINK_PUMPS_PER_REPLY 2  // LINK_PUMP_STATE entries per frame
+
+ScreenController::ScreenController(int8_t tftCsPin, int8_t dcPin, int8_t rstPin, int8_t touchCSPin, int8_t touchIrqPin, LEDController *ledCtrl, PumpController *pumps, ServoController *servoCtrl)
+    : tft(tftCsPin, dcPin, rstPin), ts(touchCSPin), touch(&ts, touchIrqPin), eyeRenderer(&tft), scene(&tft, ILI9341_BLACK), progress(&tft),
+#if PERF_STATS
+      perfView(&tft),
+#endif
+      planner(pumps)
 {
     this->ledController = ledCtrl;
-    this->pump1 = pump1;
-    this->pump2 = pump2;
-    // this->pump3 = pump3;
+    this->pumps = pumps;
     this->servoController = servoCtrl;
 
     pinMode(tftCsPin, OUTPUT);
@@ -20,34 +33,47 @@ ScreenController::ScreenController(int8_t tftCsPin, int8_t dcPin, int8_t rstPin,
     pinMode(touchCSPin, OUTPUT);
     digitalWrite(touchCSPin, HIGH); // Deselect touch
 
-    // Initialize Regular Menu Buttons
-    regularMenuButtons[0] = {0, 0, 170, 200, "Vod (Dbl)+Cran", ILI9341_WHITE, ILI9341_RED};
-    regularMenuButtons[1] = {170, 0, 170, 200, "Vod (Dbl)", ILI9341_BLUE, ILI9341_WHITE};
-    regularMenuButtons[2] = {0, 200, 340, 40, "Test", ILI9341_WHITE, ILI9341_GREEN};
-
-    // Test Menu Buttons
-    testMenuButtons[0] = {20, 30, 70, 50, "P1", ILI9341_WHITE, ILI9341_CYAN};
-    testMenuButtons[1] = {100, 30, 70, 50, "P2", ILI9341_WHITE, ILI9341_MAGENTA};
-    testMenuButtons[2] = {20, 90, 70, 50, "Servo", ILI9341_WHITE, ILI9341_ORANGE};
-    testMenuButtons[3] = {100, 90, 70, 50, "LEDS", ILI9341_WHITE, ILI9341_PURPLE};
-    testMenuButtons[4] = {20, 150, 230, 50, "Back...", ILI9341_WHITE, ILI9341_RED};
+    static_assert(PUMP_COUNT >= 2, "The test menu has buttons for pumps 1 and 2");
 }
 
-// Animation state variables
-int16_t eye_x = 80;
-int16_t eye_y = 80;
-int8_t eye_dx = 3;
-int8_t eye_dy = 2;
-bool isBlinking = false;
-uint32_t blinkStartTime = 0;
-uint32_t nextBlinkTime = 0;
-
-// Store previous eye position
-int16_t prev_eye_x = eye_x;
-int16_t prev_eye_y = eye_y;
+// A recipe some reservoir can't cover is greyed out; pressing it is refused
+static void greyIfDry(Button &btn, const OrderQueue &waiting)
+{
+    if (inventory.dryPump(btn.arg, waiting) < PUMP_COUNT)
+    {
+        btn.color = ILI9341_LIGHTGREY;
+        btn.bg = ILI9341_DARKGREY;
+    }
+}
 
-ScreenState screenState = IDLE;
-ScreenState lastScreenState = IDLE;
+// Lays out the current page of the recipe table: up to four drinks in the
+// top 200 px, then Test (and More... when there are several pages) below
+void ScreenController::buildRegularMenu()
+{
+    uint8_t recipeCount = Recipes::count();
+    uint8_t pageCount = (recipeCount + RECIPES_PER_PAGE - 1) / RECIPES_PER_PAGE;
+    if (recipePage >= pageCount)
+    {
+        recipePage = 0;
+    }
+    uint8_t first = recipePage * RECIPES_PER_PAGE;
+    uint8_t onPage = min(recipeCount - first, (int)RECIPES_PER_PAGE);
+    uint8_t cols = onPage > 1 ? 2 : 1;
+    uint8_t rows = onPage > 2 ? 2 : 1;
+    int16_t w = 320 / cols;
+    int16_t h = 200 / rows;
+
+    menuButtonCount = 0;
+    for (uint8_t i = 0; i < onPage; ++i)
+    {
+        Recipe recipe;
+        Recipes::read(first + i, recipe);
+        Button &btn = menuButtons[menuButtonCount++];
+        btn = {(int16_t)((i % cols) * w), (int16_t)((i / cols) * h), w, h, Recipes::label(first + i), recipe.color, recipe.bg, ACTION_POUR_RECIPE, (uint8_t)(first + i), true};
+        greyIfDry(btn, orders);
+    }
+    menuButtonCount += Menus::read(pageCount > 1 ? MENU_NAV_PAGED : MENU_NAV, menuButtons + menuButtonCount);
+}
 
 // Calibration values (adjust for your hardware)
 #define TS_MINX 200
@@ -65,400 +91,773 @@ int16_t ScreenController::mapTouchY(int16_t rawY)
     return constrain(map(rawY, TS_MINY, TS_MAXY, 0, tft.height() - 1), 0, tft.height() - 1);
 }
 
+// The calibration page from flash, with the selected run and its volume
+void ScreenController::buildCalibrationMenu()
+{
+    snprintf_P(calValueText, sizeof(calValueText), PSTR("%u ml"), calMl[calRun]);
+    menuButtonCount = Menus::read(MENU_CALIBRATE, menuButtons);
+    for (uint8_t i = 0; i < menuButtonCount; ++i)
+    {
+        if (menuButtons[i].action == ACTION_CAL_RUN && menuButtons[i].arg == calRun)
+            menuButtons[i].bg = ILI9341_ORANGE;
+    }
+    menuButtons[SLOT_CAL_VALUE].label = calValueText;
+}
+
+// Cold start, once from setup(): the panel's init sequence, touch and the
+// tasks. Returning to IDLE after a drink only takes warmReset()
 void ScreenController::begin()
 {
-    tft.begin();
+    initDisplay();
+    scene.reset();
     ts.begin();
     ts.setRotation(1);  // Match screen orientation
+    touch.begin();
+    arbiter.begin(&tft);
+    serialLink.setHandler(onLinkMessage, this);
+    uiTask = scheduler.every(SCREEN_UI_PERIOD, onUiTimer, this);
+#if SCREEN_HEALTH_PERIOD
+    // A panel whose MISO isn't wired reads 0x00 or 0xFF; there's nothing
+    // to check then, so it is left alone rather than reset every period
+    uint8_t mode = tft.readcommand8(ILI9341_RDMODE);
+    if (mode == SCREEN_HEALTHY_MODE)
+    {
+        healthTask = scheduler.every(SCREEN_HEALTH_PERIOD, onHealthCheck, this, SCREEN_HEALTH_PERIOD);
+    }
+    else
+    {
+        TELEMETRY(DISPLAY_UNCHECKED, mode);
+    }
+#endif
+
+    screenState = IDLE;
+    startIdleAnimation();
+    warmReset();
+}
+
+// The ILI9341 init sequence, about 270 ms of resets and wake-up delays,
+// and a cleared screen in landscape
+void ScreenController::initDisplay()
+{
+    tft.begin(); // At DISPLAY_SPI_HZ
     tft.setRotation(3); // Landscape mode
-    nextUpdateTime = millis();
-    nextBlinkTime = millis() + random(2000, 5000); // Blink every 2-5 seconds
     tft.fillScreen(ILI9341_BLACK);
-    screenState = IDLE;
+}
 
-    // Set initial active menu
-    activeMenuButtons = regularMenuButtons;
-    numActiveMenuButtons = REGULAR_BUTTON_COUNT;
+// Back to where begin() leaves the menus and the eye, without touching the
+// panel: what is on it is already right
+void ScreenController::warmReset()
+{
+    currentMenu = REGULAR;
+    recipePage = 0;
+    buildRegularMenu();
+    resetEye();
 }
 
-void ScreenController::drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color)
+void ScreenController::resetEye()
 {
-    tft.drawCircle(x0, y0, r, color);
+    eye_x = EYE_TO_FIXED(tft.width() / 2);
+    eye_y = EYE_TO_FIXED(tft.height() / 2);
+    eye_dx = EYE_DX;
+    eye_dy = EYE_DY;
 }
 
-void ScreenController::showRegularMenu()
+void ScreenController::onHealthCheck(void *context)
 {
-    tft.fillScreen(ILI9341_BLACK);
+    PERF_SCOPE(PERF_SCREEN);
+    static_cast<ScreenController *>(context)->checkDisplay();
+}
 
-    for (int i = 0; i < REGULAR_BUTTON_COUNT; ++i)
+// RDMODE reads 0x9C while the panel is awake and showing; after a reset
+// (a brown-out, a loose connector) it is back in sleep with the display
+// off. Only then is the panel initialised again and the screen redrawn
+void ScreenController::checkDisplay()
+{
+    if (!arbiter.acquire(ARBITER_DISPLAY))
+    {
+        return; // Checked next period
+    }
+    uint8_t mode = tft.readcommand8(ILI9341_RDMODE); // Its own transaction, inside the slot
+    arbiter.release(ARBITER_DISPLAY);
+    if (mode == SCREEN_HEALTHY_MODE)
     {
-        Button &btn = regularMenuButtons[i];
-        drawButton(btn.x, btn.y, btn.w, btn.h, btn.label, btn.color, btn.bg, true);
+        return;
     }
+
+    uint32_t start = millis();
+    initDisplay();
+    scene.redraw();
+    eyeRenderer.reset(); // The next frame draws the whole eye
+    arbiter.acquire(ARBITER_DISPLAY);
+    renderScene();
+    arbiter.release(ARBITER_DISPLAY);
+    if (progress.running())
+    {
+        progress.redraw();
+    }
+#if PERF_STATS
+    if (perfView.running())
+    {
+        perfView.begin();
+    }
+#endif
+    TELEMETRY(DISPLAY_FAULT, mode, millis() - start);
 }
 
-void ScreenController::showTestMenu()
+void ScreenController::onUiTimer(void *context)
 {
-    tft.fillScreen(ILI9341_BLACK);
+    PERF_SCOPE(PERF_SCREEN);
+    static_cast<ScreenController *>(context)->update();
+}
+
+void ScreenController::onEyeTimer(void *context)
+{
+    PERF_SCOPE(PERF_EYE);
+    static_cast<ScreenController *>(context)->moveEye();
+}
+
+void ScreenController::onBlinkTimer(void *context)
+{
+    PERF_SCOPE(PERF_EYE);
+    static_cast<ScreenController *>(context)->toggleBlink();
+}
+
+void ScreenController::onStateTimer(void *context)
+{
+    ScreenController *self = static_cast<ScreenController *>(context);
+    self->stateTask = TASK_NONE;
+    self->screenState = self->nextScreenStateValue;
+}
+
+void ScreenController::onNextOrder(void *context)
+{
+    ScreenController *self = static_cast<ScreenController *>(context);
+    self->orderTask = TASK_NONE;
+    self->startNextOrder();
+}
+
+// Test menu: the servo swings back open once it has closed
+void ScreenController::onServoTestClosed(void *context)
+{
+    static_cast<ScreenController *>(context)->servoController->open();
+}
+
+void ScreenController::onActiveTimeout(void *context)
+{
+    ScreenController *self = static_cast<ScreenController *>(context);
+    self->activeTimeoutTask = TASK_NONE;
+    if (self->screenState != ACTIVE)
+    {
+        return;
+    }
+    if (self->currentMenu == CALIBRATE || self->currentMenu == PERF)
+    {
+        // Measuring takes longer than the timeout, and the Perf page is
+        // there to be watched; stay until Save or Back
+        self->activeTimeoutTask = scheduler.after(ACTIVE_TIMEOUT, onActiveTimeout, self);
+        return;
+    }
+    TELEMETRY(ACTIVE_TIMEOUT, millis() - self->lastTouchEventTime);
+    // No good touch for 5 seconds, go back to IDLE
+    self->screenState = IDLE;
+    self->resetEye();
+}
+
+void ScreenController::setStateAfter(ScreenState state, uint32_t delayMillis)
+{
+    nextScreenStateValue = state;
+    scheduler.cancel(stateTask);
+    stateTask = scheduler.after(delayMillis, onStateTimer, this);
+}
+
+void ScreenController::startIdleAnimation()
+{
+    isBlinking = false;
+    eyeRenderer.reset(); // Entering IDLE always follows a full clear
+    scheduler.cancel(eyeTask);
+    scheduler.cancel(blinkTask);
+    eyeTask = scheduler.every(EYE_FRAME_PERIOD, onEyeTimer, this);
+    blinkTask = scheduler.after(random(2000, 5000), onBlinkTimer, this); // Blink every 2-5 seconds
+}
+
+void ScreenController::stopIdleAnimation()
+{
+    scheduler.cancel(eyeTask);
+    scheduler.cancel(blinkTask);
+    isBlinking = false;
+}
 
-    for (int i = 0; i < TEST_BUTTON_COUNT; ++i)
+void ScreenController::moveEye()
+{
+    eye_x += eye_dx;
+    eye_y += eye_dy;
+    if (eye_x < EYE_TO_FIXED(EYE_RADIUS) || eye_x > EYE_TO_FIXED(tft.width() - EYE_RADIUS))
+        eye_dx = -eye_dx;
+    if (eye_y < EYE_TO_FIXED(EYE_RADIUS) || eye_y > EYE_TO_FIXED(tft.height() - EYE_RADIUS))
+        eye_dy = -eye_dy;
+    // Only the crescents that changed are pushed; nothing if the whole-pixel position didn't move
+    eyeRenderer.draw(EYE_FROM_FIXED(eye_x), EYE_FROM_FIXED(eye_y), isBlinking);
+
+    if (TELEMETRY_ENABLED(EYE_PIXELS) && eyeRenderer.frames % 100 == 0 && eyeRenderer.pixelsLastFrame != 0)
     {
-        Button &btn = testMenuButtons[i];
-        drawButton(btn.x, btn.y, btn.w, btn.h, btn.label, btn.color, btn.bg, true);
+        TELEMETRY(EYE_PIXELS, eyeRenderer.pixelsLastFrame, eyeRenderer.pixelsTotal / eyeRenderer.frames);
     }
 }
 
+void ScreenController::toggleBlink()
+{
+    isBlinking = !isBlinking;
+    eyeRenderer.draw(EYE_FROM_FIXED(eye_x), EYE_FROM_FIXED(eye_y), isBlinking);
+    // Blink lasts 200ms, then the next one comes 2-5 seconds later
+    blinkTask = scheduler.after(isBlinking ? BLINK_DURATION : random(2000, 5000), onBlinkTimer, this);
+}
+
+void ScreenController::drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color)
+{
+    tft.drawCircle(x0, y0, r, color);
+}
+
 void ScreenController::showMenu()
 {
-    tft.fillScreen(ILI9341_BLACK);
+    pressedButton = -1; // Indices refer to the old menu
     if (currentMenu == REGULAR)
     {
-        showRegularMenu();
+        buildRegularMenu();
+    }
+    else if (currentMenu == TEST)
+    {
+        menuButtonCount = Menus::read(MENU_TEST, menuButtons);
+    }
+    else if (currentMenu == PERF)
+    {
+        menuButtonCount = Menus::read(MENU_PERF, menuButtons);
     }
     else
     {
-        showTestMenu();
+        buildCalibrationMenu();
+    }
+    for (int i = 0; i < SLOT_STATUS; ++i)
+    {
+        if (i < menuButtonCount)
+        {
+            scene.setButton(i, menuButtons[i]);
+        }
+        else
+        {
+            scene.remove(i);
+        }
+    }
+    if (currentMenu == CALIBRATE)
+    {
+        scene.setLabel(SLOT_STATUS, 20, 8, calTitle, ILI9341_WHITE, 2);
+    }
+    else
+    {
+        scene.remove(SLOT_STATUS);
+    }
+    if (currentMenu != PERF)
+    {
+        hidePerfView();
     }
+    renderScene();
+#if PERF_STATS
+    if (currentMenu == PERF)
+    {
+        perfView.begin(); // Over the background the render left
+    }
+#endif
 }
 
-void ScreenController::update()
+// The Perf page draws outside the scene, which must clear it on leaving
+void ScreenController::hidePerfView()
 {
-    // uint8_t x = tft.readcommand8(ILI9341_RDMODE);
-    // if (x != 0x05)
-    // {
-    //     begin();
-    // }
-    if (nextScreenStateTime != 0 && millis() >= nextScreenStateTime)
+#if PERF_STATS
+    if (perfView.running())
     {
-        screenState = nextScreenStateValue;
-        nextScreenStateTime = 0;
+        perfView.stop();
+        scene.invalidate(perfView.bounds());
     }
+#endif
+}
+
+void ScreenController::renderScene()
+{
+    uint32_t start = micros();
+    scene.render();
+    TELEMETRY(SCREEN_RENDER, scene.bytesLastRender, micros() - start);
+}
+
+void ScreenController::update()
+{
     if (screenState != lastScreenState)
     {
-        tft.fillScreen(ILI9341_BLACK);
+        // Only what differs between the two states is redrawn, once, and
+        // all of it in one SPI transaction
+        arbiter.acquire(ARBITER_DISPLAY);
+        pressedButton = -1;
+        if (lastScreenState == IDLE)
+        {
+            // Cleared with the scene, and only where the new screen leaves
+            // background: a full menu covers it and the erase costs nothing
+            Rect eye = eyeRenderer.bounds();
+            if (eye.w > 0)
+            {
+                scene.invalidate(eye);
+            }
+            eyeRenderer.reset();
+        }
+        if (lastScreenState == DISPENSING)
+        {
+            progress.stop();
+            scene.invalidate(progress.bounds());
+        }
+        if (lastScreenState == ACTIVE)
+        {
+            hidePerfView();
+        }
         if (screenState == IDLE)
         {
-            this->ledController->mode = IDLE_LEDS;
+            this->ledController->setMode(IDLE_LEDS);
+            scene.clear();
+            startIdleAnimation();
+        }
+        else
+        {
+            stopIdleAnimation();
         }
         if (screenState == ACTIVE)
         {
             showMenu();
+            scheduler.cancel(activeTimeoutTask);
+            activeTimeoutTask = scheduler.after(ACTIVE_TIMEOUT, onActiveTimeout, this);
+        }
+        else
+        {
+            scheduler.cancel(activeTimeoutTask);
+        }
+        if (screenState == DISPENSING)
+        {
+            showOrderStrip();
+            showDispensingStatus();
         }
         if (screenState == FINISHED)
         {
-            this->nextScreenStateValue = IDLE;
-            this->nextScreenStateTime = millis() + 5000; // After 15
+            showOrderStrip(); // Unchanged, so not redrawn
+            scene.setLabel(SLOT_STATUS, 80, tft.height() / 2 - 10, F("Finished!"), ILI9341_GREEN, 3);
             this->servoController->open();
+            if (orders.served())
+            {
+                TELEMETRY(ORDER_STATS, orders.stats.served, orders.drinksPerHour(), orders.stats.maxWaitMillis);
+            }
+            if (orders.empty())
+            {
+                setStateAfter(IDLE, FINISHED_HOLD_TIME);
+            }
+            else
+            {
+                scheduleNextOrder();
+            }
+        }
+        if (screenState != ACTIVE)
+        {
+            renderScene(); // ACTIVE rendered by showMenu()
         }
-        if (lastScreenState == FINISHED)
+        if (screenState == DISPENSING)
         {
-            begin(); // Reset to initial state
+            progress.begin(dispenseSource, dispenseMillis);
+        }
+        arbiter.release(ARBITER_DISPLAY);
+        if (lastScreenState == FINISHED && screenState == IDLE)
+        {
+            warmReset(); // The clear above has already put the idle screen up
         }
         lastScreenState = screenState;
     }
-    if (screenState == IDLE)
+    // The panel is only read while T_IRQ says it is touched; events are
+    // handled against the screen actually shown, so stop at a state change
+    touch.service();
+    TouchEvent event;
+    while (screenState == lastScreenState && touch.poll(event))
+    {
+        handleTouch(event);
+    }
+    // Orders from the menu, or over the link, start once the screen has
+    // settled; a calibration run has the pumps until it is left
+    if (!orders.empty() && screenState == lastScreenState &&
+        (screenState == IDLE || (screenState == ACTIVE && currentMenu != CALIBRATE)))
     {
-        if (ts.touched() && !isPhantomTouch(ts.getPoint().x, ts.getPoint().y, ts.getPoint().z))
+        startNextOrder();
+    }
+}
+
+void ScreenController::handleButtonPress(const Button &btn)
+{
+    switch (btn.action)
+    {
+    case ACTION_POUR_RECIPE:
+        queueOrder(btn.arg);
+        break;
+    case ACTION_NEXT_PAGE:
+        ++recipePage; // Wraps in buildRegularMenu()
+        showMenu();
+        break;
+    case ACTION_TEST_MENU:
+        currentMenu = TEST;
+        showMenu();
+        break;
+    case ACTION_BACK:
+        currentMenu = REGULAR;
+        showMenu();
+        break;
+    case ACTION_TEST_PUMP:
+    {
+        uint32_t runtime = this->pumps[btn.arg].dispenseVolume(50); // Dispense 50 mL for testing
+        beginDispense(runtime);
+        break;
+    }
+    case ACTION_TEST_SERVO:
+        this->servoController->close(onServoTestClosed, this);
+        break;
+    case ACTION_TEST_LEDS:
+        if (this->ledController->mode == DISPENSING_LEDS)
         {
-            screenState = ACTIVE;
-            return;
+            this->ledController->setMode(FINISHED_LEDS);
         }
-        // Move eye
-        if (millis() >= nextUpdateTime)
+        else if (this->ledController->mode == FINISHED_LEDS)
         {
-            // Erase previous eye by drawing over it with background color
-            drawEye(prev_eye_x, prev_eye_y, false, ILI9341_BLACK);
-            prev_eye_x = eye_x;
-            prev_eye_y = eye_y;
-            eye_x += eye_dx;
-            eye_y += eye_dy;
-            if (eye_x < 60 || eye_x > tft.width() - 60)
-                eye_dx = -eye_dx;
-            if (eye_y < 60 || eye_y > tft.height() - 60)
-                eye_dy = -eye_dy;
-            drawEye(eye_x, eye_y, isBlinking, ILI9341_WHITE);
-            nextUpdateTime = millis() + 100; // Smooth movement
+            this->ledController->setMode(IDLE_LEDS);
         }
-        // Handle blinking
-        if (!isBlinking && millis() >= nextBlinkTime)
+        else
         {
-            isBlinking = true;
-            blinkStartTime = millis();
-            drawEye(eye_x, eye_y, true, ILI9341_WHITE);
+            this->ledController->setMode(DISPENSING_LEDS);
         }
-        if (isBlinking && millis() - blinkStartTime > 200)
-        { // Blink lasts 200ms
-            isBlinking = false;
-            nextBlinkTime = millis() + random(2000, 5000);
-            drawEye(eye_x, eye_y, false, ILI9341_WHITE);
+        TELEMETRY(LED_MODE, this->ledController->mode);
+        break;
+    case ACTION_CALIBRATE:
+        startCalibration(btn.arg);
+        break;
+#if PERF_STATS
+    case ACTION_PERF_MENU:
+        currentMenu = PERF;
+        showMenu();
+        break;
+    case ACTION_PERF_RESET:
+        perf.reset(); // The next refresh takes the bars down
+        break;
+#endif
+    case ACTION_CAL_RUN:
+        calRun = btn.arg;
+        if (!this->pumps[calPump].busy()) // Pressing again mid-run must not restart it
+        {
+            PumpController &pump = this->pumps[calPump];
+            if (calRun == 2)
+                pump.pourFor(pump.profile.primeMillis + PUMP_CAL_TRICKLE_RUN_MILLIS, PUMP_CAL_TRICKLE_RUN_MILLIS);
+            else
+                pump.pourFor(calRun ? PUMP_CAL_LONG_RUN_MILLIS : PUMP_CAL_SHORT_RUN_MILLIS);
         }
+        showMenu();
+        break;
+    case ACTION_CAL_ADJUST:
+        if (btn.arg)
+            ++calMl[calRun];
+        else if (calMl[calRun] > 0)
+            --calMl[calRun];
+        showMenu();
+        break;
+    case ACTION_CAL_SAVE:
+        saveCalibration();
+        break;
+    case ACTION_REFILL:
+        inventory.refillAll(); // Recipes come back on the next menu
+        break;
     }
-    else if (screenState == ACTIVE)
-    {
-        if (ts.touched())
-        {
-            TS_Point p = ts.getPoint();
-            // Map touch coordinates to pixels
-            int16_t tx = mapTouchX(p.x);
-            int16_t ty = mapTouchY(p.y);
+}
 
-            if (isPhantomTouch(tx, ty, p.z))
-            {
-                // Ignore phantom touch
-                return;
-            }
+// Seeds the runs with what the current profile predicts, so measuring
+// only means correcting the difference. The trickle run primes at full
+// drive first, with the priming time in force when it is pressed.
+void ScreenController::startCalibration(uint8_t pump)
+{
+    calPump = pump;
+    calRun = 0;
+    const PumpController &controller = this->pumps[pump];
+    calMl[0] = controller.volumeMl(PUMP_CAL_SHORT_RUN_MILLIS);
+    calMl[1] = controller.volumeMl(PUMP_CAL_LONG_RUN_MILLIS);
+    calMl[2] = controller.profile.trickleMsPerMlQ8 ? controller.volumeMl(controller.profile.primeMillis + PUMP_CAL_TRICKLE_RUN_MILLIS, PUMP_CAL_TRICKLE_RUN_MILLIS) : 0;
+    snprintf_P(calTitle, sizeof(calTitle), PSTR("Calibrate pump %u"), pump + 1);
+    currentMenu = CALIBRATE;
+    scene.remove(SLOT_STATUS);
+    showMenu();
+}
 
-            Button *menuButtons = (currentMenu == REGULAR) ? regularMenuButtons : testMenuButtons;
-            int numMenuButtons = (currentMenu == REGULAR) ? REGULAR_BUTTON_COUNT : TEST_BUTTON_COUNT;
-            for (int i = 0; i < numMenuButtons; ++i)
-            {
-                Button &btn = menuButtons[i];
-                if (tx >= btn.x && tx < btn.x + btn.w && ty >= btn.y && ty < btn.y + btn.h)
-                {
-                    // Button pressed
-                    Serial.print("Button pressed: ");
-                    Serial.println(btn.label);
-                    handleButtonPress(i);
-                }
-            }
-        }
+void ScreenController::saveCalibration()
+{
+    PumpProfile profile = this->pumps[calPump].profile; // Keeps the trickle duty and volume
+    if (!PumpCalibration::fit(calMl[0], calMl[1], profile) || !PumpCalibration::fitTrickle(calMl[2], profile))
+    {
+        TELEMETRY(CAL_REJECTED);
+        scene.setLabel(SLOT_STATUS, 20, 8, F("Check volumes"), ILI9341_RED, 2);
+        renderScene();
+        return;
+    }
+    this->pumps[calPump].profile = profile;
+    PumpCalibration::save(calPump, profile);
+    TELEMETRY(PUMP_CALIBRATED, calPump + 1, profile.primeMillis, profile.msPerMlQ8);
+    TELEMETRY(PUMP_TRICKLE, calPump + 1, profile.trickleDuty, profile.trickleMsPerMlQ8);
+    currentMenu = TEST;
+    showMenu();
+}
 
-        uint32_t durationSinceLastGoodTouch = millis() - lastGoodTouchTime;
-        if (durationSinceLastGoodTouch > 5000)
+// The recipes of the page last shown, along the bottom, so the next drinks
+// can be ordered while one pours. Left out if the progress bars need the room.
+void ScreenController::showOrderStrip()
+{
+    uint8_t rows = dispenseSource ? dispenseSource->stepCount() : 0;
+    uint8_t count = 0;
+    if (PROGRESS_TOP + rows * PROGRESS_ROW_PITCH <= ORDER_STRIP_Y)
+    {
+        uint8_t first = recipePage * RECIPES_PER_PAGE;
+        count = min(Recipes::count() - first, (int)RECIPES_PER_PAGE);
+        int16_t w = count ? tft.width() / count : 0;
+        for (uint8_t i = 0; i < count; ++i)
         {
-            Serial.println("No touch detected for 5 seconds, returning to IDLE mode. Last good touch time: " + String(lastGoodTouchTime) + ", now: " + String(millis()) + ", duration: " + String(durationSinceLastGoodTouch) + "ms");
-            // No good touch for 10 seconds, go back to IDLE
-            screenState = IDLE;
-            tft.fillScreen(ILI9341_BLACK);
-            // Reset eye position
-            eye_x = tft.width() / 2;
-            eye_y = tft.height() / 2;
-            prev_eye_x = eye_x;
-            prev_eye_y = eye_y;
-            eye_dx = 3;
-            eye_dy = 2;
-            isBlinking = false;
-            nextBlinkTime = millis() + random(2000, 5000);
-            return;
+            Recipe recipe;
+            Recipes::read(first + i, recipe);
+            menuButtons[i] = {(int16_t)(i * w), ORDER_STRIP_Y, w, ORDER_STRIP_H, Recipes::label(first + i), recipe.color, recipe.bg, ACTION_POUR_RECIPE, (uint8_t)(first + i), true};
+            greyIfDry(menuButtons[i], orders);
         }
     }
-    else if (screenState == DISPENSING)
+    for (int i = 0; i < SLOT_STATUS; ++i)
+    {
+        if (i < count)
+        {
+            scene.setButton(i, menuButtons[i]);
+        }
+        else
+        {
+            scene.remove(i);
+        }
+    }
+    pressedButton = -1;
+    menuButtonCount = count;
+}
+
+void ScreenController::showDispensingStatus()
+{
+    if (orders.empty())
     {
-        tft.fillScreen(ILI9341_BLACK);
-        tft.setTextColor(ILI9341_WHITE);
-        tft.setTextSize(3);
-        tft.setCursor(60, tft.height() / 2 - 10);
-        tft.print("Dispensing...");
+        strcpy_P(statusText, PSTR("Dispensing..."));
     }
-    else if (screenState == FINISHED)
+    else
     {
-        tft.fillScreen(ILI9341_BLACK);
-        tft.setTextColor(ILI9341_GREEN);
-        tft.setTextSize(3);
-        tft.setCursor(80, tft.height() / 2 - 10);
-        tft.print("Finished!");
+        snprintf_P(statusText, sizeof(statusText), PSTR("Dispensing (+%u)"), orders.depth());
     }
+    scene.setLabel(SLOT_STATUS, 10, 14, statusText, ILI9341_WHITE, 2);
 }
 
-void ScreenController::drawEye(int16_t x, int16_t y, bool blink, uint16_t bg)
+// Orders wait their turn; update() starts one when nothing is pouring. A
+// screen change still pending picks the queue up itself.
+bool ScreenController::queueOrder(uint8_t recipeIndex)
 {
-    tft.fillCircle(x, y, 60, bg); // Erase or draw white part
-    if (blink)
+    uint8_t dry = inventory.dryPump(recipeIndex, orders);
+    if (dry < PUMP_COUNT)
+    {
+        TELEMETRY(RECIPE_BLOCKED, recipeIndex, dry + 1, inventory.remainingMl(dry));
+        return false;
+    }
+    if (!orders.push(recipeIndex))
+    {
+        TELEMETRY(ORDER_REFUSED, recipeIndex);
+        return false;
+    }
+    TELEMETRY(ORDER_QUEUED, recipeIndex, orders.depth());
+    if (screenState != lastScreenState)
     {
-        tft.fillRect(x - 60, y - 10, 120, 20, ILI9341_BLACK);
+        return true;
     }
-    else if (bg == ILI9341_WHITE)
+    if (screenState == FINISHED && !scheduler.pending(orderTask))
     {
-        tft.fillCircle(x, y, 30, ILI9341_BLACK); // Pupil
+        scheduleNextOrder(); // Ordered during the hold, the cup is already out
     }
+    else if (screenState == DISPENSING)
+    {
+        showDispensingStatus();
+        renderScene();
+    }
+    return true;
 }
 
-void ScreenController::drawButton(int16_t x, int16_t y, int16_t w, int16_t h, const char *label, uint16_t color, uint16_t bg, bool hasBorder)
+// The next drink starts as soon as the servo has released the finished
+// cup, and its lines are primed while that happens
+void ScreenController::scheduleNextOrder()
 {
-    tft.fillRect(x, y, w, h, bg);            // Button background
-    tft.drawRect(x, y, w, h, ILI9341_WHITE); // Button border
-    tft.setTextColor(color);
-    tft.setTextSize(2);
-    int16_t textX = x + (w - (strlen(label) * 12)) / 2; // Center text
-    int16_t textY = y + (h - 16) / 2;
-    tft.setCursor(textX, textY);
-    tft.print(label);
+    uint32_t gap = this->servoController->millisLeft();
+    scheduler.cancel(stateTask); // No return to IDLE in between
+    planner.prime(orders.next(), gap);
+    orderTask = scheduler.after(gap, onNextOrder, this);
 }
 
-void ScreenController::handleButtonPress(int idx)
+void ScreenController::startNextOrder()
 {
-    if (currentMenu == REGULAR)
-    {
-        Button &btn = regularMenuButtons[idx];
-        if (strcmp(btn.label, "Vod (Dbl)+Cran") == 0)
-        { // Start button
-            Serial.println("Dispensing drink 1...");
-            screenState = DISPENSING;
-            this->servoController->close();
-            this->ledController->mode = DISPENSING_LEDS;
-
-            uint32_t runTimePump2 = this->pump2->dispenseVolume(50); // Dispense 100 mL for drink 1 after 2 seconds
-            uint32_t runTimePump1 = this->pump1->dispenseVolume(150, runTimePump2 + 300);               // Dispense 250 mL for drink 1
-            // uint32_t runTimePump3 = this->pump3->dispenseVolume(50, runTimePump1 + 300 + runTimePump2 + 300);  // Dispense 50 mL for drink 1 after 4 seconds
-
-            uint32_t totalDispenseTime = runTimePump1 + runTimePump2 + 300; // + runTimePump3 + 600; // Total time including delays
+    uint32_t waitMillis;
+    uint8_t recipeIndex = orders.pop(waitMillis);
+    TELEMETRY(ORDER_STARTED, recipeIndex, waitMillis);
+    pourRecipe(recipeIndex);
+}
 
-            this->ledController->nextUpdateMode = FINISHED_LEDS;
-            this->nextScreenStateValue = FINISHED;
-            this->ledController->nextUpdateTime = millis() + totalDispenseTime; // After dispense seconds, switch mode
-            this->nextScreenStateTime = millis() + totalDispenseTime;           // After dispense seconds
-        }
-        else if (strcmp(btn.label, "Vod (Dbl)") == 0)
-        { // Start button
-            Serial.println("Dispensing drink 2...");
-            screenState = DISPENSING;
-            this->servoController->close();
-            this->ledController->mode = DISPENSING_LEDS;
+void ScreenController::pourRecipe(uint8_t recipeIndex)
+{
+    uint32_t totalDispenseTime = planner.pour(recipeIndex);
+    TELEMETRY(POUR, recipeIndex, totalDispenseTime);
+    beginDispense(totalDispenseTime, &planner);
+}
 
-            uint32_t runTimePump2 = this->pump2->dispenseVolume(50); // Dispense 50 mL of Vodka
+void ScreenController::beginDispense(uint32_t totalDispenseTime, const PourPlanner *source)
+{
+    screenState = DISPENSING;
+    dispenseSource = source;
+    dispenseMillis = totalDispenseTime;
+    this->servoController->close();
+    this->ledController->setMode(DISPENSING_LEDS);
+    this->ledController->setModeAfter(FINISHED_LEDS, totalDispenseTime); // After dispense seconds, switch mode
+    setStateAfter(FINISHED, totalDispenseTime);                           // After dispense seconds
+}
 
-            uint32_t totalDispenseTime = runTimePump2; // + runTimePump3 + 600; // Total time including delays
+uint8_t ScreenController::onLinkMessage(void *context, uint8_t message, const uint8_t *args, uint8_t argCount, uint8_t *data, uint8_t &dataLength)
+{
+    return static_cast<ScreenController *>(context)->handleLinkMessage(message, args, argCount, data, dataLength);
+}
 
-            this->ledController->nextUpdateMode = FINISHED_LEDS;
-            this->nextScreenStateValue = FINISHED;
-            this->ledController->nextUpdateTime = millis() + totalDispenseTime; // After dispense seconds, switch mode
-            this->nextScreenStateTime = millis() + totalDispenseTime;           // After dispense seconds
-        }
-        else if (strcmp(btn.label, "Test") == 0)
-        { // Test button
-            currentMenu = TEST;
-            showMenu();
+// Remote orders join the same queue as the order strip
+uint8_t ScreenController::handleLinkMessage(uint8_t message, const uint8_t *args, uint8_t argCount, uint8_t *data, uint8_t &dataLength)
+{
+    static_assert(1 + LINK_PUMPS_PER_REPLY * 13 <= LINK_MAX_DATA, "LINK_PUMP_STATE reply too long");
+    uint8_t *out = data;
+    switch (message)
+    {
+    case LINK_ORDER:
+        if (argCount != 1 || args[0] >= Recipes::count())
+            return LINK_BAD_ARGS;
+        if (!queueOrder(args[0]))
+            return LINK_REFUSED;
+        *out++ = orders.depth();
+        break;
+    case LINK_PUMP_STATE:
+    {
+        // A page of pumps from the first asked for, so any PUMP_COUNT fits
+        uint8_t first = argCount ? args[0] : 0;
+        if (argCount > 1 || first > PUMP_COUNT)
+            return LINK_BAD_ARGS;
+        *out++ = PUMP_COUNT;
+        for (uint8_t i = first; i < PUMP_COUNT && i < first + LINK_PUMPS_PER_REPLY; ++i)
+        {
+            const PumpController &pump = this->pumps[i];
+            *out++ = pump.busy();
+            out = SerialLink::put32(out, pump.millisLeft());
+            out = SerialLink::put32(out, pump.dispensedMl);
+            out = SerialLink::put16(out, pump.profile.primeMillis);
+            out = SerialLink::put16(out, pump.profile.msPerMlQ8);
         }
+        break;
     }
-    else if (currentMenu == TEST)
+    case LINK_INVENTORY:
     {
-        Button &btn = testMenuButtons[idx];
-        if (strcmp(btn.label, "Back...") == 0)
-        { // T1 button
-            Serial.println("Back to Regular Menu");
-            currentMenu = REGULAR;
-            showMenu();
-        }
-        else if (strcmp(btn.label, "P1") == 0)
-        { // T1 button
-            Serial.println("Pump 1 selected");
-            screenState = DISPENSING;
-            this->servoController->close();
-            this->ledController->mode = DISPENSING_LEDS;
-            uint32_t runtime = this->pump1->dispenseVolume(50);                       // Dispense 200 mL for testing
-            this->ledController->nextUpdateMode = FINISHED_LEDS;
-            this->nextScreenStateValue = FINISHED;
-            this->ledController->nextUpdateTime = millis() + runtime; // After 10 seconds, switch mode
-            this->nextScreenStateTime = millis() + runtime;           // After 10 seconds
+        if (argCount == 3)
+        {
+            uint16_t capacityMl = args[1] | (uint16_t)args[2] << 8;
+            if (args[0] >= PUMP_COUNT || capacityMl == 0)
+                return LINK_BAD_ARGS;
+            inventory.refill(args[0], capacityMl);
+            break;
         }
-        else if (strcmp(btn.label, "P2") == 0)
-        { // T2 button
-            Serial.println("Pump 2 selected");
-            screenState = DISPENSING;
-            this->servoController->close();
-            this->ledController->mode = DISPENSING_LEDS;
-            uint32_t runtime = this->pump2->dispenseVolume(50);                       // Dispense 200 mL for testing
-            this->ledController->nextUpdateMode = FINISHED_LEDS;
-            this->nextScreenStateValue = FINISHED;
-            this->ledController->nextUpdateTime = millis() + runtime; // After 10 seconds, switch mode
-            this->nextScreenStateTime = millis() + runtime;           // After 10 seconds
+        uint8_t first = argCount ? args[0] : 0;
+        if (argCount > 1 || first > PUMP_COUNT)
+            return LINK_BAD_ARGS;
+        *out++ = PUMP_COUNT;
+        for (uint8_t i = first; i < PUMP_COUNT && i < first + LINK_PUMPS_PER_REPLY; ++i)
+        {
+            const Inventory::Reservoir &reservoir = inventory.reservoir(i);
+            out = SerialLink::put32(out, reservoir.pouredMl);
+            out = SerialLink::put32(out, reservoir.pours);
+            out = SerialLink::put16(out, inventory.remainingMl(i));
+            out = SerialLink::put16(out, reservoir.capacityMl);
         }
-        else if (strcmp(btn.label, "Servo") == 0)
-        { // Servo button
-            Serial.println("Servo test selected");
-            this->servoController->close();
-            delay(1000);
-            this->servoController->open();
+        break;
+    }
+    case LINK_LEDS:
+        if (argCount == 2)
+        {
+            if (!this->ledController->setLength(args[0] | (uint16_t)args[1] << 8))
+                return LINK_BAD_ARGS;
         }
-        else if (strcmp(btn.label, "LEDS") == 0)
-        { // LEDS button
-            Serial.println("LEDs test selected");
-            if (this->ledController->mode == DISPENSING_LEDS)
-            {
-                Serial.println("Switching to FINISHED_LEDS mode");
-                this->ledController->mode = FINISHED_LEDS;
-            }
-            else if (this->ledController->mode == FINISHED_LEDS)
-            {
-                Serial.println("Switching to IDLE_LEDS mode");
-                this->ledController->mode = IDLE_LEDS;
-            }
-            else
-            {
-                Serial.println("Switching to DISPENSING_LEDS mode");
-                this->ledController->mode = DISPENSING_LEDS;
-            }
-        };
+        else if (argCount != 0)
+            return LINK_BAD_ARGS;
+        out = SerialLink::put16(out, this->ledController->length());
+        out = SerialLink::put16(out, LED_CAPACITY);
+        break;
+    case LINK_ORDER_STATE:
+        *out++ = screenState;
+        *out++ = orders.depth();
+        out = SerialLink::put16(out, orders.stats.served);
+        out = SerialLink::put16(out, orders.drinksPerHour());
+        out = SerialLink::put32(out, orders.stats.maxWaitMillis);
+        *out++ = orders.stats.maxDepth;
+        break;
+    default:
+        return LINK_UNKNOWN;
     }
+    dataLength = out - data;
+    return LINK_OK;
 }
 
-bool ScreenController::isPhantomTouch(int16_t tx, int16_t ty, uint16_t pressure)
+// Buttons act on release, and only if the finger lifts on the button it
+// went down on, so the touch that wakes the screen never presses anything
+void ScreenController::handleTouch(const TouchEvent &event)
 {
+    lastTouchEventTime = millis();
+    scheduler.reschedule(activeTimeoutTask, ACTIVE_TIMEOUT);
+    int16_t tx = mapTouchX(event.x);
+    int16_t ty = mapTouchY(event.y);
 
-    // Phantom touch filtering
-    /**
-     * It's likely to be a phantom touch if:
-     * - The touch position is far away from the last touch position
-     * - The touch pressure is low
-     * - The touch is very brief
-     *
-     * Therefore, we ignore touches that are:
-     * - More than 50 pixels away from last touch
-     * - Pressure below 1500
-     * - Duration less than 50ms
-     */
-    if (pressure < 1200)
+    if (event.type == TOUCH_PRESS)
     {
-        return true; // Ignore light touches
-    }
-
-    if (pressure > 2400)
-    {
-        if (DEBUG_TOUCH)
+        TELEMETRY(TOUCH_PRESS, tx, ty, event.z);
+        if (screenState == IDLE)
         {
-            Serial.println("Ignored touch due to overly hard pressure");
+            screenState = ACTIVE;
+            return;
         }
-        return true; // Ignore overly hard touches
-    }
-    if (millis() - this->lastTouchTime > 200)
-    {
-        if (DEBUG_TOUCH)
+        if (DEBUG_TOUCH && screenState == ACTIVE && currentMenu != PERF)
         {
-            Serial.println("Ignored touch due to brief duration: " + String(millis() - lastTouchTime) + "ms");
+            // Draw debug circle at every touch
+            tft.drawCircle(tx, ty, 10, ILI9341_RED);
+            Rect marker = {(int16_t)(tx - 10), (int16_t)(ty - 10), 21, 21};
+            scene.invalidate(marker); // Cleaned up by the next render
         }
-        this->lastTouchTime = millis();
-        return true; // Ignore very brief touches
+        pressedButton = buttonAt(tx, ty);
     }
-    this->lastTouchTime = millis();
-    if (lastTouch.x != -1 && lastTouch.y != -1)
+    else if (event.type == TOUCH_RELEASE)
     {
-        int16_t dx = abs(tx - lastTouch.x);
-        int16_t dy = abs(ty - lastTouch.y);
-        if (dx > 50 || dy > 50)
+        TELEMETRY(TOUCH_RELEASE, tx, ty);
+        if (screenState != IDLE && pressedButton >= 0 && buttonAt(tx, ty) == pressedButton)
         {
-            if (DEBUG_TOUCH)
-            {
-                Serial.println("Ignored touch due to large movement: " + String(dx) + "px, " + String(dy) + "px");
-            }
-            lastTouch.x = tx;
-            lastTouch.y = ty;
-            return true; // Ignore touches far from last touch
+            Button btn = menuButtons[pressedButton]; // The press may rebuild the menu
+            TELEMETRY(BUTTON, btn.action, btn.arg);
+            handleButtonPress(btn);
         }
+        pressedButton = -1;
     }
-    lastTouch.x = tx;
-    lastTouch.y = ty;
+}
 
-    if (DEBUG_TOUCH)
+int8_t ScreenController::buttonAt(int16_t tx, int16_t ty)
+{
+    for (uint8_t i = 0; i < menuButtonCount; ++i)
     {
-        Serial.print("Touch coords: X=");
-        Serial.print(tx);
-        Serial.print(", Y=");
-        Serial.print(ty);
-        Serial.print(" Pressure=");
-        Serial.println(pressure);
-        // Draw debug circle at every touch
-        tft.drawCircle(tx, ty, 10, ILI9341_RED);
+        const Button &btn = menuButtons[i];
+        if (tx >= btn.x && tx < btn.x + btn.w && ty >= btn.y && ty < btn.y + btn.h)
+        {
+            return i;
+        }
     }
-    this->lastGoodTouchTime = millis();
-    return false; // Valid touch
-}
\ No newline at end of file
+    return -1;
+}
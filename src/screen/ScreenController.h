@@ -6,8 +6,31 @@
 #include "Adafruit_ILI9341.h"
 #include <XPT2046_Touchscreen.h>
 #include "leds/LEDController.h"
-#include "pump/PumpController.h"
+#include "pump/PumpBank.h"
 #include "servo/ServoController.h"
+#include "sched/Scheduler.h"
+#include "screen/DisplayBatcher.h"
+#include "screen/EyeRenderer.h"
+#include "screen/Scene.h"
+#include "screen/Menus.h"
+#include "screen/ProgressView.h"
+#include "screen/PerfView.h"
+#include "touch/TouchPipeline.h"
+#include "recipes/Recipes.h"
+#include "recipes/PourPlanner.h"
+#include "recipes/Inventory.h"
+#include "recipes/OrderQueue.h"
+#include "link/SerialLink.h"
+
+#define EYE_FRAME_PERIOD 33 // ~30 fps
+#define EYE_DX 16           // 1 px per frame, 30 px/s as before
+#define EYE_DY 11           // ~0.7 px per frame, 20 px/s as before
+
+// Display health check: RDMODE is read back this often (ms), 0 for never
+#ifndef SCREEN_HEALTH_PERIOD
+#define SCREEN_HEALTH_PERIOD 5000
+#endif
+#define SCREEN_HEALTHY_MODE 0x9C // RDMODE: booster on, sleep out, normal mode, display on
 
 enum ScreenState
 {
@@ -19,86 +42,132 @@ enum ScreenState
 enum MenuType
 {
     REGULAR,
-    TEST
-};
-
-struct Button
-{
-    int16_t x, y, w, h;
-    const char *label;
-    uint16_t color, bg;
-};
-
-struct TouchPoint
-{
-    int16_t x;
-    int16_t y;
+    TEST,
+    CALIBRATE,
+    PERF
 };
 
 class ScreenController
 {
 public:
-    ScreenController(int8_t screenCSPin, int8_t dcPin, int8_t rstPin, int8_t touchCSPin, LEDController *ledCtrl, PumpController *pump1, PumpController *pump2, ServoController *servoCtrl);
+    ScreenController(int8_t screenCSPin, int8_t dcPin, int8_t rstPin, int8_t touchCSPin, int8_t touchIrqPin, LEDController *ledCtrl, PumpController *pumps, ServoController *servoCtrl);
     void begin();
     void update();
+    const OrderQueue &orderQueue() const { return orders; }
+    ScreenState state() const { return screenState; }
+    const Button *menu(uint8_t &count) const { count = menuButtonCount; return menuButtons; } // What touches are tested against
 
 private:
-    Adafruit_ILI9341 tft;
+    DisplayBatcher tft;
     XPT2046_Touchscreen ts;
+    TouchPipeline touch;
+    EyeRenderer eyeRenderer;
+    Scene scene;
+    ProgressView progress;
+#if PERF_STATS
+    PerfView perfView;
+#endif
     LEDController *ledController;
-    PumpController *pump1;  
-    PumpController *pump2;
-    PumpController *pump3;
+    PumpController *pumps; // PUMP_COUNT of them, in recipe order
+    PourPlanner planner;
+    OrderQueue orders;
     ServoController *servoController;
 
-    // Animation state variables
-    uint32_t nextUpdateTime;
-    int16_t eye_x = 80;
-    int16_t eye_y = 80;
-    int8_t eye_dx = 3;
-    int8_t eye_dy = 2;
+    // Scheduled tasks
+    TaskHandle uiTask = TASK_NONE;
+    TaskHandle eyeTask = TASK_NONE;
+    TaskHandle blinkTask = TASK_NONE;
+    TaskHandle stateTask = TASK_NONE;
+    TaskHandle activeTimeoutTask = TASK_NONE;
+    TaskHandle orderTask = TASK_NONE;
+    TaskHandle healthTask = TASK_NONE;
+
+    // Animation state variables, positions and speeds in 1/16 px (see EyeRenderer.h)
+    int16_t eye_x = EYE_TO_FIXED(80);
+    int16_t eye_y = EYE_TO_FIXED(80);
+    int8_t eye_dx = EYE_DX;
+    int8_t eye_dy = EYE_DY;
     bool isBlinking = false;
-    uint32_t blinkStartTime = 0;
-    uint32_t nextBlinkTime = 0;
-    int16_t prev_eye_x = 80;
-    int16_t prev_eye_y = 80;
 
     // Screen state variables
     MenuType currentMenu = REGULAR;
     ScreenState screenState = IDLE; // Start in IDLE mode
     ScreenState lastScreenState = IDLE;
-    uint32_t nextScreenStateTime = 0;
     ScreenState nextScreenStateValue = IDLE;
 
     // --- Menu Management Members ---
-    static const int REGULAR_BUTTON_COUNT = 3; // Define array size
-    static const int TEST_BUTTON_COUNT = 5;    // Define array size
+    static const int RECIPES_PER_PAGE = 4; // 2x2 grid above the bottom row
+    static_assert(RECIPES_PER_PAGE + 2 <= MENU_MAX_BUTTONS, "A recipe page and its bottom row share the menu buffer");
+
+    // The menu currently on screen, used for hit testing: a fixed menu
+    // copied from flash, a page of the recipe table, or the order strip
+    Button menuButtons[MENU_MAX_BUTTONS];
+    uint8_t menuButtonCount = 0;
+    uint8_t recipePage = 0;
 
-    // The predefined button arrays
-    Button regularMenuButtons[REGULAR_BUTTON_COUNT];
-    Button testMenuButtons[TEST_BUTTON_COUNT];
+    // Calibration page state: the pump, which of the three runs is selected
+    // and the volume measured for each
+    uint8_t calPump = 0;
+    uint8_t calRun = 0;
+    uint16_t calMl[3];
+    char calTitle[20];
+    char calValueText[12];
 
-    // Pointers to the currently active menu array and its size - IDK what this does yet
-    Button *activeMenuButtons;
-    int numActiveMenuButtons;
+    // What the progress view follows once DISPENSING is on screen
+    const PourPlanner *dispenseSource = nullptr;
+    uint32_t dispenseMillis = 0;
+    char statusText[20];
 
-    TouchPoint lastTouch = {-1, -1};
-    uint32_t lastTouchTime = 0;
-    uint32_t lastGoodTouchTime = 0;
+    int8_t pressedButton = -1; // Button the current touch went down on
+    uint32_t lastTouchEventTime = 0;
+
+    // Task callbacks
+    static void onUiTimer(void *context);
+    static void onEyeTimer(void *context);
+    static void onBlinkTimer(void *context);
+    static void onStateTimer(void *context);
+    static void onActiveTimeout(void *context);
+    static void onNextOrder(void *context);
+    static void onHealthCheck(void *context);
+    static void onServoTestClosed(void *context);
+    static uint8_t onLinkMessage(void *context, uint8_t message, const uint8_t *args, uint8_t argCount, uint8_t *data, uint8_t &dataLength);
+
+    // Scene slots: menu buttons first, then the status line
+    static const uint8_t SLOT_STATUS = SCENE_MAX_WIDGETS - 1;
+    static const uint8_t SLOT_CAL_VALUE = 3;
+    static_assert(MENU_MAX_BUTTONS <= SLOT_STATUS, "Menu buttons are drawn into slots 0 to MENU_MAX_BUTTONS - 1, short of the status line");
 
     // Private methods
-    void drawText(int16_t x, int16_t y, const char *text, uint16_t color, uint8_t size);
+    void initDisplay();
+    void warmReset();
+    void resetEye();
+    void checkDisplay();
+    void startIdleAnimation();
+    void stopIdleAnimation();
+    void moveEye();
+    void toggleBlink();
+    void setStateAfter(ScreenState state, uint32_t delayMillis);
+    void buildRegularMenu();
+    void buildCalibrationMenu();
+    void startCalibration(uint8_t pump);
+    void saveCalibration();
     void showMenu();
-    void showRegularMenu();
-    void showTestMenu();
+    void hidePerfView();
+    void renderScene();
     void drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color);
-    void drawEye(int16_t x, int16_t y, bool blink, uint16_t bg);
-    void drawButton(int16_t x, int16_t y, int16_t w, int16_t h, const char *label, uint16_t color, uint16_t bg, bool hasBorder);
-    void handleButtonPress(int idx);
+    void handleButtonPress(const Button &btn);
+    void showOrderStrip();
+    void showDispensingStatus();
+    bool queueOrder(uint8_t recipeIndex);
+    void scheduleNextOrder();
+    void startNextOrder();
+    void pourRecipe(uint8_t recipeIndex);
+    void beginDispense(uint32_t totalDispenseTime, const PourPlanner *source = nullptr);
     int16_t mapTouchX(int16_t rawX);
     int16_t mapTouchY(int16_t rawY);
-
-    bool isPhantomTouch(int16_t tx, int16_t ty, uint16_t pressure);
+    void handleTouch(const TouchEvent &event);
+    uint8_t handleLinkMessage(uint8_t message, const uint8_t *args, uint8_t argCount, uint8_t *data, uint8_t &dataLength);
+    int8_t buttonAt(int16_t tx, int16_t ty);
 };
 
 #endif // SCREENCONTROLLER_H
\ No newline at end of file
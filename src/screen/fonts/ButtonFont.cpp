@@ -0,0 +1,417 @@
+// Generated by tools/font_rasterize.py from DejaVuSans-Bold.ttf at 15 px; do not edit.
+#include <Arduino.h>
+#include "screen/Font.h"
+
+static const uint8_t buttonFontData[] PROGMEM = {
+    0x3F, 0x0F, 0x08, 0xC1, 0x80, 0x03, 0xC1, 0x80, 0x03, 0xC1, 0x80, 0x03, 0xC1, 0x80, 0x03, 0xC1,
+    0x80, 0x03, 0x80, 0xC0, 0x80, 0x03, 0x80, 0xC0, 0x80, 0x04, 0x40, 0x04, 0x81, 0x40, 0x03, 0xC1,
+    0x80, 0x03, 0xC1, 0x80, 0x1D, 0x08, 0x80, 0xC0, 0x41, 0xC0, 0x80, 0x01, 0x80, 0xC0, 0x41, 0xC0,
+    0x80, 0x01, 0x80, 0xC0, 0x41, 0xC0, 0x80, 0x01, 0x80, 0xC0, 0x41, 0xC0, 0x80, 0x02, 0x40, 0x01,
+    0x40, 0x3F, 0x11, 0x11, 0x80, 0x40, 0x00, 0x40, 0x80, 0x06, 0x40, 0xC0, 0x40, 0x00, 0x80, 0xC0,
+    0x06, 0x80, 0xC0, 0x01, 0xC0, 0x80, 0x03, 0x40, 0xC8, 0x80, 0x02, 0x81, 0xC0, 0x82, 0xC0, 0x81,
+    0x40, 0x03, 0x40, 0xC0, 0x40, 0x00, 0x80, 0xC0, 0x04, 0x82, 0xC0, 0x81, 0xC1, 0x80, 0x40, 0x02,
+    0xC8, 0x80, 0x02, 0x41, 0xC0, 0x80, 0x40, 0x80, 0xC0, 0x42, 0x03, 0x40, 0xC0, 0x40, 0x00, 0x80,
+    0xC0, 0x06, 0x80, 0xC0, 0x01, 0xC0, 0x80, 0x38, 0x04, 0x40, 0x07, 0x40, 0x80, 0x06, 0x81, 0xC0,
+    0x81, 0x40, 0x01, 0x40, 0xC5, 0x80, 0x01, 0x80, 0xC0, 0x80, 0x40, 0x80, 0x00, 0x41, 0x01, 0x80,
+    0xC0, 0x80, 0x40, 0x80, 0x04, 0x80, 0xC3, 0x81, 0x03, 0x40, 0x80, 0xC4, 0x04, 0x40, 0x80, 0x40,
+    0xC1, 0x40, 0x00, 0x40, 0x01, 0x40, 0x80, 0x00, 0xC1, 0x40, 0x00, 0x80, 0xC0, 0x81, 0xC0, 0x80,
+    0xC1, 0x01, 0x40, 0x80, 0xC3, 0x80, 0x40, 0x04, 0x40, 0x80, 0x07, 0x40, 0x80, 0x08, 0x40, 0x0D,
+    0x09, 0x41, 0x03, 0x80, 0xC2, 0x40, 0x02, 0x40, 0xC0, 0x40, 0x02, 0x40, 0xC0, 0x80, 0x00, 0xC1,
+    0x02, 0xC0, 0x80, 0x03, 0x80, 0xC0, 0x40, 0x00, 0x80, 0xC0, 0x40, 0x00, 0x80, 0xC0, 0x40, 0x03,
+    0x80, 0xC0, 0x40, 0x00, 0x80, 0xC0, 0x40, 0x00, 0xC0, 0x80, 0x05, 0xC0, 0x81, 0xC1, 0x00, 0x80,
+    0xC0, 0x06, 0x40, 0x82, 0x00, 0x40, 0xC0, 0x40, 0x00, 0x82, 0x40, 0x06, 0xC0, 0x80, 0x00, 0x80,
+    0xC0, 0x80, 0xC1, 0x05, 0x80, 0xC0, 0x00, 0x40, 0xC0, 0x80, 0x00, 0x40, 0xC0, 0x80, 0x04, 0xC0,
+    0x80, 0x00, 0x40, 0xC0, 0x80, 0x00, 0x40, 0xC0, 0x80, 0x03, 0x80, 0xC0, 0x02, 0xC1, 0x00, 0x80,
+    0xC0, 0x40, 0x02, 0x40, 0xC0, 0x40, 0x02, 0x40, 0xC2, 0x80, 0x03, 0x41, 0x05, 0x40, 0x2F, 0x0F,
+    0x40, 0xC3, 0x80, 0x05, 0x40, 0xC2, 0x82, 0x05, 0x80, 0xC1, 0x40, 0x08, 0x40, 0xC1, 0x80, 0x08,
+    0x40, 0xC2, 0x80, 0x02, 0x81, 0x01, 0x40, 0xC1, 0x80, 0xC1, 0x40, 0x00, 0x80, 0xC0, 0x80, 0x01,
+    0xC1, 0x80, 0x00, 0x80, 0xC1, 0x40, 0xC1, 0x80, 0x01, 0xC1, 0x80, 0x01, 0x80, 0xC3, 0x02, 0xC1,
+    0x80, 0x02, 0xC2, 0x80, 0x02, 0x80, 0xC2, 0x80, 0xC4, 0x40, 0x02, 0x80, 0xC3, 0x80, 0x40, 0xC2,
+    0x04, 0x41, 0x2D, 0x05, 0x80, 0xC0, 0x40, 0x01, 0x80, 0xC0, 0x40, 0x01, 0x80, 0xC0, 0x40, 0x01,
+    0x80, 0xC0, 0x40, 0x02, 0x40, 0x33, 0x02, 0x40, 0x80, 0x40, 0x03, 0xC1, 0x40, 0x02, 0x80, 0xC0,
+    0x80, 0x03, 0xC1, 0x40, 0x02, 0x40, 0xC1, 0x03, 0x80, 0xC1, 0x03, 0x80, 0xC0, 0x80, 0x03, 0x80,
+    0xC0, 0x80, 0x03, 0x80, 0xC0, 0x80, 0x03, 0x40, 0xC1, 0x03, 0x40, 0xC1, 0x40, 0x03, 0x80, 0xC0,
+    0x80, 0x03, 0x40, 0xC1, 0x04, 0x80, 0xC0, 0x40, 0x0E, 0x00, 0x40, 0x80, 0x40, 0x03, 0x40, 0xC1,
+    0x04, 0xC1, 0x40, 0x03, 0x80, 0xC1, 0x03, 0x40, 0xC1, 0x40, 0x03, 0xC1, 0x40, 0x03, 0xC1, 0x80,
+    0x03, 0xC1, 0x80, 0x03, 0xC1, 0x80, 0x03, 0xC1, 0x40, 0x02, 0x40, 0xC1, 0x03, 0x80, 0xC0, 0x80,
+    0x03, 0xC1, 0x40, 0x02, 0x80, 0xC0, 0x80, 0x10, 0x02, 0x40, 0x06, 0x81, 0x02, 0x40, 0x80, 0x00,
+    0x81, 0x00, 0x80, 0x41, 0x80, 0xC3, 0x80, 0x02, 0x80, 0xC1, 0x80, 0x01, 0x40, 0xC0, 0x80, 0xC0,
+    0x80, 0xC1, 0x42, 0x00, 0x81, 0x00, 0x40, 0x03, 0x80, 0x40, 0x3F, 0x02, 0x1E, 0x40, 0x80, 0x0A,
+    0x80, 0xC0, 0x40, 0x09, 0x80, 0xC0, 0x40, 0x09, 0x80, 0xC0, 0x40, 0x05, 0x40, 0x83, 0xC0, 0x83,
+    0x02, 0x80, 0xC8, 0x03, 0x42, 0x80, 0xC0, 0x43, 0x06, 0x80, 0xC0, 0x40, 0x09, 0x80, 0xC0, 0x40,
+    0x09, 0x80, 0xC0, 0x40, 0x38, 0x36, 0x40, 0x81, 0x40, 0x01, 0x80, 0xC1, 0x40, 0x01, 0x80, 0xC1,
+    0x02, 0x80, 0xC0, 0x40, 0x02, 0xC0, 0x80, 0x03, 0x40, 0x09, 0x24, 0x83, 0x41, 0xC3, 0x80, 0x40,
+    0x83, 0x40, 0x29, 0x36, 0x40, 0x81, 0x40, 0x01, 0x80, 0xC1, 0x40, 0x01, 0x80, 0xC1, 0x40, 0x18,
+    0x07, 0x40, 0xC0, 0x02, 0x80, 0xC0, 0x02, 0xC0, 0x80, 0x01, 0x40, 0xC0, 0x40, 0x01, 0x80, 0xC0,
+    0x02, 0xC0, 0x80, 0x02, 0xC0, 0x40, 0x01, 0x40, 0xC0, 0x02, 0x80, 0xC0, 0x02, 0xC0, 0x80, 0x01,
+    0x40, 0xC0, 0x40, 0x01, 0x80, 0xC0, 0x02, 0x80, 0x40, 0x0C, 0x0B, 0x40, 0xC3, 0x80, 0x02, 0x40,
+    0xC2, 0x80, 0xC1, 0x80, 0x01, 0x80, 0xC1, 0x01, 0x80, 0xC1, 0x40, 0x00, 0xC1, 0x80, 0x01, 0x40,
+    0xC1, 0x80, 0x40, 0xC1, 0x80, 0x02, 0xC1, 0x80, 0x40, 0xC1, 0x80, 0x02, 0xC1, 0x80, 0x40, 0xC1,
+    0x80, 0x02, 0xC1, 0x80, 0x00, 0xC1, 0x80, 0x01, 0x40, 0xC1, 0x80, 0x00, 0x80, 0xC1, 0x01, 0x80,
+    0xC1, 0x40, 0x00, 0x40, 0xC2, 0x80, 0xC1, 0x80, 0x02, 0x40, 0xC3, 0x80, 0x05, 0x41, 0x21, 0x0B,
+    0x81, 0xC2, 0x03, 0x40, 0xC4, 0x04, 0x40, 0x00, 0x80, 0xC1, 0x06, 0x80, 0xC1, 0x06, 0x80, 0xC1,
+    0x06, 0x80, 0xC1, 0x06, 0x80, 0xC1, 0x06, 0x80, 0xC1, 0x06, 0x80, 0xC1, 0x03, 0x40, 0xC6, 0x80,
+    0x00, 0x40, 0xC6, 0x80, 0x27, 0x0A, 0x40, 0x80, 0xC3, 0x80, 0x02, 0x80, 0xC1, 0x80, 0xC2, 0x80,
+    0x01, 0x80, 0x40, 0x01, 0x40, 0xC2, 0x06, 0x80, 0xC1, 0x06, 0xC1, 0x80, 0x05, 0x80, 0xC1, 0x40,
+    0x03, 0x40, 0xC2, 0x40, 0x03, 0x40, 0xC1, 0x80, 0x04, 0x40, 0xC1, 0x80, 0x05, 0x80, 0xC6, 0x40,
+    0x00, 0x80, 0xC6, 0x40, 0x27, 0x03, 0x40, 0x05, 0x40, 0xC4, 0x80, 0x02, 0x80, 0xC0, 0x81, 0xC2,
+    0x80, 0x06, 0xC2, 0x06, 0xC2, 0x03, 0x82, 0xC1, 0x40, 0x03, 0xC3, 0x80, 0x40, 0x03, 0x41, 0x80,
+    0xC2, 0x06, 0x80, 0xC1, 0x40, 0x00, 0x40, 0x03, 0x80, 0xC1, 0x40, 0x00, 0xC1, 0x81, 0xC2, 0x80,
+    0x01, 0x80, 0xC4, 0x80, 0x04, 0x42, 0x21, 0x0D, 0x40, 0xC2, 0x40, 0x04, 0xC3, 0x40, 0x03, 0x80,
+    0xC3, 0x40, 0x02, 0x40, 0xC0, 0x81, 0xC1, 0x40, 0x02, 0xC1, 0x00, 0x80, 0xC1, 0x40, 0x01, 0x80,
+    0xC0, 0x40, 0x00, 0x80, 0xC1, 0x40, 0x00, 0x40, 0xC0, 0x80, 0x01, 0x80, 0xC1, 0x40, 0x00, 0x40,
+    0xC7, 0x80, 0x40, 0xC7, 0x80, 0x04, 0x80, 0xC1, 0x40, 0x05, 0x80, 0xC1, 0x40, 0x28, 0x0A, 0x80,
+    0xC5, 0x80, 0x01, 0x80, 0xC5, 0x80, 0x01, 0x80, 0xC0, 0x80, 0x43, 0x02, 0x80, 0xC0, 0x80, 0x42,
+    0x03, 0x80, 0xC5, 0x40, 0x01, 0x80, 0xC0, 0x82, 0xC2, 0x06, 0x80, 0xC1, 0x40, 0x05, 0x80, 0xC1,
+    0x40, 0x00, 0x40, 0x03, 0x80, 0xC1, 0x40, 0x00, 0x80, 0xC0, 0x81, 0xC2, 0x80, 0x01, 0x80, 0xC4,
+    0x80, 0x05, 0x41, 0x21, 0x0C, 0x80, 0xC3, 0x80, 0x02, 0x80, 0xC1, 0x81, 0xC1, 0x01, 0x40, 0xC1,
+    0x40, 0x02, 0x40, 0x01, 0x80, 0xC0, 0x80, 0x00, 0x41, 0x03, 0xC6, 0x40, 0x01, 0xC3, 0x80, 0xC2,
+    0x01, 0xC2, 0x01, 0x40, 0xC1, 0x80, 0x00, 0xC2, 0x02, 0xC1, 0x80, 0x00, 0x80, 0xC1, 0x01, 0x40,
+    0xC1, 0x40, 0x01, 0xC2, 0x80, 0xC2, 0x02, 0x40, 0xC3, 0x80, 0x40, 0x05, 0x40, 0x21, 0x0A, 0xC7,
+    0x40, 0x00, 0xC7, 0x40, 0x00, 0x44, 0xC2, 0x05, 0x40, 0xC1, 0x40, 0x05, 0x80, 0xC1, 0x05, 0x40,
+    0xC1, 0x80, 0x05, 0x80, 0xC1, 0x06, 0xC1, 0x80, 0x05, 0x80, 0xC1, 0x06, 0xC1, 0x80, 0x05, 0x80,
+    0xC1, 0x40, 0x2B, 0x0B, 0x80, 0xC3, 0x80, 0x40, 0x01, 0x80, 0xC1, 0x81, 0xC2, 0x01, 0x80, 0xC1,
+    0x01, 0x80, 0xC1, 0x40, 0x00, 0x80, 0xC1, 0x01, 0x80, 0xC1, 0x01, 0x40, 0xC1, 0x81, 0xC1, 0x80,
+    0x02, 0x80, 0xC3, 0x80, 0x40, 0x01, 0x80, 0xC1, 0x40, 0x00, 0x80, 0xC1, 0x01, 0xC1, 0x80, 0x01,
+    0x40, 0xC1, 0x80, 0x00, 0xC1, 0x80, 0x01, 0x40, 0xC1, 0x80, 0x00, 0x80, 0xC1, 0x81, 0xC2, 0x02,
+    0x80, 0xC4, 0x40, 0x04, 0x41, 0x21, 0x0B, 0x80, 0xC3, 0x40, 0x02, 0x80, 0xC1, 0x81, 0xC1, 0x40,
+    0x01, 0xC1, 0x80, 0x01, 0x80, 0xC1, 0x00, 0x40, 0xC1, 0x80, 0x01, 0x80, 0xC1, 0x41, 0xC1, 0x80,
+    0x01, 0x80, 0xC1, 0x80, 0x00, 0x80, 0xC1, 0x81, 0xC2, 0x80, 0x00, 0x40, 0x80, 0xC5, 0x40, 0x02,
+    0x43, 0xC1, 0x40, 0x05, 0xC2, 0x01, 0x80, 0xC0, 0x81, 0xC2, 0x40, 0x01, 0x40, 0xC3, 0x80, 0x40,
+    0x04, 0x41, 0x22, 0x13, 0x41, 0x02, 0x40, 0xC1, 0x40, 0x01, 0x40, 0xC1, 0x40, 0x01, 0x40, 0x81,
+    0x40, 0x0D, 0x40, 0x81, 0x40, 0x01, 0x40, 0xC1, 0x40, 0x01, 0x40, 0xC1, 0x40, 0x18, 0x13, 0x41,
+    0x02, 0x40, 0xC1, 0x40, 0x01, 0x40, 0xC1, 0x40, 0x01, 0x40, 0x81, 0x40, 0x0D, 0x40, 0x81, 0x40,
+    0x01, 0x40, 0xC1, 0x40, 0x01, 0x40, 0xC1, 0x40, 0x01, 0x80, 0xC0, 0x80, 0x02, 0xC1, 0x03, 0x40,
+    0x09, 0x2F, 0x40, 0x80, 0x07, 0x40, 0x80, 0xC2, 0x04, 0x40, 0x80, 0xC2, 0x80, 0x40, 0x03, 0x40,
+    0xC2, 0x80, 0x40, 0x06, 0x80, 0xC1, 0x80, 0x09, 0x80, 0xC2, 0x80, 0x40, 0x08, 0x40, 0x80, 0xC2,
+    0x80, 0x40, 0x08, 0x40, 0x80, 0xC1, 0x0B, 0x40, 0x35, 0x35, 0x48, 0x02, 0x80, 0xC8, 0x02, 0x40,
+    0x88, 0x0F, 0x80, 0xC8, 0x02, 0x40, 0x88, 0x3F, 0x0F, 0x27, 0x40, 0x80, 0x40, 0x09, 0x80, 0xC2,
+    0x80, 0x40, 0x07, 0x40, 0x80, 0xC2, 0x80, 0x40, 0x08, 0x40, 0x80, 0xC2, 0x80, 0x08, 0x40, 0x80,
+    0xC1, 0x05, 0x40, 0x80, 0xC2, 0x80, 0x40, 0x02, 0x40, 0x80, 0xC2, 0x80, 0x40, 0x05, 0x80, 0xC1,
+    0x80, 0x08, 0x41, 0x3D, 0x09, 0x80, 0xC3, 0x80, 0x02, 0xC1, 0x80, 0xC2, 0x40, 0x01, 0x80, 0x02,
+    0xC1, 0x80, 0x05, 0xC1, 0x80, 0x04, 0x80, 0xC1, 0x40, 0x03, 0x80, 0xC1, 0x40, 0x03, 0x40, 0xC1,
+    0x40, 0x05, 0x41, 0x05, 0x40, 0x81, 0x05, 0x80, 0xC1, 0x40, 0x04, 0x80, 0xC1, 0x40, 0x26, 0x13,
+    0x40, 0x82, 0x40, 0x07, 0x40, 0x80, 0xC1, 0x80, 0xC2, 0x40, 0x04, 0x40, 0xC0, 0x80, 0x40, 0x03,
+    0x80, 0xC0, 0x80, 0x03, 0xC0, 0x80, 0x02, 0x40, 0x02, 0x40, 0xC0, 0x40, 0x01, 0x80, 0xC0, 0x01,
+    0x80, 0xC1, 0x80, 0xC0, 0x80, 0x00, 0x81, 0x01, 0x81, 0x00, 0x40, 0xC0, 0x80, 0x40, 0x80, 0xC0,
+    0x80, 0x00, 0x80, 0xC0, 0x01, 0xC0, 0x40, 0x00, 0x80, 0xC0, 0x02, 0xC0, 0x80, 0x00, 0x80, 0xC0,
+    0x01, 0xC0, 0x40, 0x00, 0x80, 0xC0, 0x02, 0xC0, 0x80, 0x00, 0x81, 0x01, 0xC0, 0x80, 0x00, 0x40,
+    0xC0, 0x80, 0x00, 0x80, 0xC0, 0x80, 0x40, 0xC0, 0x40, 0x01, 0x80, 0xC0, 0x01, 0x80, 0xC5, 0x80,
+    0x03, 0xC0, 0x80, 0x01, 0x41, 0x00, 0x41, 0x05, 0x40, 0xC0, 0x80, 0x04, 0x80, 0x40, 0x05, 0x40,
+    0xC2, 0x80, 0xC2, 0x40, 0x07, 0x40, 0x82, 0x40, 0x13, 0x0F, 0xC2, 0x80, 0x06, 0x40, 0xC3, 0x06,
+    0x80, 0xC3, 0x40, 0x05, 0xC1, 0x80, 0xC1, 0x80, 0x04, 0x80, 0xC1, 0x00, 0x80, 0xC1, 0x04, 0xC1,
+    0x80, 0x00, 0x40, 0xC1, 0x80, 0x02, 0x40, 0xC1, 0x40, 0x01, 0xC2, 0x02, 0x80, 0xC7, 0x40, 0x01,
+    0xC8, 0x80, 0x00, 0x40, 0xC1, 0x40, 0x03, 0x80, 0xC1, 0x00, 0x80, 0xC1, 0x04, 0x40, 0xC1, 0x40,
+    0x2F, 0x0B, 0x80, 0xC4, 0x80, 0x40, 0x02, 0x80, 0xC6, 0x80, 0x01, 0x80, 0xC1, 0x40, 0x00, 0x40,
+    0xC2, 0x01, 0x80, 0xC1, 0x40, 0x01, 0xC2, 0x01, 0x80, 0xC1, 0x81, 0xC2, 0x40, 0x01, 0x80, 0xC6,
+    0x40, 0x01, 0x80, 0xC1, 0x42, 0x80, 0xC1, 0x01, 0x80, 0xC1, 0x40, 0x01, 0x80, 0xC1, 0x40, 0x00,
+    0x80, 0xC1, 0x40, 0x01, 0x80, 0xC1, 0x40, 0x00, 0x80, 0xC7, 0x01, 0x80, 0xC5, 0x80, 0x2D, 0x0D,
+    0x40, 0x80, 0xC3, 0x80, 0x02, 0x80, 0xC6, 0x01, 0x80, 0xC1, 0x80, 0x40, 0x02, 0x80, 0x01, 0xC2,
+    0x06, 0x40, 0xC1, 0x80, 0x06, 0x40, 0xC1, 0x80, 0x06, 0x40, 0xC1, 0x80, 0x07, 0xC2, 0x07, 0x80,
+    0xC1, 0x80, 0x03, 0x80, 0x02, 0x80, 0xC2, 0x80, 0xC2, 0x03, 0x80, 0xC4, 0x80, 0x06, 0x41, 0x23,
+    0x0C, 0x80, 0xC3, 0x81, 0x40, 0x03, 0x80, 0xC6, 0x80, 0x40, 0x01, 0x80, 0xC1, 0x42, 0x80, 0xC1,
+    0x80, 0x01, 0x80, 0xC1, 0x40, 0x02, 0x80, 0xC1, 0x40, 0x00, 0x80, 0xC1, 0x40, 0x02, 0x40, 0xC1,
+    0x80, 0x00, 0x80, 0xC1, 0x40, 0x02, 0x40, 0xC1, 0x80, 0x00, 0x80, 0xC1, 0x40, 0x02, 0x40, 0xC1,
+    0x80, 0x00, 0x80, 0xC1, 0x40, 0x02, 0x80, 0xC1, 0x40, 0x00, 0x80, 0xC1, 0x42, 0x80, 0xC2, 0x01,
+    0x80, 0xC7, 0x40, 0x01, 0x80, 0xC4, 0x80, 0x40, 0x32, 0x0A, 0x80, 0xC6, 0x01, 0x80, 0xC6, 0x01,
+    0x80, 0xC1, 0x44, 0x01, 0x80, 0xC1, 0x40, 0x05, 0x80, 0xC1, 0x84, 0x01, 0x80, 0xC5, 0x80, 0x01,
+    0x80, 0xC1, 0x44, 0x01, 0x80, 0xC1, 0x40, 0x05, 0x80, 0xC1, 0x44, 0x01, 0x80, 0xC6, 0x40, 0x00,
+    0x80, 0xC6, 0x40, 0x27, 0x0A, 0x80, 0xC6, 0x01, 0x80, 0xC6, 0x01, 0x80, 0xC1, 0x44, 0x01, 0x80,
+    0xC1, 0x40, 0x05, 0x80, 0xC1, 0x84, 0x01, 0x80, 0xC5, 0x80, 0x01, 0x80, 0xC1, 0x44, 0x01, 0x80,
+    0xC1, 0x40, 0x05, 0x80, 0xC1, 0x40, 0x05, 0x80, 0xC1, 0x40, 0x05, 0x80, 0xC1, 0x40, 0x2C, 0x0E,
+    0x40, 0x80, 0xC3, 0x80, 0x40, 0x02, 0x80, 0xC6, 0x80, 0x01, 0x80, 0xC1, 0x80, 0x40, 0x02, 0x40,
+    0x80, 0x01, 0xC2, 0x07, 0x40, 0xC1, 0x80, 0x07, 0x40, 0xC1, 0x80, 0x01, 0x40, 0xC3, 0x41, 0xC1,
+    0x80, 0x01, 0x40, 0x80, 0xC2, 0x40, 0x00, 0xC2, 0x03, 0x80, 0xC1, 0x40, 0x00, 0x80, 0xC1, 0x80,
+    0x02, 0x80, 0xC1, 0x40, 0x01, 0x80, 0xC3, 0x80, 0xC2, 0x40, 0x02, 0x80, 0xC4, 0x81, 0x06, 0x41,
+    0x27, 0x0D, 0x80, 0xC1, 0x40, 0x02, 0x80, 0xC1, 0x40, 0x01, 0x80, 0xC1, 0x40, 0x02, 0x80, 0xC1,
+    0x40, 0x01, 0x80, 0xC1, 0x40, 0x02, 0x80, 0xC1, 0x40, 0x01, 0x80, 0xC1, 0x40, 0x02, 0x80, 0xC1,
+    0x40, 0x01, 0x80, 0xC1, 0x83, 0xC2, 0x40, 0x01, 0x80, 0xC8, 0x40, 0x01, 0x80, 0xC1, 0x43, 0x80,
+    0xC1, 0x40, 0x01, 0x80, 0xC1, 0x40, 0x02, 0x80, 0xC1, 0x40, 0x01, 0x80, 0xC1, 0x40, 0x02, 0x80,
+    0xC1, 0x40, 0x01, 0x80, 0xC1, 0x40, 0x02, 0x80, 0xC1, 0x40, 0x01, 0x80, 0xC1, 0x40, 0x02, 0x80,
+    0xC1, 0x40, 0x34, 0x06, 0x80, 0xC1, 0x40, 0x01, 0x80, 0xC1, 0x40, 0x01, 0x80, 0xC1, 0x40, 0x01,
+    0x80, 0xC1, 0x40, 0x01, 0x80, 0xC1, 0x40, 0x01, 0x80, 0xC1, 0x40, 0x01, 0x80, 0xC1, 0x40, 0x01,
+    0x80, 0xC1, 0x40, 0x01, 0x80, 0xC1, 0x40, 0x01, 0x80, 0xC1, 0x40, 0x01, 0x80, 0xC1, 0x40, 0x18,
+    0x06, 0x80, 0xC1, 0x40, 0x01, 0x80, 0xC1, 0x40, 0x01, 0x80, 0xC1, 0x40, 0x01, 0x80, 0xC1, 0x40,
+    0x01, 0x80, 0xC1, 0x40, 0x01, 0x80, 0xC1, 0x40, 0x01, 0x80, 0xC1, 0x40, 0x01, 0x80, 0xC1, 0x40,
+    0x01, 0x80, 0xC1, 0x40, 0x01, 0x80, 0xC1, 0x40, 0x01, 0x80, 0xC1, 0x40, 0x00, 0x40, 0xC2, 0x01,
+    0xC2, 0x80, 0x01, 0xC0, 0x80, 0x40, 0x08, 0x0C, 0x80, 0xC1, 0x40, 0x01, 0x40, 0xC2, 0x40, 0x00,
+    0x80, 0xC1, 0x40, 0x00, 0x40, 0xC2, 0x40, 0x01, 0x80, 0xC1, 0x41, 0xC2, 0x40, 0x02, 0x80, 0xC1,
+    0x40, 0xC2, 0x40, 0x03, 0x80, 0xC4, 0x40, 0x04, 0x80, 0xC3, 0x80, 0x05, 0x80, 0xC4, 0x80, 0x04,
+    0x80, 0xC1, 0x40, 0x80, 0xC1, 0x80, 0x03, 0x80, 0xC1, 0x40, 0x00, 0x80, 0xC1, 0x80, 0x02, 0x80,
+    0xC1, 0x40, 0x01, 0x80, 0xC1, 0x80, 0x01, 0x80, 0xC1, 0x40, 0x02, 0x80, 0xC1, 0x80, 0x2F, 0x0A,
+    0x80, 0xC1, 0x40, 0x05, 0x80, 0xC1, 0x40, 0x05, 0x80, 0xC1, 0x40, 0x05, 0x80, 0xC1, 0x40, 0x05,
+    0x80, 0xC1, 0x40, 0x05, 0x80, 0xC1, 0x40, 0x05, 0x80, 0xC1, 0x40, 0x05, 0x80, 0xC1, 0x40, 0x05,
+    0x80, 0xC1, 0x44, 0x01, 0x80, 0xC6, 0x40, 0x00, 0x80, 0xC6, 0x40, 0x27, 0x0F, 0x80, 0xC2, 0x03,
+    0x40, 0xC2, 0x80, 0x01, 0x80, 0xC2, 0x80, 0x02, 0x80, 0xC2, 0x80, 0x01, 0x80, 0xC3, 0x02, 0xC3,
+    0x80, 0x01, 0x80, 0xC1, 0x80, 0xC0, 0x40, 0x00, 0x80, 0xC0, 0x80, 0xC1, 0x80, 0x01, 0x80, 0xC1,
+    0x40, 0xC1, 0x00, 0xC1, 0x40, 0xC1, 0x80, 0x01, 0x80, 0xC1, 0x00, 0xC1, 0x80, 0xC0, 0x80, 0x00,
+    0xC1, 0x80, 0x01, 0x80, 0xC1, 0x00, 0x40, 0xC2, 0x40, 0x00, 0xC1, 0x80, 0x01, 0x80, 0xC1, 0x01,
+    0xC2, 0x01, 0xC1, 0x80, 0x01, 0x80, 0xC1, 0x01, 0x80, 0xC0, 0x80, 0x01, 0xC1, 0x80, 0x01, 0x80,
+    0xC1, 0x06, 0xC1, 0x80, 0x01, 0x80, 0xC1, 0x06, 0xC1, 0x80, 0x3C, 0x0D, 0x80, 0xC1, 0x80, 0x02,
+    0x80, 0xC1, 0x40, 0x01, 0x80, 0xC2, 0x40, 0x01, 0x80, 0xC1, 0x40, 0x01, 0x80, 0xC2, 0x80, 0x01,
+    0x80, 0xC1, 0x40, 0x01, 0x80, 0xC3, 0x40, 0x00, 0x80, 0xC1, 0x40, 0x01, 0x80, 0xC1, 0x40, 0xC1,
+    0x00, 0x80, 0xC1, 0x40, 0x01, 0x80, 0xC1, 0x00, 0xC1, 0x40, 0x80, 0xC1, 0x40, 0x01, 0x80, 0xC1,
+    0x00, 0x40, 0xC1, 0x80, 0xC1, 0x40, 0x01, 0x80, 0xC1, 0x01, 0xC4, 0x40, 0x01, 0x80, 0xC1, 0x01,
+    0x40, 0xC3, 0x40, 0x01, 0x80, 0xC1, 0x02, 0x80, 0xC2, 0x40, 0x01, 0x80, 0xC1, 0x02, 0x40, 0xC2,
+    0x40, 0x34, 0x0F, 0x80, 0xC3, 0x80, 0x40, 0x04, 0x80, 0xC6, 0x80, 0x02, 0x80, 0xC1, 0x80, 0x02,
+    0x80, 0xC1, 0x40, 0x01, 0xC2, 0x03, 0x40, 0xC1, 0x80, 0x00, 0x40, 0xC1, 0x80, 0x04, 0xC2, 0x00,
+    0x40, 0xC1, 0x80, 0x04, 0xC2, 0x00, 0x40, 0xC1, 0x80, 0x04, 0xC2, 0x01, 0xC2, 0x03, 0x40, 0xC1,
+    0x80, 0x01, 0x80, 0xC1, 0x80, 0x02, 0x80, 0xC1, 0x40, 0x02, 0x80, 0xC2, 0x80, 0xC2, 0x80, 0x04,
+    0x80, 0xC4, 0x80, 0x07, 0x41, 0x2C, 0x0B, 0x80, 0xC4, 0x81, 0x02, 0x80, 0xC6, 0x80, 0x01, 0x80,
+    0xC1, 0x40, 0x00, 0x40, 0xC2, 0x40, 0x00, 0x80, 0xC1, 0x40, 0x01, 0x80, 0xC1, 0x40, 0x00, 0x80,
+    0xC1, 0x40, 0x01, 0x80, 0xC1, 0x40, 0x00, 0x80, 0xC1, 0x81, 0xC3, 0x01, 0x80, 0xC5, 0x80, 0x40,
+    0x01, 0x80, 0xC1, 0x42, 0x04, 0x80, 0xC1, 0x40, 0x06, 0x80, 0xC1, 0x40, 0x06, 0x80, 0xC1, 0x40,
+    0x31, 0x0F, 0x80, 0xC3, 0x80, 0x40, 0x04, 0x80, 0xC6, 0x80, 0x02, 0x80, 0xC1, 0x80, 0x02, 0x80,
+    0xC1, 0x40, 0x01, 0xC2, 0x03, 0x40, 0xC1, 0x80, 0x00, 0x40, 0xC1, 0x80, 0x04, 0xC2, 0x00, 0x40,
+    0xC1, 0x80, 0x04, 0xC2, 0x00, 0x40, 0xC1, 0x80, 0x04, 0xC2, 0x01, 0xC2, 0x03, 0x40, 0xC1, 0x80,
+    0x01, 0x80, 0xC1, 0x80, 0x02, 0x80, 0xC1, 0x40, 0x02, 0x80, 0xC2, 0x80, 0xC2, 0x80, 0x04, 0x80,
+    0xC4, 0x40, 0x07, 0x41, 0xC1, 0x80, 0x09, 0x40, 0xC1, 0x80, 0x0A, 0x41, 0x0E, 0x0C, 0x80, 0xC4,
+    0x80, 0x40, 0x03, 0x80, 0xC6, 0x80, 0x02, 0x80, 0xC1, 0x40, 0x00, 0x40, 0xC1, 0x80, 0x02, 0x80,
+    0xC1, 0x40, 0x01, 0xC1, 0x80, 0x02, 0x80, 0xC1, 0x40, 0x00, 0x40, 0xC1, 0x80, 0x02, 0x80, 0xC5,
+    0x80, 0x03, 0x80, 0xC1, 0x80, 0xC2, 0x80, 0x03, 0x80, 0xC1, 0x40, 0x00, 0x80, 0xC1, 0x80, 0x02,
+    0x80, 0xC1, 0x40, 0x01, 0xC2, 0x02, 0x80, 0xC1, 0x40, 0x01, 0x80, 0xC1, 0x80, 0x01, 0x80, 0xC1,
+    0x40, 0x02, 0xC2, 0x30, 0x0C, 0x80, 0xC4, 0x80, 0x02, 0x80, 0xC6, 0x02, 0xC2, 0x02, 0x40, 0x80,
+    0x02, 0xC1, 0x80, 0x07, 0x80, 0xC2, 0x81, 0x40, 0x04, 0x80, 0xC4, 0x80, 0x04, 0x40, 0x81, 0xC2,
+    0x80, 0x06, 0x40, 0xC1, 0x80, 0x01, 0x80, 0x40, 0x02, 0x40, 0xC1, 0x80, 0x01, 0x80, 0xC1, 0x81,
+    0xC2, 0x40, 0x01, 0x40, 0x80, 0xC4, 0x40, 0x05, 0x41, 0x25, 0x09, 0xD3, 0x43, 0xC1, 0x80, 0x42,
+    0x02, 0x40, 0xC1, 0x80, 0x05, 0x40, 0xC1, 0x80, 0x05, 0x40, 0xC1, 0x80, 0x05, 0x40, 0xC1, 0x80,
+    0x05, 0x40, 0xC1, 0x80, 0x05, 0x40, 0xC1, 0x80, 0x05, 0x40, 0xC1, 0x80, 0x05, 0x40, 0xC1, 0x80,
+    0x2A, 0x0C, 0x80, 0xC1, 0x40, 0x02, 0xC1, 0x80, 0x01, 0x80, 0xC1, 0x40, 0x02, 0xC1, 0x80, 0x01,
+    0x80, 0xC1, 0x40, 0x02, 0xC1, 0x80, 0x01, 0x80, 0xC1, 0x40, 0x02, 0xC1, 0x80, 0x01, 0x80, 0xC1,
+    0x40, 0x02, 0xC1, 0x80, 0x01, 0x80, 0xC1, 0x40, 0x02, 0xC1, 0x80, 0x01, 0x80, 0xC1, 0x40, 0x02,
+    0xC1, 0x80, 0x01, 0x80, 0xC1, 0x40, 0x02, 0xC1, 0x80, 0x01, 0x40, 0xC1, 0x80, 0x01, 0x40, 0xC1,
+    0x80, 0x02, 0xC7, 0x04, 0x80, 0xC3, 0x80, 0x40, 0x06, 0x41, 0x28, 0x0B, 0x80, 0xC1, 0x04, 0x40,
+    0xC1, 0x41, 0xC1, 0x40, 0x03, 0x80, 0xC1, 0x01, 0xC1, 0x80, 0x02, 0x40, 0xC1, 0x80, 0x01, 0x80,
+    0xC1, 0x02, 0x80, 0xC1, 0x40, 0x01, 0x40, 0xC1, 0x80, 0x01, 0xC2, 0x03, 0xC2, 0x00, 0x40, 0xC1,
+    0x80, 0x03, 0x80, 0xC1, 0x40, 0x80, 0xC1, 0x04, 0x40, 0xC1, 0x80, 0xC1, 0x80, 0x05, 0x80, 0xC3,
+    0x40, 0x05, 0x40, 0xC3, 0x07, 0xC2, 0x80, 0x33, 0x10, 0x40, 0xC1, 0x40, 0x01, 0x40, 0xC1, 0x80,
+    0x02, 0x80, 0xC1, 0x00, 0x40, 0xC1, 0x80, 0x01, 0x40, 0xC2, 0x02, 0xC1, 0x80, 0x01, 0xC1, 0x80,
+    0x01, 0x80, 0xC2, 0x40, 0x00, 0x40, 0xC1, 0x80, 0x01, 0x80, 0xC1, 0x01, 0xC1, 0x80, 0xC0, 0x40,
+    0x00, 0x40, 0xC1, 0x40, 0x01, 0x80, 0xC1, 0x40, 0x00, 0xC0, 0x80, 0x40, 0xC0, 0x80, 0x00, 0x80,
+    0xC1, 0x02, 0x40, 0xC1, 0x41, 0xC0, 0x80, 0x00, 0xC1, 0x00, 0xC1, 0x80, 0x03, 0xC1, 0x81, 0xC0,
+    0x40, 0x00, 0x80, 0xC0, 0x40, 0xC1, 0x80, 0x03, 0x80, 0xC1, 0x80, 0xC0, 0x01, 0x80, 0xC0, 0x80,
+    0xC1, 0x40, 0x03, 0x80, 0xC3, 0x01, 0x40, 0xC3, 0x04, 0x40, 0xC2, 0x80, 0x02, 0xC3, 0x05, 0xC2,
+    0x40, 0x02, 0xC2, 0x80, 0x3F, 0x06, 0x0B, 0x40, 0xC1, 0x80, 0x02, 0x40, 0xC1, 0x80, 0x01, 0x80,
+    0xC1, 0x40, 0x01, 0x80, 0xC1, 0x40, 0x02, 0xC2, 0x00, 0x80, 0xC1, 0x40, 0x03, 0x40, 0xC1, 0x80,
+    0xC1, 0x80, 0x05, 0x80, 0xC3, 0x07, 0xC2, 0x80, 0x06, 0x80, 0xC3, 0x40, 0x04, 0x40, 0xC1, 0x80,
+    0xC2, 0x04, 0xC2, 0x00, 0x40, 0xC1, 0x80, 0x02, 0x80, 0xC1, 0x40, 0x01, 0x80, 0xC1, 0x40, 0x00,
+    0x40, 0xC1, 0x80, 0x03, 0xC2, 0x30, 0x0A, 0x80, 0xC1, 0x40, 0x02, 0x40, 0xC1, 0x80, 0x40, 0xC1,
+    0x80, 0x02, 0xC2, 0x01, 0x80, 0xC1, 0x80, 0x00, 0x80, 0xC1, 0x40, 0x02, 0xC2, 0x40, 0xC1, 0x80,
+    0x03, 0x40, 0xC4, 0x05, 0x80, 0xC2, 0x40, 0x06, 0xC1, 0x80, 0x07, 0xC1, 0x80, 0x07, 0xC1, 0x80,
+    0x07, 0xC1, 0x80, 0x07, 0xC1, 0x80, 0x2F, 0x0A, 0x40, 0xC8, 0x00, 0x40, 0xC8, 0x01, 0x44, 0x80,
+    0xC1, 0x40, 0x05, 0x80, 0xC1, 0x80, 0x05, 0x40, 0xC1, 0x80, 0x05, 0x40, 0xC2, 0x06, 0xC2, 0x40,
+    0x05, 0x80, 0xC1, 0x40, 0x05, 0x80, 0xC1, 0x80, 0x44, 0x00, 0x40, 0xC8, 0x41, 0xC8, 0x40, 0x2B,
+    0x00, 0x40, 0x82, 0x40, 0x01, 0x80, 0xC2, 0x80, 0x01, 0x80, 0xC0, 0x80, 0x41, 0x01, 0x80, 0xC0,
+    0x80, 0x03, 0x80, 0xC0, 0x80, 0x03, 0x80, 0xC0, 0x80, 0x03, 0x80, 0xC0, 0x80, 0x03, 0x80, 0xC0,
+    0x80, 0x03, 0x80, 0xC0, 0x80, 0x03, 0x80, 0xC0, 0x80, 0x03, 0x80, 0xC0, 0x80, 0x03, 0x80, 0xC0,
+    0x80, 0x03, 0x80, 0xC1, 0x81, 0x01, 0x80, 0xC2, 0x80, 0x0E, 0x04, 0xC0, 0x80, 0x02, 0x80, 0xC0,
+    0x02, 0x40, 0xC0, 0x40, 0x02, 0xC0, 0x80, 0x02, 0x80, 0xC0, 0x02, 0x40, 0xC0, 0x40, 0x02, 0xC0,
+    0x80, 0x02, 0x80, 0xC0, 0x02, 0x40, 0xC0, 0x40, 0x02, 0xC0, 0x80, 0x02, 0x80, 0xC0, 0x02, 0x40,
+    0xC0, 0x03, 0x80, 0x09, 0x00, 0x83, 0x40, 0x01, 0xC3, 0x80, 0x01, 0x41, 0xC1, 0x80, 0x03, 0xC1,
+    0x80, 0x03, 0xC1, 0x80, 0x03, 0xC1, 0x80, 0x03, 0xC1, 0x80, 0x03, 0xC1, 0x80, 0x03, 0xC1, 0x80,
+    0x03, 0xC1, 0x80, 0x03, 0xC1, 0x80, 0x03, 0xC1, 0x80, 0x01, 0x81, 0xC1, 0x80, 0x01, 0xC3, 0x80,
+    0x0E, 0x10, 0x40, 0xC1, 0x80, 0x08, 0x80, 0xC2, 0x80, 0x06, 0x80, 0xC0, 0x80, 0x00, 0x80, 0xC0,
+    0x40, 0x04, 0x80, 0xC0, 0x40, 0x02, 0x80, 0xC0, 0x40, 0x03, 0x40, 0x05, 0x41, 0x3F, 0x3F, 0x03,
+    0x3F, 0x2F, 0x86, 0x40, 0x86, 0x40, 0x00, 0x80, 0xC0, 0x40, 0x05, 0x81, 0x06, 0x80, 0x40, 0x3F,
+    0x2A, 0x1F, 0x41, 0x80, 0x41, 0x03, 0x80, 0xC4, 0x80, 0x02, 0x81, 0x41, 0x80, 0xC1, 0x80, 0x03,
+    0x42, 0x80, 0xC1, 0x01, 0x40, 0xC6, 0x00, 0x40, 0xC1, 0x80, 0x41, 0x80, 0xC1, 0x00, 0x40, 0xC1,
+    0x40, 0x01, 0xC2, 0x00, 0x40, 0xC2, 0x80, 0xC3, 0x01, 0x80, 0xC2, 0x81, 0xC1, 0x03, 0x40, 0x23,
+    0x00, 0x40, 0x81, 0x07, 0x80, 0xC1, 0x07, 0x80, 0xC1, 0x07, 0x80, 0xC1, 0x00, 0x42, 0x03, 0x80,
+    0xC1, 0x80, 0xC2, 0x80, 0x02, 0x80, 0xC2, 0x81, 0xC1, 0x80, 0x01, 0x80, 0xC1, 0x02, 0xC2, 0x01,
+    0x80, 0xC1, 0x02, 0x80, 0xC1, 0x01, 0x80, 0xC1, 0x02, 0x80, 0xC1, 0x01, 0x80, 0xC1, 0x40, 0x01,
+    0xC2, 0x01, 0x80, 0xC2, 0x80, 0xC2, 0x40, 0x01, 0x80, 0xC1, 0x40, 0xC2, 0x80, 0x07, 0x40, 0x24,
+    0x1E, 0x40, 0x80, 0x40, 0x03, 0x80, 0xC4, 0x01, 0x80, 0xC1, 0x82, 0xC0, 0x00, 0x40, 0xC1, 0x80,
+    0x04, 0x40, 0xC1, 0x80, 0x04, 0x40, 0xC1, 0x80, 0x05, 0xC1, 0x80, 0x02, 0x40, 0x01, 0x80, 0xC2,
+    0x81, 0xC0, 0x02, 0x80, 0xC4, 0x04, 0x41, 0x1D, 0x06, 0x81, 0x40, 0x06, 0x40, 0xC1, 0x80, 0x06,
+    0x40, 0xC1, 0x80, 0x03, 0x41, 0x00, 0x40, 0xC1, 0x80, 0x01, 0x40, 0xC3, 0x80, 0xC1, 0x80, 0x01,
+    0x80, 0xC1, 0x81, 0xC2, 0x80, 0x00, 0x40, 0xC1, 0x80, 0x01, 0x40, 0xC1, 0x80, 0x00, 0x40, 0xC1,
+    0x80, 0x01, 0x40, 0xC1, 0x80, 0x00, 0x40, 0xC1, 0x80, 0x01, 0x40, 0xC1, 0x80, 0x01, 0xC1, 0x80,
+    0x01, 0x80, 0xC1, 0x80, 0x01, 0x80, 0xC1, 0x81, 0xC2, 0x80, 0x02, 0x80, 0xC2, 0x40, 0xC1, 0x80,
+    0x03, 0x41, 0x26, 0x20, 0x43, 0x04, 0x80, 0xC3, 0x80, 0x40, 0x01, 0x80, 0xC1, 0x80, 0x40, 0xC1,
+    0x80, 0x00, 0x40, 0xC1, 0x80, 0x01, 0x40, 0xC1, 0x41, 0xC7, 0x80, 0x40, 0xC1, 0x85, 0x40, 0x00,
+    0xC1, 0x80, 0x03, 0x40, 0x01, 0x80, 0xC1, 0x82, 0xC1, 0x02, 0x80, 0xC4, 0x80, 0x04, 0x42, 0x20,
+    0x02, 0x41, 0x80, 0x40, 0x01, 0x80, 0xC2, 0x80, 0x00, 0x40, 0xC1, 0x80, 0x42, 0x80, 0xC1, 0x41,
+    0x00, 0x80, 0xC4, 0x81, 0xC2, 0x81, 0x40, 0x00, 0x80, 0xC1, 0x40, 0x02, 0x80, 0xC1, 0x40, 0x02,
+    0x80, 0xC1, 0x40, 0x02, 0x80, 0xC1, 0x40, 0x02, 0x80, 0xC1, 0x40, 0x02, 0x80, 0xC1, 0x40, 0x1D,
+    0x23, 0x41, 0x01, 0x41, 0x02, 0x40, 0xC3, 0x80, 0xC1, 0x80, 0x01, 0x80, 0xC1, 0x81, 0xC2, 0x80,
+    0x00, 0x40, 0xC1, 0x80, 0x01, 0x40, 0xC1, 0x80, 0x00, 0x40, 0xC1, 0x80, 0x01, 0x40, 0xC1, 0x80,
+    0x00, 0x40, 0xC1, 0x80, 0x01, 0x40, 0xC1, 0x80, 0x01, 0xC1, 0x80, 0x01, 0x80, 0xC1, 0x80, 0x01,
+    0x80, 0xC6, 0x80, 0x02, 0x80, 0xC1, 0x80, 0x40, 0xC1, 0x80, 0x06, 0x40, 0xC1, 0x40, 0x01, 0x40,
+    0xC0, 0x82, 0xC1, 0x80, 0x02, 0x40, 0xC4, 0x80, 0x05, 0x42, 0x04, 0x00, 0x40, 0x81, 0x07, 0x80,
+    0xC1, 0x07, 0x80, 0xC1, 0x07, 0x80, 0xC1, 0x00, 0x42, 0x03, 0x80, 0xC1, 0x80, 0xC2, 0x80, 0x02,
+    0x80, 0xC2, 0x80, 0xC2, 0x40, 0x01, 0x80, 0xC1, 0x40, 0x00, 0x40, 0xC1, 0x80, 0x01, 0x80, 0xC1,
+    0x01, 0x40, 0xC1, 0x80, 0x01, 0x80, 0xC1, 0x01, 0x40, 0xC1, 0x80, 0x01, 0x80, 0xC1, 0x01, 0x40,
+    0xC1, 0x80, 0x01, 0x80, 0xC1, 0x01, 0x40, 0xC1, 0x80, 0x01, 0x80, 0xC1, 0x01, 0x40, 0xC1, 0x80,
+    0x2C, 0x00, 0x40, 0x81, 0x01, 0x80, 0xC1, 0x01, 0x82, 0x01, 0x42, 0x01, 0x80, 0xC1, 0x01, 0x80,
+    0xC1, 0x01, 0x80, 0xC1, 0x01, 0x80, 0xC1, 0x01, 0x80, 0xC1, 0x01, 0x80, 0xC1, 0x01, 0x80, 0xC1,
+    0x01, 0x80, 0xC1, 0x14, 0x00, 0x40, 0x81, 0x01, 0x80, 0xC1, 0x01, 0x82, 0x01, 0x42, 0x01, 0x80,
+    0xC1, 0x01, 0x80, 0xC1, 0x01, 0x80, 0xC1, 0x01, 0x80, 0xC1, 0x01, 0x80, 0xC1, 0x01, 0x80, 0xC1,
+    0x01, 0x80, 0xC1, 0x01, 0x80, 0xC1, 0x01, 0x80, 0xC0, 0x80, 0x00, 0x80, 0xC1, 0x80, 0x00, 0xC1,
+    0x80, 0x01, 0x41, 0x02, 0x00, 0x40, 0x81, 0x06, 0x80, 0xC1, 0x06, 0x80, 0xC1, 0x06, 0x80, 0xC1,
+    0x02, 0x42, 0x00, 0x80, 0xC1, 0x01, 0x80, 0xC1, 0x40, 0x00, 0x80, 0xC1, 0x00, 0x80, 0xC1, 0x40,
+    0x01, 0x80, 0xC1, 0x80, 0xC1, 0x40, 0x02, 0x80, 0xC3, 0x40, 0x03, 0x80, 0xC3, 0x80, 0x03, 0x80,
+    0xC1, 0x40, 0xC1, 0x80, 0x02, 0x80, 0xC1, 0x00, 0x40, 0xC1, 0x80, 0x01, 0x80, 0xC1, 0x01, 0x40,
+    0xC1, 0x80, 0x27, 0x00, 0x40, 0x81, 0x01, 0x80, 0xC1, 0x01, 0x80, 0xC1, 0x01, 0x80, 0xC1, 0x01,
+    0x80, 0xC1, 0x01, 0x80, 0xC1, 0x01, 0x80, 0xC1, 0x01, 0x80, 0xC1, 0x01, 0x80, 0xC1, 0x01, 0x80,
+    0xC1, 0x01, 0x80, 0xC1, 0x01, 0x80, 0xC1, 0x14, 0x30, 0x42, 0x00, 0x42, 0x01, 0x42, 0x03, 0x80,
+    0xC1, 0x80, 0xC2, 0x40, 0x80, 0xC2, 0x80, 0x02, 0x80, 0xC2, 0x80, 0xC3, 0x80, 0xC2, 0x40, 0x01,
+    0x80, 0xC1, 0x01, 0x80, 0xC1, 0x40, 0x00, 0x40, 0xC1, 0x80, 0x01, 0x80, 0xC1, 0x01, 0x80, 0xC1,
+    0x40, 0x00, 0x40, 0xC1, 0x80, 0x01, 0x80, 0xC1, 0x01, 0x80, 0xC1, 0x40, 0x00, 0x40, 0xC1, 0x80,
+    0x01, 0x80, 0xC1, 0x01, 0x80, 0xC1, 0x40, 0x00, 0x40, 0xC1, 0x80, 0x01, 0x80, 0xC1, 0x01, 0x80,
+    0xC1, 0x40, 0x00, 0x40, 0xC1, 0x80, 0x01, 0x80, 0xC1, 0x01, 0x80, 0xC1, 0x40, 0x00, 0x40, 0xC1,
+    0x80, 0x3F, 0x00, 0x21, 0x42, 0x00, 0x42, 0x03, 0x80, 0xC1, 0x80, 0xC2, 0x80, 0x02, 0x80, 0xC2,
+    0x80, 0xC2, 0x40, 0x01, 0x80, 0xC1, 0x40, 0x00, 0x40, 0xC1, 0x80, 0x01, 0x80, 0xC1, 0x01, 0x40,
+    0xC1, 0x80, 0x01, 0x80, 0xC1, 0x01, 0x40, 0xC1, 0x80, 0x01, 0x80, 0xC1, 0x01, 0x40, 0xC1, 0x80,
+    0x01, 0x80, 0xC1, 0x01, 0x40, 0xC1, 0x80, 0x01, 0x80, 0xC1, 0x01, 0x40, 0xC1, 0x80, 0x2C, 0x20,
+    0x43, 0x04, 0x80, 0xC4, 0x40, 0x01, 0x80, 0xC1, 0x81, 0xC2, 0x00, 0x40, 0xC1, 0x80, 0x01, 0x40,
+    0xC1, 0x41, 0xC1, 0x80, 0x02, 0xC1, 0x80, 0x40, 0xC1, 0x80, 0x02, 0xC1, 0x80, 0x00, 0xC1, 0x80,
+    0x01, 0x40, 0xC1, 0x40, 0x00, 0x80, 0xC1, 0x81, 0xC2, 0x02, 0x80, 0xC3, 0x80, 0x05, 0x41, 0x21,
+    0x21, 0x42, 0x00, 0x42, 0x03, 0x80, 0xC1, 0x80, 0xC2, 0x80, 0x02, 0x80, 0xC2, 0x81, 0xC1, 0x80,
+    0x01, 0x80, 0xC1, 0x02, 0xC2, 0x01, 0x80, 0xC1, 0x02, 0x80, 0xC1, 0x01, 0x80, 0xC1, 0x02, 0x80,
+    0xC1, 0x01, 0x80, 0xC1, 0x40, 0x01, 0xC2, 0x01, 0x80, 0xC2, 0x80, 0xC2, 0x40, 0x01, 0x80, 0xC1,
+    0x40, 0xC2, 0x80, 0x02, 0x80, 0xC1, 0x01, 0x40, 0x04, 0x80, 0xC1, 0x07, 0x80, 0xC1, 0x11, 0x23,
+    0x41, 0x01, 0x41, 0x02, 0x40, 0xC3, 0x80, 0xC1, 0x80, 0x01, 0x80, 0xC1, 0x81, 0xC2, 0x80, 0x00,
+    0x40, 0xC1, 0x80, 0x01, 0x40, 0xC1, 0x80, 0x00, 0x40, 0xC1, 0x80, 0x01, 0x40, 0xC1, 0x80, 0x00,
+    0x40, 0xC1, 0x80, 0x01, 0x40, 0xC1, 0x80, 0x01, 0xC1, 0x80, 0x01, 0x80, 0xC1, 0x80, 0x01, 0x80,
+    0xC1, 0x81, 0xC2, 0x80, 0x02, 0x80, 0xC2, 0x40, 0xC1, 0x80, 0x03, 0x41, 0x00, 0x40, 0xC1, 0x80,
+    0x06, 0x40, 0xC1, 0x80, 0x06, 0x40, 0xC1, 0x80, 0x0B, 0x15, 0x42, 0x00, 0x41, 0x00, 0x80, 0xC1,
+    0x80, 0xC1, 0x00, 0x80, 0xC2, 0x81, 0x00, 0x80, 0xC1, 0x40, 0x02, 0x80, 0xC1, 0x03, 0x80, 0xC1,
+    0x03, 0x80, 0xC1, 0x03, 0x80, 0xC1, 0x03, 0x80, 0xC1, 0x1E, 0x1D, 0x40, 0x80, 0x41, 0x02, 0x80,
+    0xC4, 0x80, 0x01, 0xC1, 0x80, 0x41, 0x81, 0x00, 0x40, 0xC1, 0x40, 0x05, 0x80, 0xC3, 0x80, 0x40,
+    0x02, 0x40, 0x81, 0xC2, 0x05, 0x40, 0xC1, 0x40, 0x00, 0xC0, 0x82, 0xC2, 0x01, 0xC5, 0x40, 0x03,
+    0x42, 0x1D, 0x07, 0x40, 0x81, 0x03, 0x80, 0xC1, 0x02, 0x40, 0x80, 0xC1, 0x42, 0x80, 0xC4, 0x81,
+    0xC2, 0x82, 0x00, 0x80, 0xC1, 0x03, 0x80, 0xC1, 0x03, 0x80, 0xC1, 0x03, 0x80, 0xC1, 0x40, 0x02,
+    0x40, 0xC3, 0x80, 0x01, 0x80, 0xC2, 0x80, 0x1B, 0x21, 0x42, 0x02, 0x41, 0x02, 0x80, 0xC0, 0x80,
+    0x01, 0x40, 0xC1, 0x80, 0x01, 0x80, 0xC0, 0x80, 0x01, 0x40, 0xC1, 0x80, 0x01, 0x80, 0xC0, 0x80,
+    0x01, 0x40, 0xC1, 0x80, 0x01, 0x80, 0xC0, 0x80, 0x01, 0x40, 0xC1, 0x80, 0x01, 0x80, 0xC0, 0x80,
+    0x01, 0x40, 0xC1, 0x80, 0x01, 0x80, 0xC1, 0x01, 0x80, 0xC1, 0x80, 0x01, 0x80, 0xC2, 0x80, 0xC2,
+    0x80, 0x02, 0x80, 0xC2, 0x40, 0xC1, 0x80, 0x03, 0x41, 0x26, 0x1D, 0x42, 0x03, 0x41, 0x00, 0x80,
+    0xC1, 0x02, 0x40, 0xC1, 0x40, 0x00, 0xC1, 0x40, 0x01, 0x80, 0xC1, 0x01, 0x80, 0xC0, 0x80, 0x01,
+    0xC1, 0x80, 0x01, 0x40, 0xC1, 0x41, 0xC1, 0x03, 0xC1, 0x81, 0xC0, 0x80, 0x03, 0x80, 0xC3, 0x40,
+    0x04, 0xC3, 0x05, 0x80, 0xC1, 0x80, 0x2A, 0x2A, 0x41, 0x02, 0x41, 0x02, 0x41, 0x00, 0x40, 0xC1,
+    0x40, 0x00, 0x40, 0xC1, 0x40, 0x00, 0x40, 0xC1, 0x01, 0xC1, 0x80, 0x00, 0x80, 0xC1, 0x40, 0x00,
+    0x80, 0xC1, 0x01, 0x80, 0xC0, 0x80, 0x00, 0x80, 0xC1, 0x80, 0x00, 0xC1, 0x80, 0x01, 0x80, 0xC1,
+    0x00, 0xC0, 0x81, 0xC0, 0x00, 0xC1, 0x40, 0x01, 0x40, 0xC1, 0x80, 0xC0, 0x40, 0x80, 0xC0, 0x80,
+    0xC1, 0x03, 0xC3, 0x41, 0xC2, 0x80, 0x03, 0x80, 0xC2, 0x01, 0xC2, 0x80, 0x03, 0x40, 0xC1, 0x80,
+    0x01, 0x80, 0xC1, 0x40, 0x39, 0x1E, 0x41, 0x03, 0x41, 0x00, 0x40, 0xC1, 0x80, 0x01, 0xC1, 0x80,
+    0x01, 0x40, 0xC1, 0x40, 0x80, 0xC1, 0x03, 0x80, 0xC3, 0x40, 0x04, 0xC2, 0x80, 0x04, 0x40, 0xC2,
+    0x80, 0x04, 0xC1, 0x80, 0xC1, 0x80, 0x02, 0x80, 0xC1, 0x00, 0x40, 0xC1, 0x40, 0x00, 0x40, 0xC1,
+    0x40, 0x01, 0x80, 0xC1, 0x28, 0x1D, 0x42, 0x03, 0x41, 0x00, 0x80, 0xC1, 0x02, 0x40, 0xC1, 0x40,
+    0x00, 0xC1, 0x80, 0x01, 0x80, 0xC1, 0x01, 0x80, 0xC1, 0x01, 0xC1, 0x40, 0x01, 0x40, 0xC1, 0x41,
+    0xC1, 0x03, 0x80, 0xC0, 0x81, 0xC0, 0x80, 0x03, 0x40, 0xC3, 0x40, 0x04, 0xC3, 0x05, 0x80, 0xC1,
+    0x80, 0x05, 0x40, 0xC1, 0x04, 0x40, 0x81, 0xC0, 0x80, 0x04, 0x80, 0xC2, 0x06, 0x41, 0x05, 0x1B,
+    0x46, 0x00, 0x40, 0xC6, 0x00, 0x40, 0x83, 0xC2, 0x04, 0x80, 0xC1, 0x40, 0x03, 0x80, 0xC1, 0x40,
+    0x03, 0x80, 0xC1, 0x40, 0x03, 0x80, 0xC1, 0x40, 0x03, 0x40, 0xC6, 0x00, 0x40, 0xC6, 0x24, 0x05,
+    0x40, 0x80, 0x40, 0x05, 0x40, 0xC2, 0x80, 0x05, 0x80, 0xC1, 0x41, 0x05, 0x80, 0xC0, 0x80, 0x07,
+    0x80, 0xC0, 0x80, 0x07, 0xC1, 0x80, 0x05, 0x40, 0x80, 0xC1, 0x40, 0x04, 0x40, 0xC2, 0x80, 0x06,
+    0x81, 0xC1, 0x40, 0x07, 0xC1, 0x80, 0x07, 0x80, 0xC0, 0x80, 0x07, 0x80, 0xC0, 0x80, 0x07, 0x80,
+    0xC1, 0x41, 0x05, 0x40, 0xC2, 0x80, 0x07, 0x40, 0x80, 0x40, 0x0C, 0x01, 0x80, 0x40, 0x02, 0xC0,
+    0x80, 0x02, 0xC0, 0x80, 0x02, 0xC0, 0x80, 0x02, 0xC0, 0x80, 0x02, 0xC0, 0x80, 0x02, 0xC0, 0x80,
+    0x02, 0xC0, 0x80, 0x02, 0xC0, 0x80, 0x02, 0xC0, 0x80, 0x02, 0xC0, 0x80, 0x02, 0xC0, 0x80, 0x02,
+    0xC0, 0x80, 0x02, 0xC0, 0x80, 0x02, 0xC0, 0x80, 0x02, 0x80, 0x40, 0x00, 0x01, 0x81, 0x40, 0x06,
+    0x40, 0xC3, 0x06, 0x41, 0xC1, 0x40, 0x07, 0xC1, 0x80, 0x07, 0xC1, 0x80, 0x07, 0xC1, 0x80, 0x07,
+    0x80, 0xC1, 0x41, 0x06, 0xC2, 0x80, 0x05, 0x80, 0xC1, 0x80, 0x40, 0x05, 0xC1, 0x80, 0x07, 0xC1,
+    0x80, 0x07, 0xC1, 0x80, 0x05, 0x41, 0xC1, 0x40, 0x04, 0x40, 0xC3, 0x06, 0x81, 0x40, 0x10, 0x3F,
+    0x0F, 0x80, 0xC2, 0x80, 0x40, 0x00, 0x40, 0x80, 0x02, 0x80, 0xC0, 0x81, 0xC5, 0x02, 0x41, 0x02,
+    0x40, 0x81, 0x40, 0x3F, 0x1D,
+};
+
+static const FontGlyph buttonFontGlyphs[] PROGMEM = {
+    {0, 5}, //  
+    {2, 7}, // !
+    {37, 8}, // "
+    {67, 13}, // #
+    {136, 10}, // $
+    {208, 15}, // %
+    {319, 13}, // &
+    {387, 5}, // '
+    {406, 7}, // (
+    {457, 7}, // )
+    {504, 8}, // *
+    {540, 13}, // +
+    {581, 6}, // ,
+    {602, 6}, // -
+    {611, 6}, // .
+    {624, 5}, // /
+    {666, 10}, // 0
+    {735, 10}, // 1
+    {773, 10}, // 2
+    {821, 10}, // 3
+    {871, 10}, // 4
+    {926, 10}, // 5
+    {980, 10}, // 6
+    {1038, 10}, // 7
+    {1075, 10}, // 8
+    {1142, 10}, // 9
+    {1203, 6}, // :
+    {1230, 6}, // ;
+    {1265, 13}, // <
+    {1305, 13}, // =
+    {1321, 13}, // >
+    {1364, 9}, // ?
+    {1407, 15}, // @
+    {1529, 12}, // A
+    {1585, 11}, // B
+    {1647, 11}, // C
+    {1696, 12}, // D
+    {1769, 10}, // E
+    {1812, 10}, // F
+    {1855, 12}, // G
+    {1921, 13}, // H
+    {2003, 6}, // I
+    {2048, 6}, // J
+    {2103, 12}, // K
+    {2175, 10}, // L
+    {2220, 15}, // M
+    {2315, 13}, // N
+    {2402, 13}, // O
+    {2470, 11}, // P
+    {2529, 13}, // Q
+    {2605, 12}, // R
+    {2676, 11}, // S
+    {2730, 10}, // T
+    {2769, 12}, // U
+    {2843, 12}, // V
+    {2904, 17}, // W
+    {3014, 12}, // X
+    {3078, 11}, // Y
+    {3127, 11}, // Z
+    {3168, 7}, // [
+    {3226, 5}, // backslash
+    {3268, 7}, // ]
+    {3313, 13}, // ^
+    {3344, 8}, // _
+    {3350, 8}, // `
+    {3361, 10}, // a
+    {3408, 11}, // b
+    {3472, 9}, // c
+    {3512, 11}, // d
+    {3587, 10}, // e
+    {3632, 7}, // f
+    {3680, 11}, // g
+    {3755, 11}, // h
+    {3825, 5}, // i
+    {3860, 5}, // j
+    {3908, 10}, // k
+    {3971, 5}, // l
+    {4008, 16}, // m
+    {4099, 11}, // n
+    {4159, 10}, // o
+    {4208, 11}, // p
+    {4271, 11}, // q
+    {4345, 7}, // r
+    {4378, 9}, // s
+    {4418, 7}, // t
+    {4456, 11}, // u
+    {4522, 10}, // v
+    {4567, 14}, // w
+    {4645, 10}, // x
+    {4693, 10}, // y
+    {4751, 9}, // z
+    {4783, 11}, // {
+    {4843, 5}, // |
+    {4892, 11}, // }
+    {4943, 13}, // ~
+};
+
+const Font buttonFont PROGMEM = {32, 126, 16, buttonFontGlyphs, buttonFontData};
@@ -1,24 +1,115 @@
 #include <Arduino.h>
 #include <Servo.h>
 #include "servo/ServoController.h"
+#include "telemetry/Telemetry.h"
+#include "sched/PerfStats.h"
 
 ServoController::ServoController(int controlPin)
 {
     this->controlPin = controlPin;
 }
 
-void ServoController::setAngle(int angle)
+void ServoController::moveTo(uint8_t angle, TaskCallback onArrive, void *context)
 {
-    // if (!servo.attached()) servo.attach(this->controlPin);
+    if (angle > 180)
+        angle = 180;
+    uint16_t target = SERVO_MIN_PULSE + (uint32_t)(SERVO_MAX_PULSE - SERVO_MIN_PULSE) * angle / 180;
+    fromPulse = pulse;
+    distance = (int16_t)target - (int16_t)pulse;
+    uint16_t span = distance < 0 ? -distance : distance;
 
-    // servo.write(angle);
-    // relaxTime = millis() + 1000;
+    // The whole move at cruise speed, rounded up
+    const uint32_t pulsePerSec = (uint32_t)(SERVO_MAX_PULSE - SERVO_MIN_PULSE) * SERVO_CRUISE_DEG_PER_SEC / 180;
+    uint16_t cruiseMillis = ((uint32_t)span * 1000 + pulsePerSec - 1) / pulsePerSec;
+    if (cruiseMillis >= SERVO_RAMP_MILLIS)
+    {
+        rampMillis = SERVO_RAMP_MILLIS;
+    }
+    else
+    {
+        // Too short to reach cruise speed: ramp up and straight back down
+        // at the same acceleration, which takes sqrt(cruise * ramp) each way
+        uint16_t area = cruiseMillis * SERVO_RAMP_MILLIS;
+        rampMillis = 0;
+        while ((uint16_t)(rampMillis + 1) * (rampMillis + 1) <= area)
+            ++rampMillis;
+        cruiseMillis = rampMillis;
+    }
+    durationMillis = cruiseMillis + rampMillis;
+    startedAt = millis();
+    arrived = onArrive;
+    arrivedContext = context;
+    TELEMETRY(SERVO_MOVE, angle, durationMillis);
+
+    // Written before attaching, so the first pulse holds the horn where it is
+    servo.writeMicroseconds(pulse);
+    if (!servo.attached())
+        servo.attach(controlPin);
+    scheduler.cancel(task);
+    task = scheduler.every(SERVO_FRAME_MILLIS, onStep, this, SERVO_FRAME_MILLIS);
+}
+
+uint32_t ServoController::millisLeft() const
+{
+    if (!moving())
+        return 0;
+    uint32_t elapsed = millis() - startedAt;
+    uint32_t total = (uint32_t)durationMillis + SERVO_SETTLE_MILLIS;
+    return elapsed < total ? total - elapsed : 0;
+}
+
+// Position along the trapezoid: a parabola while ramping, a straight line
+// while cruising, at the speed that covers the distance in the time
+void ServoController::step()
+{
+    uint32_t t = millis() - startedAt;
+    if (t >= durationMillis)
+    {
+        pulse = fromPulse + distance;
+        servo.writeMicroseconds(pulse);
+        uint32_t settled = (uint32_t)durationMillis + SERVO_SETTLE_MILLIS;
+        scheduler.cancel(task);
+        task = scheduler.after(t < settled ? settled - t : 0, onArrive, this);
+        return;
+    }
+    uint32_t span = distance < 0 ? -distance : distance;
+    uint32_t cruiseEnd = durationMillis - rampMillis;
+    uint32_t twiceCruise = 2 * (uint32_t)cruiseEnd; // Ramp and cruise times the peak speed
+    uint32_t done;
+    if (t < rampMillis)
+    {
+        done = span * t * t / (twiceCruise * rampMillis);
+    }
+    else if (t <= cruiseEnd)
+    {
+        done = span * (2 * t - rampMillis) / twiceCruise;
+    }
+    else
+    {
+        uint32_t left = durationMillis - t;
+        done = span - span * left * left / (twiceCruise * rampMillis);
+    }
+    pulse = distance < 0 ? fromPulse - done : fromPulse + done;
+    servo.writeMicroseconds(pulse);
 }
 
-void ServoController::update()
+void ServoController::arrive()
 {
-    // if (relaxTime != 0 && millis() >= relaxTime) {
-    //     relax();
-    //     relaxTime = 0;
-    // }
-}
\ No newline at end of file
+    servo.detach(); // No holding torque needed between moves
+    task = TASK_NONE;
+    TaskCallback callback = arrived;
+    arrived = nullptr;
+    if (callback)
+        callback(arrivedContext); // May start the next move
+}
+
+void ServoController::onStep(void *context)
+{
+    PERF_SCOPE(PERF_SERVO);
+    static_cast<ServoController *>(context)->step();
+}
+
+void ServoController::onArrive(void *context)
+{
+    static_cast<ServoController *>(context)->arrive();
+}
@@ -2,24 +2,55 @@
 #define SERVO_CONTROLLER_H
 #include <Arduino.h>
 #include <Servo.h>
+#include "sched/Scheduler.h"
 
+#define SERVO_OPEN_ANGLE 90
+#define SERVO_CLOSED_ANGLE 0
+#define SERVO_MIN_PULSE 544          // Servo library's 0 and 180 degrees, us
+#define SERVO_MAX_PULSE 2400
+#define SERVO_CRUISE_DEG_PER_SEC 180 // Top speed of a move
+#define SERVO_RAMP_MILLIS 150        // Time to reach cruise speed, and to stop from it
+#define SERVO_FRAME_MILLIS 20        // The servo takes one pulse per frame, so no finer steps
+#define SERVO_SETTLE_MILLIS 100      // After the last step, for the horn to catch up
+
+/**
+ * Moves the servo along a trapezoidal trajectory: it ramps up to cruise
+ * speed, cruises and ramps down again, stepped once a servo frame from the
+ * scheduler, so nothing waits on the horn. Once it has settled the servo is
+ * detached, which stops the pulses and lets it go limp until the next
+ * move, and the move's callback runs.
+ */
 class ServoController {
 public:
     ServoController(int controlPin);
-    void open() {
-        setAngle(90); // Default to middle position
+    // A new move starts from wherever the last one had got to and replaces
+    // its callback, which then never runs
+    void moveTo(uint8_t angle, TaskCallback onArrive = nullptr, void *context = nullptr);
+    void open(TaskCallback onArrive = nullptr, void *context = nullptr) {
+        moveTo(SERVO_OPEN_ANGLE, onArrive, context);
     }
-    void close() {
-        setAngle(0); // Default to closed position
+    void close(TaskCallback onArrive = nullptr, void *context = nullptr) {
+        moveTo(SERVO_CLOSED_ANGLE, onArrive, context);
     }
-    void update();
+    bool moving() const { return scheduler.pending(task); }
+    uint32_t millisLeft() const; // Until the current move has settled
     private:
-    void relax() {
-        servo.detach();
-    }
-    void setAngle(int angle);
+    void step();
+    void arrive();
+    static void onStep(void *context);
+    static void onArrive(void *context);
     Servo servo;
     int controlPin;
-    uint32_t relaxTime = 0;
+    // The horn is taken to start open, where the Servo library drives it
+    // on the first attach anyway
+    uint16_t pulse = SERVO_MIN_PULSE + (uint32_t)(SERVO_MAX_PULSE - SERVO_MIN_PULSE) * SERVO_OPEN_ANGLE / 180;
+    uint16_t fromPulse = 0;
+    int16_t distance = 0;       // Pulse change over the move, us
+    uint16_t durationMillis = 0;
+    uint16_t rampMillis = 0;
+    uint32_t startedAt = 0;
+    TaskHandle task = TASK_NONE;
+    TaskCallback arrived = nullptr;
+    void *arrivedContext = nullptr;
 };
-#endif // SERVO_CONTROLLER_H
\ No newline at end of file
+#endif // SERVO_CONTROLLER_H
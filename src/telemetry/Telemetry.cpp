@@ -0,0 +1,207 @@
+#include <Arduino.h>
+#include "telemetry/Telemetry.h"
+#include "sched/Scheduler.h"
+#include "link/SerialLink.h"
+
+#define TELEMETRY_MASK (TELEMETRY_BUFFER_SIZE - 1)
+
+Telemetry telemetry;
+
+#if TELEMETRY_TEXT
+#define TELEMETRY_FORMAT(name, level, format) static const char format_##name[] PROGMEM = format;
+#define TELEMETRY_FORMAT_POINTER(name, level, format) format_##name,
+TELEMETRY_EVENTS(TELEMETRY_FORMAT)
+static const char *const formats[] PROGMEM = {TELEMETRY_EVENTS(TELEMETRY_FORMAT_POINTER)};
+#endif
+
+// In binary builds the serial link owns the port and drains the ring
+void Telemetry::begin()
+{
+#if TELEMETRY_TEXT
+    Serial.begin(TELEMETRY_BAUD);
+    scheduler.onIdle(onIdle);
+#endif
+    TELEMETRY(BOOT);
+}
+
+#if TELEMETRY_TEXT
+void Telemetry::onIdle()
+{
+    telemetry.drain();
+}
+#endif
+
+void Telemetry::log(uint8_t id)
+{
+    push(id, 0, nullptr);
+}
+
+void Telemetry::log(uint8_t id, int32_t a)
+{
+    push(id, 1, &a);
+}
+
+void Telemetry::log(uint8_t id, int32_t a, int32_t b)
+{
+    int32_t args[] = {a, b};
+    push(id, 2, args);
+}
+
+void Telemetry::log(uint8_t id, int32_t a, int32_t b, int32_t c)
+{
+    int32_t args[] = {a, b, c};
+    push(id, 3, args);
+}
+
+uint8_t Telemetry::putVarint(uint8_t *out, uint32_t value)
+{
+    uint8_t n = 0;
+    while (value >= 0x80)
+    {
+        out[n++] = (value & 0x7F) | 0x80;
+        value >>= 7;
+    }
+    out[n++] = value;
+    return n;
+}
+
+uint8_t Telemetry::freeSpace() const
+{
+    return TELEMETRY_MASK - ((head - tail) & TELEMETRY_MASK);
+}
+
+void Telemetry::push(uint8_t id, uint8_t argc, const int32_t *args)
+{
+    // Report earlier losses first so the decoded log shows where the gap is
+    if (dropped > 0 && id != TELEMETRY_DROPPED)
+    {
+        int32_t lost = dropped;
+        dropped = 0;
+        push(TELEMETRY_DROPPED, 1, &lost);
+        if (dropped > 0)
+        {
+            dropped = lost + 1;
+            return;
+        }
+    }
+
+    uint8_t record[TELEMETRY_MAX_RECORD];
+    uint8_t length = 0;
+    record[length++] = TELEMETRY_SYNC;
+    record[length++] = (id << 2) | argc;
+    length += putVarint(record + length, millis());
+    for (uint8_t i = 0; i < argc; ++i)
+    {
+        length += putVarint(record + length, ((uint32_t)args[i] << 1) ^ (uint32_t)(args[i] >> 31)); // Zigzag: small negatives stay short
+    }
+
+    if (length > freeSpace())
+    {
+        ++dropped;
+        return;
+    }
+    for (uint8_t i = 0; i < length; ++i)
+    {
+        buffer[head] = record[i];
+        head = (head + 1) & TELEMETRY_MASK;
+    }
+}
+
+#if TELEMETRY_TEXT
+
+uint32_t Telemetry::popVarint()
+{
+    uint32_t value = 0;
+    uint8_t shift = 0;
+    uint8_t byte;
+    do
+    {
+        byte = buffer[tail];
+        tail = (tail + 1) & TELEMETRY_MASK;
+        value |= (uint32_t)(byte & 0x7F) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+    return value;
+}
+
+// Pops one record and renders it as "<millis> <message>\r\n" into line
+void Telemetry::formatNext()
+{
+    tail = (tail + 1) & TELEMETRY_MASK; // Sync
+    uint8_t idArgc = buffer[tail];
+    tail = (tail + 1) & TELEMETRY_MASK;
+    uint32_t timestamp = popVarint();
+    int32_t args[TELEMETRY_MAX_ARGS];
+    uint8_t argc = idArgc & 3;
+    for (uint8_t i = 0; i < argc; ++i)
+    {
+        uint32_t zigzag = popVarint();
+        args[i] = (int32_t)(zigzag >> 1) ^ -(int32_t)(zigzag & 1);
+    }
+
+    ultoa(timestamp, line, 10);
+    lineLength = strlen(line);
+    line[lineLength++] = ' ';
+
+    const char *format = (const char *)pgm_read_ptr(&formats[idArgc >> 2]);
+    uint8_t arg = 0;
+    char c;
+    while ((c = pgm_read_byte(format++)) != '\0' && lineLength < sizeof(line) - 13)
+    {
+        if (c != '%')
+        {
+            line[lineLength++] = c;
+            continue;
+        }
+        c = pgm_read_byte(format++);
+        if (c == '%' || arg >= argc)
+        {
+            line[lineLength++] = '%';
+            continue;
+        }
+        if (c == 'd')
+            ltoa(args[arg++], line + lineLength, 10);
+        else
+            ultoa((uint32_t)args[arg++], line + lineLength, c == 'x' ? 16 : 10);
+        lineLength += strlen(line + lineLength);
+    }
+    line[lineLength++] = '\r';
+    line[lineLength++] = '\n';
+    lineSent = 0;
+}
+
+void Telemetry::drain()
+{
+    while (true)
+    {
+        if (lineSent == lineLength)
+        {
+            if (tail == head)
+                return;
+            formatNext();
+        }
+        int room = Serial.availableForWrite();
+        if (room <= 0)
+            return;
+        uint8_t n = min(room, lineLength - lineSent);
+        Serial.write((const uint8_t *)line + lineSent, n);
+        lineSent += n;
+    }
+}
+
+#else
+
+void Telemetry::drain()
+{
+    while (tail != head)
+    {
+        // Contiguous run up to the write index or the end of the buffer
+        uint8_t run = head > tail ? head - tail : TELEMETRY_BUFFER_SIZE - tail;
+        uint8_t n = serialLink.sendEvents(buffer + tail, run);
+        if (n == 0)
+            return;
+        tail = (tail + n) & TELEMETRY_MASK;
+    }
+}
+
+#endif
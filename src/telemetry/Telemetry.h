@@ -0,0 +1,135 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <Arduino.h>
+#include "telemetry/TelemetryEvents.h"
+
+#define TELEMETRY_LEVEL_OFF 0
+#define TELEMETRY_LEVEL_ERROR 1
+#define TELEMETRY_LEVEL_WARN 2
+#define TELEMETRY_LEVEL_INFO 3
+#define TELEMETRY_LEVEL_DEBUG 4
+
+// Events above this level compile to nothing, arguments included
+#ifndef TELEMETRY_LEVEL
+#define TELEMETRY_LEVEL TELEMETRY_LEVEL_INFO
+#endif
+
+// 0: binary records for tools/telemetry_decode.py, 1: plain text lines for a
+// serial monitor, formatted on the way out from the table in flash
+#ifndef TELEMETRY_TEXT
+#define TELEMETRY_TEXT 0
+#endif
+
+#define TELEMETRY_BAUD 115200
+#define TELEMETRY_BUFFER_SIZE 128 // Power of two
+#define TELEMETRY_MAX_ARGS 3
+#define TELEMETRY_SYNC 0xA5
+// Sync, id/argc, timestamp and arguments as LEB128 varints of up to 5 bytes
+#define TELEMETRY_MAX_RECORD (2 + 5 * (1 + TELEMETRY_MAX_ARGS))
+
+// Conversions in a format, "%%" aside
+constexpr uint8_t telemetryFormatArgs(const char *format)
+{
+    return *format == '\0' ? 0
+           : *format != '%' ? telemetryFormatArgs(format + 1)
+           : format[1] == '%' ? telemetryFormatArgs(format + 2)
+                              : 1 + telemetryFormatArgs(format + 1);
+}
+
+// Arguments given to TELEMETRY(), counted without evaluating them
+template <uint8_t N>
+struct TelemetryArgCount
+{
+    static const uint8_t value = N;
+};
+template <typename... Args>
+TelemetryArgCount<sizeof...(Args)> telemetryArgs(Args...);
+
+#define TELEMETRY_ID(name, level, format) TELEMETRY_##name,
+#define TELEMETRY_LEVEL_OF(name, level, format) TELEMETRY_##name##_LEVEL = TELEMETRY_LEVEL_##level,
+#define TELEMETRY_ARGS_OF(name, level, format) TELEMETRY_##name##_ARGS = telemetryFormatArgs(format),
+#define TELEMETRY_CHECK_ARGS(name, level, format) \
+    static_assert(telemetryFormatArgs(format) <= TELEMETRY_MAX_ARGS, "TELEMETRY_" #name "'s format takes more than TELEMETRY_MAX_ARGS arguments");
+enum TelemetryEvent : uint8_t
+{
+    TELEMETRY_EVENTS(TELEMETRY_ID)
+    TELEMETRY_EVENT_COUNT
+};
+enum TelemetryEventLevel
+{
+    TELEMETRY_EVENTS(TELEMETRY_LEVEL_OF)
+};
+enum TelemetryEventArgs
+{
+    TELEMETRY_EVENTS(TELEMETRY_ARGS_OF)
+};
+TELEMETRY_EVENTS(TELEMETRY_CHECK_ARGS)
+#undef TELEMETRY_ID
+#undef TELEMETRY_LEVEL_OF
+#undef TELEMETRY_ARGS_OF
+#undef TELEMETRY_CHECK_ARGS
+
+// The second byte of a record is id << 2 | argc
+static_assert(TELEMETRY_EVENT_COUNT <= 64, "Event ids have 6 bits in a record");
+static_assert(TELEMETRY_MAX_ARGS <= 3, "Argument counts have 2 bits in a record");
+
+#define TELEMETRY_ENABLED(event) (TELEMETRY_##event##_LEVEL <= TELEMETRY_LEVEL)
+
+// TELEMETRY(POUR, recipe, millis) queues a POUR record if its level is
+// compiled in; the arguments have to match the conversions in its format
+#define TELEMETRY(event, ...)                                                              \
+    do                                                                                     \
+    {                                                                                      \
+        static_assert(decltype(telemetryArgs(__VA_ARGS__))::value == TELEMETRY_##event##_ARGS, \
+                      "TELEMETRY(" #event "): arguments don't match its format");         \
+        if (TELEMETRY_##event##_LEVEL <= TELEMETRY_LEVEL)                                  \
+            telemetry.log(TELEMETRY_##event, ##__VA_ARGS__);                               \
+    } while (0)
+
+/**
+ * Allocation-free event log. log() encodes a record into a fixed ring
+ * buffer and never blocks; drain() runs from the scheduler's idle hook and
+ * hands the serial link as much as its transmit buffer has room for, as
+ * LINK_EVENTS frames (text builds write lines straight to Serial).
+ * When the ring is full, records are counted and reported as DROPPED.
+ * Main-loop context only: nothing here is safe to call from an ISR.
+ *
+ * Record: 0xA5, id << 2 | argc, millis, args (zigzag), all but the first
+ * two bytes as LEB128 varints.
+ */
+class Telemetry
+{
+public:
+    void begin();
+    void log(uint8_t id);
+    void log(uint8_t id, int32_t a);
+    void log(uint8_t id, int32_t a, int32_t b);
+    void log(uint8_t id, int32_t a, int32_t b, int32_t c);
+    void drain();
+
+    uint16_t dropped = 0; // Since the last DROPPED record
+
+private:
+    uint8_t buffer[TELEMETRY_BUFFER_SIZE];
+    uint8_t head = 0; // Next byte written
+    uint8_t tail = 0; // Next byte drained
+#if TELEMETRY_TEXT
+    char line[64];
+    uint8_t lineLength = 0;
+    uint8_t lineSent = 0;
+    void formatNext();
+    uint32_t popVarint();
+#endif
+
+    void push(uint8_t id, uint8_t argc, const int32_t *args);
+    uint8_t freeSpace() const;
+    static uint8_t putVarint(uint8_t *out, uint32_t value);
+#if TELEMETRY_TEXT
+    static void onIdle();
+#endif
+};
+
+extern Telemetry telemetry;
+
+#endif // TELEMETRY_H
@@ -0,0 +1,45 @@
+// Telemetry event table. Each entry is X(name, level, format): the record id
+// is the entry's position, so only ever append, and keep the format's %d/%u/%x
+// count equal to the arguments logged (at most TELEMETRY_MAX_ARGS, at most
+// 64 events); Telemetry.h fails the build otherwise.
+// tools/telemetry_decode.py reads this file to turn records back into text.
+#ifndef TELEMETRY_EVENTS_H
+#define TELEMETRY_EVENTS_H
+
+#define TELEMETRY_EVENTS(X)                                                        \
+    X(DROPPED, ERROR, "%u records dropped, buffer full")                          \
+    X(BOOT, INFO, "Dispenser starting")                                           \
+    X(SCHED_FULL, ERROR, "Scheduler full, task dropped")                          \
+    X(PUMP_UNCALIBRATED, WARN, "Pump %u not calibrated, using defaults")          \
+    X(PUMP_CALIBRATED, INFO, "Pump %u calibrated: prime=%ums, rate=%u/256 ms/ml") \
+    X(CAL_REJECTED, WARN, "Calibration rejected, long run must pour more")        \
+    X(PUMP_JITTER, INFO, "Pump %u jitter: start=%dus, stop=%dus")                 \
+    X(POUR, INFO, "Dispensing recipe %u, planned %ums")                           \
+    X(BUTTON, INFO, "Button pressed: action=%u arg=%u")                           \
+    X(LED_MODE, INFO, "LED mode %u")                                              \
+    X(ACTIVE_TIMEOUT, INFO, "No touch for %ums, returning to IDLE")               \
+    X(SCREEN_RENDER, DEBUG, "Screen render pushed %u bytes in %uus")              \
+    X(EYE_PIXELS, DEBUG, "Eye pixels/frame: last=%u, avg=%u")                     \
+    X(TOUCH_PRESS, DEBUG, "Touch press x=%d y=%d z=%u")                           \
+    X(TOUCH_RELEASE, DEBUG, "Touch release x=%d y=%d")                            \
+    X(BUS_LOAD, DEBUG, "Resource %u busy %u/1000, %u slots deferred")             \
+    X(ORDER_QUEUED, INFO, "Recipe %u queued, %u waiting")                         \
+    X(ORDER_REFUSED, WARN, "Recipe %u refused, queue full")                       \
+    X(ORDER_STARTED, INFO, "Recipe %u started after %ums in the queue")           \
+    X(ORDER_STATS, INFO, "%u drinks served, %u/h, longest wait %ums")             \
+    X(PUMP_PRIMED, DEBUG, "Pump %u primed for %ums")                              \
+    X(SERVO_MOVE, DEBUG, "Servo to %u deg, %ums")                                 \
+    X(PUMP_TRICKLE, INFO, "Pump %u trickle: duty=%u, rate=%u/256 ms/ml")          \
+    X(INVENTORY_LOADED, INFO, "Inventory seq %u from slot %u of %u")              \
+    X(INVENTORY_BLANK, WARN, "No inventory journal, reservoirs taken as full")    \
+    X(INVENTORY_SAVED, DEBUG, "Inventory seq %u saved to slot %u")                \
+    X(RESERVOIR_LOW, WARN, "Pump %u reservoir low: %u ml left")                   \
+    X(RESERVOIR_FILLED, INFO, "Pump %u reservoir filled to %u ml")                \
+    X(RECIPE_BLOCKED, WARN, "Recipe %u blocked: pump %u has %u ml")               \
+    X(READY, INFO, "Ready %ums after reset")                                      \
+    X(DISPLAY_UNCHECKED, WARN, "Display mode reads 0x%x, health check off")       \
+    X(DISPLAY_FAULT, ERROR, "Display mode read 0x%x, reinitialised in %ums")      \
+    X(MEMORY, INFO, "RAM: %u bytes static, %u free, %u never used")               \
+    X(STACK_LOW, WARN, "Stack headroom down to %u bytes, %u free now")
+
+#endif // TELEMETRY_EVENTS_H
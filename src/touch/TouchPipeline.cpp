@@ -0,0 +1,160 @@
+#include <Arduino.h>
+#include "touch/TouchPipeline.h"
+#include "sched/BusArbiter.h"
+#include "sched/PerfStats.h"
+
+#define TOUCH_QUEUE_MASK (TOUCH_QUEUE_SIZE - 1)
+
+volatile bool TouchPipeline::woken = false;
+
+bool TouchQueue::push(const TouchEvent &event)
+{
+    uint8_t next = (head + 1) & TOUCH_QUEUE_MASK;
+    if (next == tail)
+        return false;
+    events[head] = event;
+    head = next; // Publish only once the event is in place
+    return true;
+}
+
+bool TouchQueue::pop(TouchEvent &event)
+{
+    if (tail == head)
+        return false;
+    event = events[tail];
+    tail = (tail + 1) & TOUCH_QUEUE_MASK;
+    return true;
+}
+
+TouchPipeline::TouchPipeline(XPT2046_Touchscreen *ts, uint8_t irqPin)
+{
+    this->ts = ts;
+    this->irqPin = irqPin;
+}
+
+void TouchPipeline::begin()
+{
+    pinMode(irqPin, INPUT_PULLUP);
+    attachInterrupt(digitalPinToInterrupt(irqPin), onIrq, FALLING);
+    woken = digitalRead(irqPin) == LOW; // Already pressed, no edge to wait for
+}
+
+void TouchPipeline::onIrq()
+{
+    woken = true;
+}
+
+void TouchPipeline::onSample(void *context)
+{
+    PERF_SCOPE(PERF_TOUCH);
+    static_cast<TouchPipeline *>(context)->sample();
+}
+
+void TouchPipeline::service()
+{
+    if (!woken || scheduler.pending(sampleTask))
+        return;
+    woken = false;
+    sampleTask = scheduler.every(TOUCH_SAMPLE_PERIOD, onSample, this, TOUCH_SAMPLE_PERIOD);
+    sample();
+}
+
+void TouchPipeline::sample()
+{
+    if (!arbiter.acquire(ARBITER_TOUCH))
+        return; // Bus taken; the next period samples instead
+    TS_Point p = ts->getPoint();
+    arbiter.release(ARBITER_TOUCH);
+    ++samplesRead;
+
+    if (p.z < TOUCH_Z_MIN)
+    {
+        if (++lightSamples >= TOUCH_RELEASE_SAMPLES)
+        {
+            if (pressed)
+                emit(TOUCH_RELEASE, reportedX, reportedY, 0);
+            stop();
+        }
+        return;
+    }
+    lightSamples = 0;
+    if (p.z > TOUCH_Z_MAX)
+        return; // A glitch, neither pressed nor lifted
+
+    windowX[windowNext] = p.x;
+    windowY[windowNext] = p.y;
+    windowZ[windowNext] = p.z;
+    windowNext = (windowNext + 1) % TOUCH_WINDOW;
+    if (windowCount < TOUCH_WINDOW)
+        ++windowCount;
+    if (windowCount < TOUCH_WINDOW)
+        return;
+
+    int16_t x = median(windowX);
+    int16_t y = median(windowY);
+    if (!pressed)
+    {
+        // A finger gives a tight cluster; noise and a second contact don't
+        int16_t minX = x, maxX = x, minY = y, maxY = y;
+        for (uint8_t i = 0; i < TOUCH_WINDOW; ++i)
+        {
+            minX = min(minX, windowX[i]);
+            maxX = max(maxX, windowX[i]);
+            minY = min(minY, windowY[i]);
+            maxY = max(maxY, windowY[i]);
+        }
+        if (maxX - minX > TOUCH_MAX_SPREAD || maxY - minY > TOUCH_MAX_SPREAD)
+            return;
+        pressed = true;
+        filteredX = (int32_t)x << TOUCH_IIR_SHIFT;
+        filteredY = (int32_t)y << TOUCH_IIR_SHIFT;
+        reportedX = x;
+        reportedY = y;
+        emit(TOUCH_PRESS, x, y, median(windowZ));
+        return;
+    }
+
+    filteredX += x - (filteredX >> TOUCH_IIR_SHIFT);
+    filteredY += y - (filteredY >> TOUCH_IIR_SHIFT);
+    x = filteredX >> TOUCH_IIR_SHIFT;
+    y = filteredY >> TOUCH_IIR_SHIFT;
+    if (abs(x - reportedX) >= TOUCH_MOVE_THRESHOLD || abs(y - reportedY) >= TOUCH_MOVE_THRESHOLD)
+    {
+        reportedX = x;
+        reportedY = y;
+        emit(TOUCH_MOVE, x, y, median(windowZ));
+    }
+}
+
+void TouchPipeline::emit(uint8_t type, int16_t x, int16_t y, uint16_t z)
+{
+    TouchEvent event = {type, x, y, z};
+    if (!queue.push(event))
+        ++droppedEvents;
+}
+
+void TouchPipeline::stop()
+{
+    scheduler.cancel(sampleTask);
+    pressed = false;
+    windowCount = 0;
+    windowNext = 0;
+    lightSamples = 0;
+    // Conversions toggle T_IRQ, so edges seen while sampling mean nothing.
+    // Between conversions the line is valid again: still low means still touched.
+    woken = digitalRead(irqPin) == LOW;
+}
+
+int16_t TouchPipeline::median(const int16_t *values)
+{
+    int16_t sorted[TOUCH_WINDOW];
+    for (uint8_t i = 0; i < TOUCH_WINDOW; ++i)
+    {
+        int16_t v = values[i];
+        uint8_t j = i;
+        for (; j > 0 && sorted[j - 1] > v; --j)
+            sorted[j] = sorted[j - 1];
+        sorted[j] = v;
+    }
+    return sorted[TOUCH_WINDOW / 2];
+}
@@ -0,0 +1,91 @@
+#ifndef TOUCH_PIPELINE_H
+#define TOUCH_PIPELINE_H
+
+#include <Arduino.h>
+#include <XPT2046_Touchscreen.h>
+#include "sched/Scheduler.h"
+
+#define TOUCH_SAMPLE_PERIOD 4 // ms; the XPT2046 library converts at most every 3 ms
+#define TOUCH_WINDOW 5        // Samples in the median window, also the press debounce
+#define TOUCH_RELEASE_SAMPLES 3 // Light samples in a row that lift the pen
+#define TOUCH_Z_MIN 1200      // Lighter than this is hover or a lifting finger
+#define TOUCH_Z_MAX 2400      // Harder than this is a glitch or a palm
+#define TOUCH_MAX_SPREAD 300  // Raw units (~25 px) the window may spread over and still press
+#define TOUCH_IIR_SHIFT 2     // Tracking filter: moves 1/4 of the way to each median
+#define TOUCH_MOVE_THRESHOLD 40 // Raw units (~3.5 px) before a move is reported
+#define TOUCH_QUEUE_SIZE 8    // Power of two
+
+enum TouchEventType
+{
+    TOUCH_PRESS,
+    TOUCH_MOVE,
+    TOUCH_RELEASE
+};
+
+// Positions are filtered raw panel coordinates, mapping is up to the UI
+struct TouchEvent
+{
+    uint8_t type;
+    int16_t x, y;
+    uint16_t z;
+};
+
+/**
+ * Single-producer, single-consumer event queue. One index is written by
+ * each side and both are single bytes, so neither needs interrupts masked.
+ */
+class TouchQueue
+{
+public:
+    bool push(const TouchEvent &event);
+    bool pop(TouchEvent &event);
+
+private:
+    TouchEvent events[TOUCH_QUEUE_SIZE];
+    volatile uint8_t head = 0; // Written by push()
+    volatile uint8_t tail = 0; // Written by pop()
+};
+
+/**
+ * Touch sampling driven by the XPT2046 T_IRQ line. The panel is not read at
+ * all until T_IRQ falls; then a task samples every TOUCH_SAMPLE_PERIOD ms,
+ * takes the median of the last TOUCH_WINDOW samples and tracks it with an
+ * IIR filter. A press needs a full window of samples inside the pressure
+ * band that agree within TOUCH_MAX_SPREAD; a release needs
+ * TOUCH_RELEASE_SAMPLES light ones. The task stops again after the release.
+ */
+class TouchPipeline
+{
+public:
+    TouchPipeline(XPT2046_Touchscreen *ts, uint8_t irqPin);
+    void begin();
+    void service(); // Starts sampling if T_IRQ fired; cheap otherwise
+    bool poll(TouchEvent &event) { return queue.pop(event); }
+
+    uint16_t droppedEvents = 0;
+    uint32_t samplesRead = 0;
+
+private:
+    XPT2046_Touchscreen *ts;
+    uint8_t irqPin;
+    TouchQueue queue;
+    TaskHandle sampleTask = TASK_NONE;
+
+    int16_t windowX[TOUCH_WINDOW], windowY[TOUCH_WINDOW], windowZ[TOUCH_WINDOW];
+    uint8_t windowCount = 0;
+    uint8_t windowNext = 0;
+    uint8_t lightSamples = 0;
+    bool pressed = false;
+    int32_t filteredX, filteredY; // Scaled by 1 << TOUCH_IIR_SHIFT
+    int16_t reportedX, reportedY;
+
+    static volatile bool woken;
+    static void onIrq();
+    static void onSample(void *context);
+    void sample();
+    void emit(uint8_t type, int16_t x, int16_t y, uint16_t z);
+    void stop();
+    static int16_t median(const int16_t *values);
+};
+
+#endif // TOUCH_PIPELINE_H
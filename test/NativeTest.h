@@ -0,0 +1,45 @@
+// Helpers shared by the test_native_* suites: the firmware's globals and a
+// finger and a clock to drive them with, as the bench in NativeMain.cpp does.
+#ifndef NATIVE_TEST_H
+#define NATIVE_TEST_H
+
+#include <Arduino.h>
+#include "Hal.h"
+#include "leds/LEDController.h"
+#include "pump/PumpBank.h"
+#include "screen/ScreenController.h"
+#include "servo/ServoController.h"
+
+extern LEDController ledController;
+extern ScreenController screen;
+extern ServoController servoController;
+extern PumpBank<PUMP_PINS> pumps;
+
+// Touch calibration from ScreenController.cpp
+static inline int16_t rawX(int16_t px) { return 200 + (int32_t)px * 3600 / 319; }
+static inline int16_t rawY(int16_t py) { return 200 + (int32_t)py * 3600 / 239; }
+
+// A finger on the glass for this long
+#define TAP_MILLIS 80
+
+// Virtual time that passes per loop() pass on top of modelled bus time
+#define LOOP_OVERHEAD_MICROS 50
+
+static inline void runFor(uint32_t ms)
+{
+    uint32_t end = millis() + ms;
+    while ((int32_t)(millis() - end) < 0)
+    {
+        loop();
+        hal::advanceMicros(LOOP_OVERHEAD_MICROS);
+    }
+}
+
+static inline void tap(int16_t px, int16_t py)
+{
+    hal::setTouch(rawX(px), rawY(py), 1800);
+    runFor(TAP_MILLIS);
+    hal::releaseTouch();
+}
+
+#endif // NATIVE_TEST_H
@@ -0,0 +1,111 @@
+// Per-draw traffic on the display bus: the pixels, bytes, windows and
+// transactions the bench in NativeMain.cpp prints, with the bounds each
+// draw path has to stay within. Runs in order, as a customer would.
+#include <unity.h>
+#include "../NativeTest.h"
+
+// Bytes an address window costs: CASET, PASET and RAMWR with their
+// arguments as upstream sends them, and RAMWR alone when nothing changed
+#define WINDOW_MAX_BYTES 11
+#define WINDOW_MIN_BYTES 1
+
+static const uint32_t SCREEN_PIXELS = 320UL * 240;
+
+void setUp()
+{
+    hal::resetDisplayStats();
+}
+
+void tearDown() {}
+
+// Bytes beyond the pixels themselves
+static uint32_t overheadBytes(const hal::DisplayStats &s)
+{
+    return s.bytes - 2 * s.pixels;
+}
+
+void test_cold_init_fills_once()
+{
+    hal::setChargeBusTime(true);
+    setup();
+    const hal::DisplayStats &s = hal::displayStats();
+    TEST_ASSERT_EQUAL_UINT32(SCREEN_PIXELS, s.pixels);
+    TEST_ASSERT_EQUAL_UINT32(1, s.windows);
+    TEST_ASSERT_EQUAL_UINT32(1, s.transactions);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(200, overheadBytes(s)); // The init sequence and one window
+}
+
+// The eye redraws only the runs that change; most windows move along one
+// row or column, so cost less than upstream's 11 bytes
+void test_idle_eye_traffic()
+{
+    runFor(10000);
+    const hal::DisplayStats &s = hal::displayStats();
+    TEST_ASSERT_GREATER_THAN_UINT32(0, s.pixels);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(200000, s.pixels);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(1200000, s.bytes); // 12% of the bus at 8 MHz
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(9 * s.windows, overheadBytes(s));
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(400, s.transactions);
+}
+
+// A menu change clears the screen once and draws the buttons over it,
+// each in the arbiter's display slot
+static void assertMenuChange(const hal::DisplayStats &s)
+{
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(SCREEN_PIXELS, s.pixels);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(SCREEN_PIXELS + SCREEN_PIXELS / 50, s.pixels);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(2, s.transactions);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(WINDOW_MIN_BYTES * s.windows, overheadBytes(s));
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(WINDOW_MAX_BYTES * s.windows, overheadBytes(s));
+}
+
+void test_wake_to_regular_menu()
+{
+    tap(85, 100);
+    runFor(200);
+    TEST_ASSERT_EQUAL(ACTIVE, screen.state());
+    assertMenuChange(hal::displayStats());
+}
+
+void test_regular_to_test_menu()
+{
+    tap(160, 220);
+    runFor(200);
+    TEST_ASSERT_EQUAL(ACTIVE, screen.state());
+    assertMenuChange(hal::displayStats());
+}
+
+void test_test_to_regular_menu()
+{
+    tap(130, 170);
+    runFor(200);
+    TEST_ASSERT_EQUAL(ACTIVE, screen.state());
+    assertMenuChange(hal::displayStats());
+}
+
+// Once pouring, a second of progress redraws only the bar and the strip
+void test_pour_progress_ticks()
+{
+    tap(85, 100);
+    runFor(1000);
+    TEST_ASSERT_EQUAL(DISPENSING, screen.state());
+    hal::resetDisplayStats();
+    runFor(1000);
+    const hal::DisplayStats &s = hal::displayStats();
+    TEST_ASSERT_GREATER_THAN_UINT32(0, s.pixels);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(4000, s.pixels);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(8000, s.bytes);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(WINDOW_MAX_BYTES * s.windows, overheadBytes(s));
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_cold_init_fills_once);
+    RUN_TEST(test_idle_eye_traffic);
+    RUN_TEST(test_wake_to_regular_menu);
+    RUN_TEST(test_regular_to_test_menu);
+    RUN_TEST(test_test_to_regular_menu);
+    RUN_TEST(test_pour_progress_ticks);
+    return UNITY_END();
+}
@@ -0,0 +1,207 @@
+// Inventory journal recovery against the native EEPROM: the newest record
+// across a sequence wrap, torn and half-written records, a blank EEPROM;
+// and the calibration runs taken off the levels like pours.
+#include <unity.h>
+#include "../NativeTest.h"
+#include <EEPROM.h>
+#include "pump/PumpCalibration.h"
+#include "recipes/Inventory.h"
+#include "sched/Scheduler.h"
+
+static uint16_t recordBytes()
+{
+    return Inventory::address(1) - Inventory::address(0);
+}
+
+// One scheduler pass, which services the journal from idle time
+static void idlePass()
+{
+    scheduler.run();
+    hal::advanceMicros(1000);
+}
+
+static void eraseJournal()
+{
+    for (uint16_t a = INVENTORY_EEPROM_ADDRESS; a < INVENTORY_EEPROM_END; ++a)
+        EEPROM.write(a, 0xFF);
+    inventory.load();
+}
+
+// Sets a bottle size on pump 1 and lets the batch time pass: the next
+// idle pass starts the record, and each one after it writes a byte
+static void startSave(uint16_t capacityMl)
+{
+    inventory.refill(0, capacityMl);
+    hal::advanceMillis(INVENTORY_BATCH_MILLIS);
+}
+
+static void save(uint16_t capacityMl)
+{
+    startSave(capacityMl);
+    for (uint16_t i = 0; i <= recordBytes() && !inventory.saved(); ++i)
+        idlePass();
+    TEST_ASSERT_TRUE(inventory.saved());
+}
+
+// What a reboot would find
+static Inventory reboot()
+{
+    Inventory loaded;
+    TEST_ASSERT_TRUE(loaded.load());
+    return loaded;
+}
+
+void setUp()
+{
+    eraseJournal();
+}
+
+void tearDown() {}
+
+void test_blank_eeprom_reads_full()
+{
+    Inventory loaded;
+    TEST_ASSERT_FALSE(loaded.load());
+    for (uint8_t i = 0; i < PUMP_COUNT; ++i)
+    {
+        TEST_ASSERT_EQUAL_UINT16(INVENTORY_RESERVOIR_ML, loaded.reservoir(i).capacityMl);
+        TEST_ASSERT_EQUAL_UINT16(INVENTORY_RESERVOIR_ML, loaded.remainingMl(i));
+        TEST_ASSERT_EQUAL_UINT32(0, loaded.reservoir(i).pouredMl);
+    }
+    TEST_ASSERT_EQUAL_UINT16(Inventory::slotCount() - 1, loaded.slot);
+
+    save(500); // The first record goes to slot 0
+    TEST_ASSERT_EQUAL_UINT16(0, inventory.slot);
+    TEST_ASSERT_EQUAL_UINT16(1, inventory.sequence);
+}
+
+// The journal's slots and sequence numbers both wrap: the newest record
+// is the one in slot 1, numbered 1, not slot N-1's 0xFFFF
+void test_newest_across_sequence_wrap()
+{
+    inventory.slot = Inventory::slotCount() - 2;
+    inventory.sequence = 0xFFFE;
+    save(500);
+    save(600);
+    save(700);
+    TEST_ASSERT_EQUAL_UINT16(1, inventory.slot);
+
+    Inventory loaded = reboot();
+    TEST_ASSERT_EQUAL_UINT16(1, loaded.sequence);
+    TEST_ASSERT_EQUAL_UINT16(1, loaded.slot);
+    TEST_ASSERT_EQUAL_UINT16(700, loaded.reservoir(0).capacityMl);
+}
+
+void test_rotation_over_every_slot()
+{
+    for (uint16_t i = 0; i < Inventory::slotCount() + 3; ++i)
+        save(100 + i);
+    Inventory loaded = reboot();
+    TEST_ASSERT_EQUAL_UINT16(2, loaded.slot);
+    TEST_ASSERT_EQUAL_UINT16(Inventory::slotCount() + 3, loaded.sequence);
+    TEST_ASSERT_EQUAL_UINT16(100 + Inventory::slotCount() + 2, loaded.reservoir(0).capacityMl);
+}
+
+// A record whose CRC fails is passed over for the one before it
+void test_torn_record_skipped()
+{
+    save(500);
+    save(600);
+    uint16_t corrupt = Inventory::address(inventory.slot) + recordBytes() / 2;
+    EEPROM.write(corrupt, EEPROM.read(corrupt) ^ 0x10);
+
+    Inventory loaded = reboot();
+    TEST_ASSERT_EQUAL_UINT16(1, loaded.sequence);
+    TEST_ASSERT_EQUAL_UINT16(0, loaded.slot);
+    TEST_ASSERT_EQUAL_UINT16(500, loaded.reservoir(0).capacityMl);
+}
+
+// Power lost with half a record written: the previous one still loads,
+// and the finished write replaces it
+void test_interrupted_save_keeps_previous()
+{
+    save(500);
+    startSave(900);
+    for (uint16_t i = 0; i <= recordBytes() / 2; ++i)
+        idlePass();
+    TEST_ASSERT_FALSE(inventory.saved());
+
+    Inventory loaded = reboot();
+    TEST_ASSERT_EQUAL_UINT16(1, loaded.sequence);
+    TEST_ASSERT_EQUAL_UINT16(500, loaded.reservoir(0).capacityMl);
+
+    for (uint16_t i = 0; i < recordBytes() && !inventory.saved(); ++i)
+        idlePass();
+    TEST_ASSERT_TRUE(inventory.saved());
+    loaded = reboot();
+    TEST_ASSERT_EQUAL_UINT16(2, loaded.sequence);
+    TEST_ASSERT_EQUAL_UINT16(900, loaded.reservoir(0).capacityMl);
+}
+
+// Nothing is written while a pump runs, and a pour is in the next record
+void test_pour_saved_once_quiet()
+{
+    save(500);
+    uint16_t volume = 400; // Longer than the batch time
+    uint32_t runMillis = pumps[0].dispenseVolume(volume);
+    TEST_ASSERT_GREATER_THAN_UINT32(INVENTORY_BATCH_MILLIS, runMillis);
+    idlePass(); // Picks the pour up
+    hal::advanceMillis(INVENTORY_BATCH_MILLIS);
+    for (uint8_t i = 0; i < 10; ++i)
+        idlePass();
+    TEST_ASSERT_TRUE(pumps[0].busy());
+    TEST_ASSERT_FALSE(inventory.saved());
+    TEST_ASSERT_EQUAL_UINT32(1, reboot().sequence);
+
+    hal::advanceMillis(runMillis - INVENTORY_BATCH_MILLIS);
+    for (uint16_t i = 0; i <= 2 * recordBytes() && !inventory.saved(); ++i)
+        idlePass();
+    Inventory loaded = reboot();
+    TEST_ASSERT_EQUAL_UINT16(2, loaded.sequence);
+    TEST_ASSERT_EQUAL_UINT16(500 - volume, loaded.reservoir(0).remainingMl);
+    TEST_ASSERT_EQUAL_UINT32(1, loaded.reservoir(0).pours);
+}
+
+// Calibration runs pour real liquid: each comes off the reservoir as the
+// profile in force predicts, whether or not the calibration is saved
+void test_calibration_runs_taken_off()
+{
+    const PumpProfile saved = pumps[0].profile;
+    pumps[0].profile = {400, 25 << 8, 60 << 8, PUMP_TRICKLE_DUTY, PUMP_TRICKLE_ML};
+    uint32_t pours = inventory.reservoir(0).pours;
+    TEST_ASSERT_EQUAL(IDLE, screen.state());
+    tap(85, 100); // Wakes to the recipes
+    runFor(200);
+    tap(160, 220); // Test menu
+    runFor(200);
+    tap(215, 55); // Cal 1
+    runFor(200);
+
+    tap(65, 60); // 2 s: 1600 ms once primed, at 25 ms/ml
+    runFor(PUMP_CAL_SHORT_RUN_MILLIS + 100);
+    TEST_ASSERT_EQUAL_UINT16(INVENTORY_RESERVOIR_ML - 64, inventory.remainingMl(0));
+    tap(255, 60); // Trickle: primes, then 4 s at 60 ms/ml
+    runFor(400 + PUMP_CAL_TRICKLE_RUN_MILLIS + 100);
+    tap(160, 60); // 8 s
+    runFor(PUMP_CAL_LONG_RUN_MILLIS + 100);
+    TEST_ASSERT_FALSE(pumps[0].busy());
+
+    TEST_ASSERT_EQUAL_UINT16(INVENTORY_RESERVOIR_ML - 64 - 66 - 304, inventory.reservoir(0).remainingMl);
+    TEST_ASSERT_EQUAL_UINT32(pours + 3, inventory.reservoir(0).pours);
+    TEST_ASSERT_EQUAL_UINT16(INVENTORY_RESERVOIR_ML, inventory.remainingMl(1));
+    pumps[0].profile = saved;
+}
+
+int main(int argc, char **argv)
+{
+    setup();
+    UNITY_BEGIN();
+    RUN_TEST(test_blank_eeprom_reads_full);
+    RUN_TEST(test_newest_across_sequence_wrap);
+    RUN_TEST(test_rotation_over_every_slot);
+    RUN_TEST(test_torn_record_skipped);
+    RUN_TEST(test_interrupted_save_keeps_previous);
+    RUN_TEST(test_pour_saved_once_quiet);
+    RUN_TEST(test_calibration_runs_taken_off);
+    return UNITY_END();
+}
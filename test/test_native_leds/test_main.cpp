@@ -0,0 +1,118 @@
+// Strip length at run time: the 144-pixel bar keeps to the frame period and
+// the blackout budget, and pixels a shorter length cuts off are blanked
+// inside an arbiter slot, never across a pump deadline.
+#include <unity.h>
+#include "../NativeTest.h"
+#include <EEPROM.h>
+#include "pump/PumpTimer.h"
+#include "sched/BusArbiter.h"
+
+#define BAR_PIXELS 144
+#define IDLE_STEP_MILLIS 100 // The idle wipe moves a pixel per step
+#define WINDOW_MILLIS 2000
+
+static uint16_t storedLength()
+{
+    uint16_t length;
+    EEPROM.get(LED_LENGTH_EEPROM_ADDRESS, length);
+    return length;
+}
+
+void setUp()
+{
+    ledController.setMode(IDLE_LEDS);
+}
+
+void tearDown() {}
+
+void test_grow_to_bar()
+{
+    TEST_ASSERT_TRUE(ledController.setLength(BAR_PIXELS));
+    TEST_ASSERT_EQUAL_UINT16(BAR_PIXELS, storedLength());
+    runFor(1); // The first frame goes out at once
+    TEST_ASSERT_EQUAL_INT(BAR_PIXELS, FastLED[0].count);
+
+    uint32_t frames = FastLED.frames;
+    uint32_t blackout = FastLED.blackoutMicros;
+    runFor(WINDOW_MILLIS);
+    frames = FastLED.frames - frames;
+    blackout = FastLED.blackoutMicros - blackout;
+    TEST_ASSERT_UINT32_WITHIN(1, WINDOW_MILLIS / IDLE_STEP_MILLIS, frames);
+    TEST_ASSERT_EQUAL_UINT32(frames * BAR_PIXELS * LED_MICROS_PER_PIXEL, blackout);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(WINDOW_MILLIS * 10UL * LED_MAX_BLACKOUT_PERCENT, blackout);
+}
+
+// One push of the whole bar, black past the ring, then the ring alone
+void test_shrink_blanks_in_slot()
+{
+    ledController.setLength(BAR_PIXELS);
+    runFor(200);
+    uint32_t slots = arbiter.stats[ARBITER_LED].slots;
+    uint32_t frames = FastLED.frames;
+    uint32_t blackout = FastLED.blackoutMicros;
+
+    TEST_ASSERT_TRUE(ledController.setLength(LED_COUNT));
+    TEST_ASSERT_EQUAL_UINT32(frames, FastLED.frames); // Nothing pushed outside update()
+    runFor(1);
+    TEST_ASSERT_EQUAL_UINT32(frames + 1, FastLED.frames);
+    TEST_ASSERT_EQUAL_UINT32(BAR_PIXELS * LED_MICROS_PER_PIXEL, FastLED.blackoutMicros - blackout);
+    for (uint16_t i = LED_COUNT; i < BAR_PIXELS; ++i)
+        TEST_ASSERT_TRUE(FastLED[0].leds[i] == CRGB(CRGB::Black));
+
+    uint32_t ringFrames = FastLED.frames;
+    uint32_t ringBlackout = FastLED.blackoutMicros;
+    runFor(WINDOW_MILLIS);
+    TEST_ASSERT_UINT32_WITHIN(1, WINDOW_MILLIS / IDLE_STEP_MILLIS, FastLED.frames - ringFrames);
+    TEST_ASSERT_EQUAL_UINT32((FastLED.frames - ringFrames) * LED_COUNT * LED_MICROS_PER_PIXEL, FastLED.blackoutMicros - ringBlackout);
+    TEST_ASSERT_EQUAL_UINT32(FastLED.frames - frames, arbiter.stats[ARBITER_LED].slots - slots); // Every push had a slot
+}
+
+// The blanking push waits for a pump that stops inside its blackout
+void test_blanking_waits_for_pump_deadline()
+{
+    ledController.setLength(BAR_PIXELS);
+    runFor(200);
+    uint32_t frames = FastLED.frames;
+    uint32_t blackout = FastLED.blackoutMicros;
+    uint32_t deferred = arbiter.stats[ARBITER_LED].deferred;
+
+    pumps[0].runFor(3);
+    ledController.setLength(LED_COUNT);
+    runFor(1);
+    TEST_ASSERT_TRUE(pumps[0].busy());
+    TEST_ASSERT_EQUAL_UINT32(frames, FastLED.frames);
+    TEST_ASSERT_GREATER_THAN_UINT32(deferred, arbiter.stats[ARBITER_LED].deferred);
+
+    runFor(20);
+    TEST_ASSERT_FALSE(pumps[0].busy());
+    TEST_ASSERT_LESS_OR_EQUAL_INT32(PUMP_TIMER_TICK_MICROS, pumps[0].stopJitterMicros);
+    TEST_ASSERT_EQUAL_UINT32(frames + 1, FastLED.frames);
+    TEST_ASSERT_EQUAL_UINT32(BAR_PIXELS * LED_MICROS_PER_PIXEL, FastLED.blackoutMicros - blackout);
+}
+
+void test_length_kept_for_begin()
+{
+    ledController.setLength(BAR_PIXELS);
+    ledController.begin();
+    TEST_ASSERT_EQUAL_UINT16(BAR_PIXELS, ledController.length());
+
+    TEST_ASSERT_FALSE(ledController.setLength(LED_CAPACITY + 1));
+    TEST_ASSERT_EQUAL_UINT16(BAR_PIXELS, ledController.length());
+    TEST_ASSERT_EQUAL_UINT16(BAR_PIXELS, storedLength());
+
+    EEPROM.put(LED_LENGTH_EEPROM_ADDRESS, (uint16_t)0xFFFF); // Never set
+    ledController.begin();
+    TEST_ASSERT_EQUAL_UINT16(LED_COUNT, ledController.length());
+}
+
+int main(int argc, char **argv)
+{
+    setup();
+    runFor(1000);
+    UNITY_BEGIN();
+    RUN_TEST(test_grow_to_bar);
+    RUN_TEST(test_shrink_blanks_in_slot);
+    RUN_TEST(test_blanking_waits_for_pump_deadline);
+    RUN_TEST(test_length_kept_for_begin);
+    return UNITY_END();
+}
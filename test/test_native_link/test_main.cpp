@@ -0,0 +1,370 @@
+// Serial link: the COBS/CRC framing on its own, then requests driven
+// through the native UART against the running firmware.
+#include <unity.h>
+#include "../NativeTest.h"
+#include "link/SerialLink.h"
+#include "recipes/Inventory.h"
+
+// A host keeping this many pings of this size in flight must get at least
+// this many replies a second through the 115200 baud UART
+#define PING_COUNT 300
+#define PING_WINDOW 2
+#define PING_ARGS 16
+#define MIN_REQUESTS_PER_SECOND 400
+
+#define REPLY_TIMEOUT_MILLIS 200
+#define PUMP_STATE_BYTES 13
+#define INVENTORY_BYTES 12
+
+// Long enough for several full COBS blocks
+#define LONG_PAYLOAD 600
+
+static uint8_t payload[LONG_PAYLOAD];
+static uint8_t frame[FRAME_ENCODED_SIZE(LONG_PAYLOAD)];
+
+template <typename Decoder>
+static uint16_t feedAll(Decoder &decoder, const uint8_t *bytes, uint16_t n)
+{
+    uint16_t good = 0;
+    for (uint16_t i = 0; i < n; ++i)
+        good += decoder.feed(bytes[i]);
+    return good;
+}
+
+static void assertEncoding(const uint8_t *bytes, uint16_t n, uint16_t length)
+{
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(FRAME_ENCODED_SIZE(length), n);
+    for (uint16_t i = 0; i + 1 < n; ++i)
+        TEST_ASSERT_NOT_EQUAL(0, bytes[i]);
+    TEST_ASSERT_EQUAL_HEX8(0, bytes[n - 1]);
+}
+
+void test_round_trip()
+{
+    FrameDecoder decoder;
+    const uint8_t fills[] = {0x00, 0x01, 0xFF, 0x55};
+    for (uint8_t fill : fills)
+    {
+        for (uint8_t length = 1; length <= FRAME_MAX_PAYLOAD; ++length)
+        {
+            for (uint8_t i = 0; i < length; ++i)
+                payload[i] = fill == 0x55 ? i * 37 : fill; // Zeros scattered, every 7th
+            uint16_t n = encodeFrame(payload, length, frame);
+            assertEncoding(frame, n, length);
+            TEST_ASSERT_EQUAL_UINT16(1, feedAll(decoder, frame, n));
+            TEST_ASSERT_EQUAL_UINT16(length, decoder.length());
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(payload, decoder.payload(), length);
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT16(0, decoder.errors);
+}
+
+// Runs of 254 or more non-zero bytes fill a block, whose 0xFF code byte
+// stands for no zero; runs that end on the boundary, and zeros right
+// after it, are where that goes wrong
+void test_round_trip_long_runs()
+{
+    static BasicFrameDecoder<LONG_PAYLOAD> decoder;
+    const uint16_t runs[] = {253, 254, 255, 508, 509, LONG_PAYLOAD};
+    for (uint16_t run : runs)
+    {
+        for (uint8_t zeroAfter = 0; zeroAfter < 2; ++zeroAfter)
+        {
+            uint16_t length = min((uint16_t)(run + zeroAfter + 3), (uint16_t)LONG_PAYLOAD);
+            for (uint16_t i = 0; i < length; ++i)
+                payload[i] = i < run ? 1 + i % 255 : i == run && zeroAfter ? 0 : 0x42;
+            uint16_t n = encodeFrame(payload, length, frame);
+            assertEncoding(frame, n, length);
+            if (run >= 254)
+                TEST_ASSERT_EQUAL_HEX8(0xFF, frame[0]);
+            TEST_ASSERT_EQUAL_UINT16(1, feedAll(decoder, frame, n));
+            TEST_ASSERT_EQUAL_UINT16(length, decoder.length());
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(payload, decoder.payload(), length);
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT16(0, decoder.errors);
+}
+
+void test_crc_mismatch_rejected()
+{
+    FrameDecoder decoder;
+    const uint8_t request[] = {LINK_PING, 7, 1, 2, 3, 4};
+    uint16_t n = encodeFrame(request, sizeof(request), frame);
+    for (uint16_t i = 0; i + 1 < n; ++i)
+    {
+        uint8_t saved = frame[i];
+        if (i > 0 && saved != 0xFF)
+        {
+            frame[i] = saved + 1; // Still valid COBS when it isn't a code byte
+            TEST_ASSERT_EQUAL_UINT16(0, feedAll(decoder, frame, n));
+        }
+        frame[i] = saved;
+    }
+    TEST_ASSERT_EQUAL_UINT16(0, decoder.frames);
+    TEST_ASSERT_EQUAL_UINT16(n - 2, decoder.errors);
+    TEST_ASSERT_EQUAL_UINT16(1, feedAll(decoder, frame, n));
+}
+
+void test_truncated_frame_rejected()
+{
+    FrameDecoder decoder;
+    const uint8_t request[] = {LINK_ORDER, 9, 0};
+    uint16_t n = encodeFrame(request, sizeof(request), frame);
+    for (uint16_t keep = 1; keep + 1 < n; ++keep)
+    {
+        feedAll(decoder, frame, keep);
+        TEST_ASSERT_FALSE(decoder.feed(0));
+    }
+    TEST_ASSERT_EQUAL_UINT16(0, decoder.frames);
+    TEST_ASSERT_EQUAL_UINT16(n - 2, decoder.errors);
+}
+
+// A frame too long for the buffer is dropped whole, and the next one,
+// started by its delimiter, comes through
+void test_recovery_after_over_length_frame()
+{
+    FrameDecoder decoder;
+    for (uint16_t i = 0; i < FRAME_MAX_PAYLOAD + 8; ++i)
+        payload[i] = i;
+    uint16_t n = encodeFrame(payload, FRAME_MAX_PAYLOAD + 8, frame);
+    TEST_ASSERT_EQUAL_UINT16(0, feedAll(decoder, frame, n));
+    TEST_ASSERT_EQUAL_UINT16(1, decoder.errors);
+
+    const uint8_t request[] = {LINK_PING, 1, 0xAA};
+    n = encodeFrame(request, sizeof(request), frame);
+    TEST_ASSERT_EQUAL_UINT16(1, feedAll(decoder, frame, n));
+    TEST_ASSERT_EQUAL_UINT16(sizeof(request), decoder.length());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(request, decoder.payload(), sizeof(request));
+}
+
+// A receiver that joins mid-frame drops what it caught and is in step
+// at the next frame
+void test_joins_mid_stream()
+{
+    FrameDecoder decoder;
+    const uint8_t request[] = {LINK_PUMP_STATE, 3, 0};
+    uint16_t n = encodeFrame(request, sizeof(request), frame);
+    TEST_ASSERT_EQUAL_UINT16(0, feedAll(decoder, frame + 2, n - 2));
+    TEST_ASSERT_EQUAL_UINT16(1, feedAll(decoder, frame, n));
+}
+
+// The host end: every byte the firmware writes goes through this decoder
+static FrameDecoder host;
+static uint8_t reply[FRAME_MAX_PAYLOAD];
+static uint8_t replyLength;
+static uint32_t replies;
+static uint8_t nextSeq = 1;
+
+static void hostReceive(uint8_t c)
+{
+    if (!host.feed(c) || !(host.payload()[0] & LINK_REPLY))
+        return;
+    memcpy(reply, host.payload(), host.length());
+    replyLength = host.length();
+    ++replies;
+}
+
+static void send(uint8_t message, uint8_t seq, const uint8_t *args, uint8_t argCount)
+{
+    uint8_t request[FRAME_MAX_PAYLOAD] = {message, seq};
+    memcpy(request + LINK_HEADER, args, argCount);
+    uint8_t encoded[FRAME_MAX_ENCODED];
+    hal::serialReceive(encoded, encodeFrame(request, LINK_HEADER + argCount, encoded));
+}
+
+// Sends one request and runs the firmware until its reply is in; returns
+// the reply's data length, status in reply[2]
+static uint8_t request(uint8_t message, const uint8_t *args, uint8_t argCount)
+{
+    uint8_t seq = nextSeq++;
+    replyLength = 0;
+    send(message, seq, args, argCount);
+    uint32_t start = millis();
+    while (replyLength == 0 && millis() - start < REPLY_TIMEOUT_MILLIS)
+        runFor(1);
+    TEST_ASSERT_TRUE_MESSAGE(replyLength >= 3, "no reply");
+    TEST_ASSERT_EQUAL_HEX8(message | LINK_REPLY, reply[0]);
+    TEST_ASSERT_EQUAL_UINT8(seq, reply[1]);
+    return replyLength - 3;
+}
+
+static uint16_t get16(const uint8_t *in)
+{
+    return in[0] | (uint16_t)in[1] << 8;
+}
+
+static uint32_t get32(const uint8_t *in)
+{
+    return get16(in) | (uint32_t)get16(in + 2) << 16;
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+// Pings as the bench sends them, with the eye running
+void test_ping_throughput()
+{
+    uint32_t before = replies;
+    uint32_t sent = 0;
+    uint8_t args[PING_ARGS];
+    uint32_t start = millis();
+    while (replies - before < PING_COUNT && millis() - start < 10000)
+    {
+        while (sent < PING_COUNT && sent - (replies - before) < PING_WINDOW)
+        {
+            for (uint8_t i = 0; i < PING_ARGS; ++i)
+                args[i] = sent + i; // Zeros included, so COBS has work
+            send(LINK_PING, sent++, args, PING_ARGS);
+        }
+        runFor(1);
+    }
+    uint32_t elapsed = millis() - start;
+    TEST_ASSERT_EQUAL_UINT32(PING_COUNT, replies - before);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(MIN_REQUESTS_PER_SECOND, PING_COUNT * 1000UL / elapsed);
+    TEST_ASSERT_EQUAL_UINT16(0, serialLink.received().errors);
+    TEST_ASSERT_EQUAL_UINT16(0, host.errors);
+    TEST_ASSERT_EQUAL_UINT32(0, hal::serialOverruns());
+}
+
+void test_pump_state_paged()
+{
+    uint8_t first = 0;
+    uint8_t length = request(LINK_PUMP_STATE, nullptr, 0);
+    TEST_ASSERT_EQUAL_UINT8(LINK_OK, reply[2]);
+    TEST_ASSERT_EQUAL_UINT8(PUMP_COUNT, reply[3]);
+    uint8_t perPage = (length - 1) / PUMP_STATE_BYTES;
+    TEST_ASSERT_EQUAL_UINT8(1 + perPage * PUMP_STATE_BYTES, length);
+    TEST_ASSERT_TRUE(perPage >= 1);
+
+    // Every page down to the empty one past the last pump
+    for (first = 0; first <= PUMP_COUNT; ++first)
+    {
+        length = request(LINK_PUMP_STATE, &first, 1);
+        TEST_ASSERT_EQUAL_UINT8(LINK_OK, reply[2]);
+        uint8_t entries = min((uint8_t)(PUMP_COUNT - first), perPage);
+        TEST_ASSERT_EQUAL_UINT8(1 + entries * PUMP_STATE_BYTES, length);
+        for (uint8_t e = 0; e < entries; ++e)
+        {
+            const uint8_t *entry = reply + 4 + e * PUMP_STATE_BYTES;
+            const PumpController &pump = pumps[first + e];
+            TEST_ASSERT_EQUAL_UINT8(pump.busy(), entry[0]);
+            TEST_ASSERT_EQUAL_UINT32(pump.dispensedMl, get32(entry + 5));
+            TEST_ASSERT_EQUAL_UINT16(pump.profile.primeMillis, get16(entry + 9));
+            TEST_ASSERT_EQUAL_UINT16(pump.profile.msPerMlQ8, get16(entry + 11));
+        }
+    }
+
+    first = PUMP_COUNT + 1;
+    TEST_ASSERT_EQUAL_UINT8(0, request(LINK_PUMP_STATE, &first, 1));
+    TEST_ASSERT_EQUAL_UINT8(LINK_BAD_ARGS, reply[2]);
+}
+
+void test_order()
+{
+    uint32_t ordered = screen.orderQueue().stats.ordered;
+    uint8_t recipe = 0;
+    TEST_ASSERT_EQUAL_UINT8(1, request(LINK_ORDER, &recipe, 1));
+    TEST_ASSERT_EQUAL_UINT8(LINK_OK, reply[2]);
+    TEST_ASSERT_EQUAL_UINT8(screen.orderQueue().depth(), reply[3]);
+    TEST_ASSERT_EQUAL_UINT32(ordered + 1, screen.orderQueue().stats.ordered);
+    runFor(500);
+    TEST_ASSERT_EQUAL(DISPENSING, screen.state());
+
+    // The pump state shows the pour
+    uint8_t first = 0;
+    request(LINK_PUMP_STATE, &first, 1);
+    bool anyBusy = false;
+    for (uint8_t e = 0; e < min((uint8_t)PUMP_COUNT, (uint8_t)2); ++e)
+        anyBusy |= reply[4 + e * PUMP_STATE_BYTES] != 0;
+    TEST_ASSERT_TRUE(anyBusy);
+
+    recipe = 0xFF;
+    TEST_ASSERT_EQUAL_UINT8(0, request(LINK_ORDER, &recipe, 1));
+    TEST_ASSERT_EQUAL_UINT8(LINK_BAD_ARGS, reply[2]);
+    TEST_ASSERT_EQUAL_UINT32(ordered + 1, screen.orderQueue().stats.ordered);
+}
+
+void test_inventory_paged_and_refill()
+{
+    const uint8_t refill[] = {0, 750 & 0xFF, 750 >> 8};
+    TEST_ASSERT_EQUAL_UINT8(0, request(LINK_INVENTORY, refill, sizeof(refill)));
+    TEST_ASSERT_EQUAL_UINT8(LINK_OK, reply[2]);
+
+    uint8_t perPage = (request(LINK_INVENTORY, nullptr, 0) - 1) / INVENTORY_BYTES;
+    TEST_ASSERT_TRUE(perPage >= 1);
+    for (uint8_t first = 0; first <= PUMP_COUNT; ++first)
+    {
+        uint8_t length = request(LINK_INVENTORY, &first, 1);
+        TEST_ASSERT_EQUAL_UINT8(LINK_OK, reply[2]);
+        TEST_ASSERT_EQUAL_UINT8(PUMP_COUNT, reply[3]);
+        uint8_t entries = min((uint8_t)(PUMP_COUNT - first), perPage);
+        TEST_ASSERT_EQUAL_UINT8(1 + entries * INVENTORY_BYTES, length);
+        for (uint8_t e = 0; e < entries; ++e)
+        {
+            const uint8_t *entry = reply + 4 + e * INVENTORY_BYTES;
+            uint8_t pump = first + e;
+            TEST_ASSERT_EQUAL_UINT32(inventory.reservoir(pump).pouredMl, get32(entry));
+            TEST_ASSERT_EQUAL_UINT32(inventory.reservoir(pump).pours, get32(entry + 4));
+            TEST_ASSERT_EQUAL_UINT16(inventory.remainingMl(pump), get16(entry + 8));
+            TEST_ASSERT_EQUAL_UINT16(inventory.reservoir(pump).capacityMl, get16(entry + 10));
+        }
+        if (first == 0)
+            TEST_ASSERT_EQUAL_UINT16(750, get16(reply + 4 + 10));
+    }
+
+    const uint8_t badPump[] = {PUMP_COUNT, 100, 0};
+    TEST_ASSERT_EQUAL_UINT8(0, request(LINK_INVENTORY, badPump, sizeof(badPump)));
+    TEST_ASSERT_EQUAL_UINT8(LINK_BAD_ARGS, reply[2]);
+    const uint8_t empty[] = {0, 0, 0};
+    request(LINK_INVENTORY, empty, sizeof(empty));
+    TEST_ASSERT_EQUAL_UINT8(LINK_BAD_ARGS, reply[2]);
+}
+
+// The strip length, set from the link and read back
+void test_led_length()
+{
+    TEST_ASSERT_EQUAL_UINT8(4, request(LINK_LEDS, nullptr, 0));
+    TEST_ASSERT_EQUAL_UINT8(LINK_OK, reply[2]);
+    TEST_ASSERT_EQUAL_UINT16(LED_COUNT, get16(reply + 3));
+    TEST_ASSERT_EQUAL_UINT16(LED_CAPACITY, get16(reply + 5));
+
+    const uint8_t bar[] = {144, 0};
+    TEST_ASSERT_EQUAL_UINT8(4, request(LINK_LEDS, bar, sizeof(bar)));
+    TEST_ASSERT_EQUAL_UINT8(LINK_OK, reply[2]);
+    TEST_ASSERT_EQUAL_UINT16(144, get16(reply + 3));
+    TEST_ASSERT_EQUAL_UINT16(144, ledController.length());
+
+    const uint8_t tooLong[] = {(LED_CAPACITY + 1) & 0xFF, (LED_CAPACITY + 1) >> 8};
+    TEST_ASSERT_EQUAL_UINT8(0, request(LINK_LEDS, tooLong, sizeof(tooLong)));
+    TEST_ASSERT_EQUAL_UINT8(LINK_BAD_ARGS, reply[2]);
+    TEST_ASSERT_EQUAL_UINT8(0, request(LINK_LEDS, bar, 1));
+    TEST_ASSERT_EQUAL_UINT8(LINK_BAD_ARGS, reply[2]);
+    TEST_ASSERT_EQUAL_UINT16(144, ledController.length());
+
+    const uint8_t ring[] = {LED_COUNT, 0};
+    request(LINK_LEDS, ring, sizeof(ring));
+    TEST_ASSERT_EQUAL_UINT16(LED_COUNT, ledController.length());
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_round_trip);
+    RUN_TEST(test_round_trip_long_runs);
+    RUN_TEST(test_crc_mismatch_rejected);
+    RUN_TEST(test_truncated_frame_rejected);
+    RUN_TEST(test_recovery_after_over_length_frame);
+    RUN_TEST(test_joins_mid_stream);
+
+    hal::setChargeBusTime(true); // The UART competes with the display for loop time
+    hal::setSerialSink(hostReceive);
+    setup();
+    runFor(1000);
+    RUN_TEST(test_ping_throughput);
+    RUN_TEST(test_pump_state_paged);
+    RUN_TEST(test_order);
+    RUN_TEST(test_inventory_paged_and_refill);
+    RUN_TEST(test_led_length);
+    return UNITY_END();
+}
@@ -0,0 +1,121 @@
+// Pump cutoff timing: the pins the Timer2 tick switches, against the
+// deadlines a pour was armed with.
+#include <unity.h>
+#include "../NativeTest.h"
+#include "pump/PumpCalibration.h"
+#include "pump/PumpTimer.h"
+
+// 30 ms/ml at full drive, no priming and no trickle tail
+static const PumpProfile FLAT_PROFILE = {0, 30 << 8, 0, PUMP_TRICKLE_DUTY, 0};
+
+void setUp()
+{
+    pumps[0].profile = FLAT_PROFILE;
+}
+
+void tearDown()
+{
+    runFor(100); // Anything armed runs out before the next test
+}
+
+void test_stop_within_one_tick()
+{
+    PumpController &pump = pumps[0];
+    uint32_t highBefore = hal::pinHighMicros(A1);
+    uint32_t runMillis = pump.dispenseVolume(20);
+    TEST_ASSERT_EQUAL_UINT32(600, runMillis);
+
+    runFor(runMillis - 2);
+    TEST_ASSERT_TRUE(pump.running());
+    TEST_ASSERT_EQUAL_UINT8(HIGH, hal::pinLevel(A1));
+    runFor(3);
+    TEST_ASSERT_FALSE(pump.running());
+    TEST_ASSERT_EQUAL_UINT8(LOW, hal::pinLevel(A1));
+    TEST_ASSERT_FALSE(pump.busy());
+    TEST_ASSERT_GREATER_OR_EQUAL_INT32(-PUMP_TIMER_EARLY_MICROS, pump.stopJitterMicros);
+    TEST_ASSERT_LESS_OR_EQUAL_INT32(PUMP_TIMER_TICK_MICROS, pump.stopJitterMicros);
+
+    // Driven for the run, less what the soft start leaves out
+    uint32_t highMicros = hal::pinHighMicros(A1) - highBefore;
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(runMillis * 1000UL + PUMP_TIMER_TICK_MICROS, highMicros);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(runMillis * 1000UL - PUMP_RAMP_MILLIS * 1000UL, highMicros);
+}
+
+void test_delayed_start_on_time()
+{
+    PumpController &pump = pumps[0];
+    uint32_t highBefore = hal::pinHighMicros(A1);
+    pump.dispenseVolume(10, 200);
+    runFor(198);
+    TEST_ASSERT_TRUE(pump.busy());
+    TEST_ASSERT_EQUAL_UINT32(highBefore, hal::pinHighMicros(A1));
+    runFor(3);
+    TEST_ASSERT_GREATER_THAN_UINT32(highBefore, hal::pinHighMicros(A1)); // The soft start's first tick drives
+    TEST_ASSERT_GREATER_OR_EQUAL_INT32(-PUMP_TIMER_EARLY_MICROS, pump.startJitterMicros);
+    TEST_ASSERT_LESS_OR_EQUAL_INT32(PUMP_TIMER_TICK_MICROS, pump.startJitterMicros);
+    TEST_ASSERT_UINT32_WITHIN(1, 299, pump.millisLeft());
+}
+
+void test_other_pump_left_alone()
+{
+    pumps[0].dispenseVolume(10);
+    runFor(50);
+    TEST_ASSERT_TRUE(pumps[0].running());
+    TEST_ASSERT_FALSE(pumps[1].running());
+    TEST_ASSERT_EQUAL_UINT8(LOW, hal::pinLevel(A2));
+}
+
+// The last ml at trickle duty: the pin is on for about that fraction of
+// the tail, and the pour still ends on its deadline
+void test_trickle_tail_duty()
+{
+    PumpController &pump = pumps[0];
+    pump.profile = {0, 30 << 8, 90 << 8, PUMP_TRICKLE_DUTY, PUMP_TRICKLE_ML};
+    uint32_t runMillis = pump.dispenseVolume(20);
+    uint32_t tailMillis = pump.trickleMillis(20);
+    TEST_ASSERT_EQUAL_UINT32(15 * 30 + 5 * 90, runMillis);
+
+    runFor(runMillis - tailMillis + 1);
+    uint32_t highBefore = hal::pinHighMicros(A1);
+    runFor(tailMillis);
+    TEST_ASSERT_FALSE(pump.busy());
+    uint32_t expected = tailMillis * 1000UL * PUMP_TRICKLE_DUTY / 255;
+    TEST_ASSERT_UINT32_WITHIN(2 * PUMP_TIMER_TICK_MICROS, expected, hal::pinHighMicros(A1) - highBefore);
+}
+
+// A pour armed while priming still runs takes over the flow: primed and
+// poured, the pin is on as long as for the same volume from a standing start
+void test_primed_pour_matches_calibration()
+{
+    PumpController &pump = pumps[0];
+    pump.profile = {400, 30 << 8, 0, PUMP_TRICKLE_DUTY, 0};
+    uint32_t runMillis = pump.runTimeMillis(20);
+
+    uint32_t highBefore = hal::pinHighMicros(A1);
+    pump.dispenseVolume(20);
+    runFor(runMillis + 2);
+    uint32_t standingStart = hal::pinHighMicros(A1) - highBefore;
+
+    highBefore = hal::pinHighMicros(A1);
+    pump.runFor(300); // Priming
+    runFor(200);
+    TEST_ASSERT_TRUE(pump.running());
+    pump.dispenseFor(20, runMillis - 200);
+    runFor(runMillis - 200 + 2);
+    TEST_ASSERT_FALSE(pump.busy());
+    uint32_t primed = hal::pinHighMicros(A1) - highBefore;
+
+    TEST_ASSERT_UINT32_WITHIN(2 * PUMP_TIMER_TICK_MICROS, standingStart, primed);
+}
+
+int main(int argc, char **argv)
+{
+    setup();
+    UNITY_BEGIN();
+    RUN_TEST(test_stop_within_one_tick);
+    RUN_TEST(test_delayed_start_on_time);
+    RUN_TEST(test_other_pump_left_alone);
+    RUN_TEST(test_trickle_tail_duty);
+    RUN_TEST(test_primed_pour_matches_calibration);
+    return UNITY_END();
+}
@@ -0,0 +1,109 @@
+// Scene change detection: widgets redraw when their text changes, even in a
+// buffer the caller rewrote in place, and not when nothing changed.
+#include <unity.h>
+#include <Arduino.h>
+#include "Hal.h"
+#include "screen/DisplayBatcher.h"
+#include "screen/Scene.h"
+
+static DisplayBatcher tft(10, 9, 8);
+static Scene scene(&tft, ILI9341_BLACK);
+static char text[SCENE_MAX_LABEL + 1];
+
+// Hashes the framebuffer over an area, to tell one label from another
+static uint32_t checksum(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+    uint32_t sum = 0;
+    for (int16_t j = y; j < y + h; ++j)
+        for (int16_t i = x; i < x + w; ++i)
+            sum = sum * 31 + hal::displayPixel(i, j);
+    return sum;
+}
+
+static uint32_t pixelsRendered()
+{
+    hal::resetDisplayStats();
+    scene.render();
+    return hal::displayStats().pixels;
+}
+
+void setUp()
+{
+    tft.fillScreen(ILI9341_BLACK);
+    scene.reset();
+    hal::resetDisplayStats();
+}
+
+void tearDown() {}
+
+void test_label_in_reused_buffer()
+{
+    strcpy(text, "12 ml");
+    scene.setLabel(0, 10, 14, text, ILI9341_WHITE, 2);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, pixelsRendered());
+
+    scene.setLabel(0, 10, 14, text, ILI9341_WHITE, 2);
+    TEST_ASSERT_EQUAL_UINT32(0, pixelsRendered());
+
+    strcpy(text, "13 ml"); // Same length, same rectangle
+    scene.setLabel(0, 10, 14, text, ILI9341_WHITE, 2);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, pixelsRendered()); // The HAL's classic font draws every glyph alike
+}
+
+void test_button_label_in_reused_buffer()
+{
+    strcpy(text, "Run 2 s");
+    Button button = {20, 60, 120, 40, text, ILI9341_BLACK, ILI9341_LIGHTGREY, 0, 0, false};
+    scene.setButton(1, button);
+    TEST_ASSERT_EQUAL_UINT32(120UL * 40, pixelsRendered());
+    uint32_t before = checksum(20, 60, 120, 40);
+
+    strcpy(text, "Run 8 s");
+    scene.setButton(1, button);
+    TEST_ASSERT_EQUAL_UINT32(120UL * 40, pixelsRendered());
+    TEST_ASSERT_NOT_EQUAL(before, checksum(20, 60, 120, 40));
+
+    scene.setButton(1, button);
+    TEST_ASSERT_EQUAL_UINT32(0, pixelsRendered());
+}
+
+// The same text from another buffer is still the same widget
+void test_equal_text_elsewhere_unchanged()
+{
+    static char other[SCENE_MAX_LABEL + 1];
+    strcpy(text, "Ready");
+    strcpy(other, "Ready");
+    scene.setLabel(2, 10, 200, text, ILI9341_WHITE, 1);
+    pixelsRendered();
+    scene.setLabel(2, 10, 200, other, ILI9341_WHITE, 1);
+    TEST_ASSERT_EQUAL_UINT32(0, pixelsRendered());
+}
+
+static const char PUMPS[] PROGMEM = "Pumps";
+static const char OTHER[] PROGMEM = "Other";
+
+static const __FlashStringHelper *flash(const char *text)
+{
+    return reinterpret_cast<const __FlashStringHelper *>(text);
+}
+
+void test_flash_label()
+{
+    scene.setLabel(3, 10, 120, flash(PUMPS), ILI9341_WHITE, 1);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, pixelsRendered());
+    scene.setLabel(3, 10, 120, flash(PUMPS), ILI9341_WHITE, 1);
+    TEST_ASSERT_EQUAL_UINT32(0, pixelsRendered());
+    scene.setLabel(3, 10, 120, flash(OTHER), ILI9341_WHITE, 1);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, pixelsRendered());
+}
+
+int main(int argc, char **argv)
+{
+    tft.begin();
+    UNITY_BEGIN();
+    RUN_TEST(test_label_in_reused_buffer);
+    RUN_TEST(test_button_label_in_reused_buffer);
+    RUN_TEST(test_equal_text_elsewhere_unchanged);
+    RUN_TEST(test_flash_label);
+    return UNITY_END();
+}
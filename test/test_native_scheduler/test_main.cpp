@@ -0,0 +1,178 @@
+// Scheduler deadlines across the millis() rollover, generation handles and
+// a full task table, on a local Scheduler against the virtual clock.
+#include <unity.h>
+#include <Arduino.h>
+#include "Hal.h"
+#include "sched/Scheduler.h"
+
+// Fifty ms before millis() wraps
+static const uint32_t BEFORE_WRAP = 0xFFFFFFFFUL - 49;
+
+static char fired[SCHEDULER_MAX_TASKS + 1];
+static uint8_t firedCount;
+
+static void record(void *context)
+{
+    fired[firedCount++] = *(const char *)context;
+    fired[firedCount] = '\0';
+}
+
+static void count(void *context)
+{
+    ++*(uint16_t *)context;
+}
+
+// Runs the scheduler once per virtual ms
+static void runFor(Scheduler &s, uint32_t ms)
+{
+    for (uint32_t i = 0; i < ms; ++i)
+    {
+        hal::advanceMillis(1);
+        s.run();
+    }
+}
+
+void setUp()
+{
+    hal::setMillis(BEFORE_WRAP);
+    firedCount = 0;
+    fired[0] = '\0';
+}
+
+void tearDown() {}
+
+void test_time_reached_across_wrap()
+{
+    TEST_ASSERT_TRUE(timeReached(5, 0xFFFFFFF0UL));
+    TEST_ASSERT_FALSE(timeReached(0xFFFFFFF0UL, 5));
+    TEST_ASSERT_TRUE(timeReached(0xFFFFFFF0UL, 0xFFFFFFF0UL));
+    TEST_ASSERT_FALSE(timeReached(0xFFFFFFF0UL, 0xFFFFFFF1UL));
+}
+
+// Due 50 ms after the wrap: a plain now >= deadline would run it at once
+void test_one_shot_straddles_rollover()
+{
+    Scheduler s;
+    uint16_t runs = 0;
+    s.after(100, count, &runs);
+    TEST_ASSERT_EQUAL_UINT32(100, s.millisUntilNext());
+    s.run();
+    TEST_ASSERT_EQUAL_UINT16(0, runs);
+    runFor(s, 60);
+    TEST_ASSERT_TRUE(millis() < BEFORE_WRAP); // Wrapped
+    TEST_ASSERT_EQUAL_UINT16(0, runs);
+    TEST_ASSERT_EQUAL_UINT32(40, s.millisUntilNext());
+    runFor(s, 39);
+    TEST_ASSERT_EQUAL_UINT16(0, runs);
+    runFor(s, 1);
+    TEST_ASSERT_EQUAL_UINT16(1, runs);
+    TEST_ASSERT_EQUAL_UINT32(0xFFFFFFFFUL, s.millisUntilNext());
+}
+
+// The heap keys on the difference between deadlines, so one that wrapped
+// still sorts after the ones that didn't
+void test_heap_order_across_wrap()
+{
+    Scheduler s;
+    static const char a = 'a', b = 'b', c = 'c', d = 'd';
+    s.after(80, record, (void *)&b);
+    s.after(30, record, (void *)&a);
+    s.after(120, record, (void *)&c);
+    s.after(10, record, (void *)&d);
+    runFor(s, 130);
+    TEST_ASSERT_EQUAL_STRING("dabc", fired);
+}
+
+void test_periodic_across_wrap()
+{
+    Scheduler s;
+    uint16_t runs = 0;
+    s.every(20, count, &runs, 20);
+    runFor(s, 200);
+    TEST_ASSERT_EQUAL_UINT16(10, runs);
+}
+
+// A one-shot that has run frees its slot; the next task takes the slot
+// with a new generation, and the old handle no longer reaches it
+void test_stale_handle_after_slot_reuse()
+{
+    Scheduler s;
+    uint16_t firstRuns = 0, secondRuns = 0;
+    TaskHandle first = s.after(5, count, &firstRuns);
+    runFor(s, 5);
+    TEST_ASSERT_EQUAL_UINT16(1, firstRuns);
+    TEST_ASSERT_FALSE(s.pending(first));
+
+    TaskHandle second = s.after(5, count, &secondRuns);
+    TEST_ASSERT_EQUAL_UINT8(first & 0xFF, second & 0xFF);
+    TEST_ASSERT_NOT_EQUAL(first, second);
+    TaskHandle stale = first;
+    TEST_ASSERT_FALSE(s.reschedule(stale, 1000));
+    TEST_ASSERT_FALSE(s.setPeriod(stale, 1));
+    s.cancel(stale);
+    TEST_ASSERT_EQUAL_UINT16(TASK_NONE, stale);
+    TEST_ASSERT_TRUE(s.pending(second));
+    runFor(s, 5);
+    TEST_ASSERT_EQUAL_UINT16(1, secondRuns);
+}
+
+void test_cancel_then_reuse()
+{
+    Scheduler s;
+    uint16_t runs = 0;
+    TaskHandle cancelled = s.after(5, count, &runs);
+    TaskHandle copy = cancelled;
+    s.cancel(cancelled);
+    TEST_ASSERT_EQUAL_UINT16(TASK_NONE, cancelled);
+    TaskHandle reused = s.after(5, count, &runs);
+    TEST_ASSERT_EQUAL_UINT8(copy & 0xFF, reused & 0xFF);
+    s.cancel(copy);
+    TEST_ASSERT_TRUE(s.pending(reused));
+    runFor(s, 5);
+    TEST_ASSERT_EQUAL_UINT16(1, runs);
+}
+
+// Generations skip 0 as they wrap, so no handle ever reads as TASK_NONE
+void test_generation_never_none()
+{
+    Scheduler s;
+    uint16_t runs = 0;
+    for (uint16_t i = 0; i < 600; ++i)
+    {
+        TaskHandle handle = s.after(1, count, &runs);
+        TEST_ASSERT_NOT_EQUAL(TASK_NONE, handle);
+        TEST_ASSERT_NOT_EQUAL(0, handle >> 8);
+        s.cancel(handle);
+    }
+}
+
+void test_full_table()
+{
+    Scheduler s;
+    uint16_t runs = 0;
+    for (uint8_t i = 0; i < SCHEDULER_MAX_TASKS; ++i)
+        TEST_ASSERT_NOT_EQUAL(TASK_NONE, s.after(10 + i, count, &runs));
+    TaskHandle refused = s.after(1, count, &runs);
+    TEST_ASSERT_EQUAL_UINT16(TASK_NONE, refused);
+    TEST_ASSERT_EQUAL_UINT16(TASK_NONE, s.every(1, count, &runs));
+    TEST_ASSERT_FALSE(s.pending(refused));
+    s.cancel(refused); // Harmless
+
+    runFor(s, 10 + SCHEDULER_MAX_TASKS);
+    TEST_ASSERT_EQUAL_UINT16(SCHEDULER_MAX_TASKS, runs); // Everything admitted ran, once
+    TEST_ASSERT_NOT_EQUAL(TASK_NONE, s.after(1, count, &runs));
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_time_reached_across_wrap);
+    RUN_TEST(test_one_shot_straddles_rollover);
+    RUN_TEST(test_heap_order_across_wrap);
+    RUN_TEST(test_periodic_across_wrap);
+    RUN_TEST(test_stale_handle_after_slot_reuse);
+    RUN_TEST(test_cancel_then_reuse);
+    RUN_TEST(test_generation_never_none);
+    RUN_TEST(test_full_table);
+    return UNITY_END();
+}
@@ -0,0 +1,157 @@
+#!/usr/bin/env python3
+"""Talk to the dispenser over its framed serial link.
+
+    python3 tools/dispenser_client.py PORT ping
+    python3 tools/dispenser_client.py PORT order 1          # queue recipe 1
+    python3 tools/dispenser_client.py PORT pumps
+    python3 tools/dispenser_client.py PORT orders
+    python3 tools/dispenser_client.py PORT inventory        # reservoir levels and pour counts
+    python3 tools/dispenser_client.py PORT refill 1 750     # pump 1 has a new 750 ml bottle
+    python3 tools/dispenser_client.py PORT telemetry off
+    python3 tools/dispenser_client.py PORT perf [--clear]  # loop and task latency histograms
+    python3 tools/dispenser_client.py PORT memory           # static RAM and stack headroom
+    python3 tools/dispenser_client.py PORT leds [144]       # LED strip length, set and kept if given
+    python3 tools/dispenser_client.py PORT monitor          # decoded event stream
+    python3 tools/dispenser_client.py PORT bench --count 2000 --window 2
+
+PORT is the board's serial device, or the pty printed by the native build's
+`program pty`. bench measures round trips and payload throughput with pings
+kept in flight, and checks every echo.
+"""
+import argparse
+import json
+import sys
+import time
+
+import dispenser_link as link
+import telemetry_decode
+
+
+def print_perf(stats):
+    buckets = len(next(iter(stats["probes"].values()))["buckets"])
+    bounds = ["<%d" % link.PERF_FIRST_BUCKET_US] + ["<%d" % (link.PERF_FIRST_BUCKET_US << b) for b in range(1, buckets - 1)]
+    bounds.append(">=%d" % (link.PERF_FIRST_BUCKET_US << (buckets - 2)))
+    print("%-7s %10s  %s" % ("probe", "max us", " ".join("%6s" % b for b in bounds)))
+    for name, probe in stats["probes"].items():
+        print("%-7s %10d  %s" % (name, probe["max_us"], " ".join("%6d" % n for n in probe["buckets"])))
+    print("late counts how late each task ran; %d ran %d ms or more late" % (stats["missed"], link.PERF_MISSED_MS))
+
+
+def run_bench(port, count, window, size):
+    sent = {}
+    done = 0
+    mismatched = 0
+    latencies = []
+    start = time.monotonic()
+    while done < count:
+        while len(sent) < window and done + len(sent) < count:
+            args = bytes((done + len(sent) + i) & 0xFF for i in range(size))
+            seq = port.send(link.PING, args)
+            sent[seq] = (time.monotonic(), args)
+        port.poll(0.5)
+        for seq in [s for s in sent if s in port.replies]:
+            _, status, data = port.replies.pop(seq)
+            began, args = sent.pop(seq)
+            latencies.append(time.monotonic() - began)
+            mismatched += status != 0 or data != args
+            done += 1
+        if time.monotonic() - start > 30:
+            break
+    elapsed = time.monotonic() - start
+    latencies.sort()
+    print("%d pings of %d bytes, %d in flight: %.2f s" % (done, size, window, elapsed))
+    print("%.0f requests/s, %.0f payload bytes/s each way" % (done / elapsed, done * size / elapsed))
+    if latencies:
+        print("round trip: median %.1f ms, 99th %.1f ms" % (latencies[len(latencies) // 2] * 1000,
+                                                           latencies[int(len(latencies) * 0.99)] * 1000))
+    print("%d bad echoes, %d bad frames, %d unanswered" % (mismatched, port.reader.errors, count - done))
+    return 0 if mismatched == 0 and done == count else 1
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("port")
+    commands = parser.add_subparsers(dest="command", required=True)
+    commands.add_parser("ping")
+    order = commands.add_parser("order")
+    order.add_argument("recipe", type=int)
+    commands.add_parser("pumps")
+    commands.add_parser("orders")
+    commands.add_parser("inventory")
+    refill = commands.add_parser("refill")
+    refill.add_argument("pump", type=int, help="1 for the first pump")
+    refill.add_argument("ml", type=int, help="size of the new bottle")
+    stream = commands.add_parser("telemetry")
+    stream.add_argument("state", choices=["on", "off"])
+    perf = commands.add_parser("perf")
+    perf.add_argument("--clear", action="store_true", help="start the histograms again afterwards")
+    commands.add_parser("memory")
+    leds = commands.add_parser("leds")
+    leds.add_argument("pixels", type=int, nargs="?", help="strip length to drive from now on")
+    monitor = commands.add_parser("monitor")
+    monitor.add_argument("--events", default=telemetry_decode.EVENTS_H, help="path to TelemetryEvents.h")
+    bench = commands.add_parser("bench")
+    bench.add_argument("--count", type=int, default=1000)
+    bench.add_argument("--window", type=int, default=2, help="pings in flight")
+    bench.add_argument("--size", type=int, default=16, help="ping argument bytes")
+    args = parser.parse_args()
+
+    port = link.Link(args.port)
+    try:
+        return run(port, args)
+    except (RuntimeError, TimeoutError) as error:
+        print("%s: %s" % (args.command, error), file=sys.stderr)
+        return 1
+
+
+def run(port, args):
+    if args.command == "ping":
+        start = time.monotonic()
+        port.request(link.PING)
+        print("reply in %.1f ms" % ((time.monotonic() - start) * 1000))
+    elif args.command == "order":
+        waiting = port.request(link.ORDER, bytes([args.recipe]))[0]
+        print("queued, %d waiting" % waiting)
+    elif args.command == "pumps":
+        print(json.dumps(port.pump_state(), indent=2))
+    elif args.command == "orders":
+        print(json.dumps(port.order_state(), indent=2))
+    elif args.command == "inventory":
+        print(json.dumps(port.inventory(), indent=2))
+    elif args.command == "refill":
+        port.refill(args.pump - 1, args.ml)
+    elif args.command == "telemetry":
+        port.request(link.TELEMETRY, bytes([args.state == "on"]))
+    elif args.command == "perf":
+        print_perf(port.perf())
+        if args.clear:
+            port.clear_perf()
+    elif args.command == "memory":
+        print(json.dumps(port.memory(), indent=2))
+    elif args.command == "leds":
+        print(json.dumps(port.leds(args.pixels), indent=2))
+    elif args.command == "monitor":
+        events = telemetry_decode.load_events(args.events)
+        pending = [b""]
+
+        def show(data):
+            pending[0] += data
+            records, used = telemetry_decode.decode(pending[0], events)
+            pending[0] = pending[0][used:]
+            for timestamp, level, name, text in records:
+                print("%10.3f %-5s %-18s %s" % (timestamp / 1000.0, level, name, text), flush=True)
+
+        port.on_events = show
+        port.request(link.TELEMETRY, b"\1")
+        try:
+            while True:
+                port.poll(1.0)
+        except KeyboardInterrupt:
+            pass
+    elif args.command == "bench":
+        return run_bench(port, args.count, args.window, min(args.size, link.MAX_PAYLOAD - 3))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
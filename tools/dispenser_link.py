@@ -0,0 +1,224 @@
+"""Host side of the dispenser's serial link (src/link/SerialLink.h).
+
+Frames are COBS encoded payloads followed by their CRC-16/CCITT, high byte
+first, and end at a zero byte. Requests are [message, seq, args...] and the
+reply is [message | 0x80, seq, status, data...], numbers little-endian.
+Telemetry arrives unasked as [0x40, bytes...] slices of the event stream.
+"""
+import os
+import select
+import struct
+import termios
+import time
+
+BAUD = 115200
+MAX_PAYLOAD = 32
+
+PING = 0x01
+ORDER = 0x02
+PUMP_STATE = 0x03
+ORDER_STATE = 0x04
+TELEMETRY = 0x05
+PERF = 0x06
+INVENTORY = 0x07
+MEMORY = 0x08
+LEDS = 0x09
+EVENTS = 0x40
+REPLY = 0x80
+
+STATUS = {0: "ok", 1: "unknown message", 2: "bad arguments", 3: "refused"}
+SCREEN_STATES = ["idle", "active", "dispensing", "finished"]
+PERF_PROBES = ["loop", "screen", "eye", "leds", "touch", "pour", "servo", "link", "late"]  # src/sched/PerfStats.h
+PERF_FIRST_BUCKET_US = 16
+PERF_MISSED_MS = 4
+
+
+def crc16(data, crc=0xFFFF):
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else crc << 1
+        crc &= 0xFFFF
+    return crc
+
+
+def cobs_encode(data):
+    out = bytearray([0])
+    code_at, code = 0, 1
+    for byte in data:
+        if byte:
+            out.append(byte)
+            code += 1
+        if not byte or code == 0xFF:
+            out[code_at] = code
+            code_at, code = len(out), 1
+            out.append(0)
+    out[code_at] = code
+    return bytes(out)
+
+
+def cobs_decode(data):
+    out = bytearray()
+    pos = 0
+    while pos < len(data):
+        code = data[pos]
+        end = pos + code
+        if code == 0 or end > len(data):
+            raise ValueError("bad COBS block")
+        out += data[pos + 1:end]
+        pos = end
+        if code != 0xFF and pos < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def encode_frame(payload):
+    crc = crc16(payload)
+    return cobs_encode(bytes(payload) + bytes([crc >> 8, crc & 0xFF])) + b"\0"
+
+
+class FrameReader:
+    """Splits a byte stream into checked payloads; counts what it drops."""
+
+    def __init__(self):
+        self.pending = b""
+        self.errors = 0
+
+    def feed(self, data):
+        self.pending += data
+        *frames, self.pending = self.pending.split(b"\0")
+        payloads = []
+        for frame in frames:
+            if not frame:
+                continue
+            try:
+                body = cobs_decode(frame)
+            except ValueError:
+                self.errors += 1
+                continue
+            if len(body) < 3 or crc16(body) != 0:
+                self.errors += 1
+                continue
+            payloads.append(body[:-2])
+        return payloads
+
+
+class Link:
+    """Request/reply over a serial port or the native build's pty."""
+
+    def __init__(self, path, on_events=None):
+        self.fd = os.open(path, os.O_RDWR | os.O_NOCTTY | os.O_NONBLOCK)
+        if os.isatty(self.fd):
+            attrs = termios.tcgetattr(self.fd)
+            attrs[0] = attrs[1] = attrs[3] = 0  # Raw: no input, output or line processing
+            attrs[2] = termios.CS8 | termios.CREAD | termios.CLOCAL
+            speed = getattr(termios, "B%d" % BAUD)
+            attrs[4] = attrs[5] = speed
+            attrs[6][termios.VMIN] = 0
+            attrs[6][termios.VTIME] = 0
+            termios.tcsetattr(self.fd, termios.TCSANOW, attrs)
+        self.reader = FrameReader()
+        self.on_events = on_events
+        self.seq = 0
+        self.replies = {}
+        self.bytes_in = 0
+
+    def close(self):
+        os.close(self.fd)
+
+    def send(self, message, args=b""):
+        """Queues a request; returns its sequence number."""
+        self.seq = (self.seq + 1) & 0xFF
+        frame = encode_frame(bytes([message, self.seq]) + bytes(args))
+        view = memoryview(frame)
+        while view:
+            try:
+                view = view[os.write(self.fd, view):]
+            except BlockingIOError:
+                select.select([], [self.fd], [], 0.1)
+        return self.seq
+
+    def poll(self, timeout):
+        """Reads what arrives within timeout; replies are kept by seq."""
+        ready, _, _ = select.select([self.fd], [], [], timeout)
+        if not ready:
+            return
+        try:
+            data = os.read(self.fd, 4096)
+        except (BlockingIOError, OSError):
+            return
+        self.bytes_in += len(data)
+        for payload in self.reader.feed(data):
+            if payload[0] == EVENTS:
+                if self.on_events:
+                    self.on_events(payload[1:])
+            elif payload[0] & REPLY and len(payload) >= 3:
+                self.replies[payload[1]] = (payload[0] & ~REPLY, payload[2], payload[3:])
+
+    def wait(self, seq, timeout=1.0):
+        deadline = time.monotonic() + timeout
+        while seq not in self.replies:
+            left = deadline - time.monotonic()
+            if left <= 0:
+                raise TimeoutError("no reply to request %d" % seq)
+            self.poll(left)
+        return self.replies.pop(seq)
+
+    def request(self, message, args=b"", timeout=1.0):
+        """Returns the reply data, or raises on a timeout or a failed status."""
+        _, status, data = self.wait(self.send(message, args), timeout)
+        if status != 0:
+            raise RuntimeError(STATUS.get(status, "status %d" % status))
+        return data
+
+    def pump_state(self):
+        """One dict per pump, asked for a page at a time."""
+        fields = ("running", "ms_left", "ml_poured", "prime_ms", "ms_per_ml_q8")
+        pumps = []
+        while True:
+            data = self.request(PUMP_STATE, bytes([len(pumps)]))
+            pumps += [dict(zip(fields, struct.unpack_from("<BIIHH", data, i))) for i in range(1, len(data), 13)]
+            if len(pumps) >= data[0] or len(data) == 1:
+                return pumps
+
+    def inventory(self):
+        """Per reservoir: ml and pours since the journal began, ml left and bottle size."""
+        fields = ("ml_poured", "pours", "ml_left", "capacity_ml")
+        reservoirs = []
+        while True:
+            data = self.request(INVENTORY, bytes([len(reservoirs)]))
+            reservoirs += [dict(zip(fields, struct.unpack_from("<IIHH", data, i))) for i in range(1, len(data), 12)]
+            if len(reservoirs) >= data[0] or len(data) == 1:
+                return reservoirs
+
+    def refill(self, pump, capacity_ml):
+        self.request(INVENTORY, struct.pack("<BH", pump, capacity_ml))
+
+    def memory(self):
+        """RAM in bytes: the whole, the static data, free between heap and stack now, and never touched by the stack."""
+        ram, static, free, headroom = struct.unpack("<HHHH", self.request(MEMORY))
+        return {"ram": ram, "static": static, "free_now": free, "stack_headroom": headroom}
+
+    def leds(self, pixels=None):
+        """Pixels the strip drives and the most it can; a length given is kept across power cycles."""
+        length, most = struct.unpack("<HH", self.request(LEDS, b"" if pixels is None else struct.pack("<H", pixels)))
+        return {"pixels": length, "most": most}
+
+    def perf(self):
+        """Per probe: the longest sample in us and the log2 bucket counts."""
+        probes, buckets, missed = struct.unpack("<BBH", self.request(PERF))
+        result = {"missed": missed, "probes": {}}
+        for probe in range(probes):
+            data = self.request(PERF, bytes([probe]))
+            name = PERF_PROBES[probe] if probe < len(PERF_PROBES) else str(probe)
+            result["probes"][name] = {"max_us": struct.unpack_from("<I", data)[0],
+                                      "buckets": list(struct.unpack_from("<%dH" % buckets, data, 4))}
+        return result
+
+    def clear_perf(self):
+        self.request(PERF, b"\xff")
+
+    def order_state(self):
+        state, waiting, served, per_hour, longest, deepest = struct.unpack("<BBHHIB", self.request(ORDER_STATE))
+        return {"screen": SCREEN_STATES[state] if state < len(SCREEN_STATES) else state, "waiting": waiting,
+                "served": served, "drinks_per_hour": per_hour, "longest_wait_ms": longest, "longest_queue": deepest}
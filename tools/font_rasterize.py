@@ -0,0 +1,306 @@
+#!/usr/bin/env python3
+"""Render a TrueType font into the firmware's run-length coded flash font.
+
+    python3 tools/font_rasterize.py /usr/share/fonts/truetype/dejavu/DejaVuSans-Bold.ttf \\
+        --size 15 --name buttonFont --out src/screen/fonts/ButtonFont.cpp
+
+Each glyph is a cell one advance wide and the font's line height tall,
+anti-aliased to four levels (2 bits) by 4x4 supersampling. Pixels are coded
+row-major as runs: one byte per run, level in the top two bits, length - 1
+in the low six. Runs carry on from one row of a glyph into the next, which
+is how Scene streams them (see src/screen/Font.h).
+
+Self-contained: reads glyf outlines directly, no Pillow or FreeType needed.
+Simple and composite glyphs are supported; hinting is ignored.
+"""
+
+import argparse
+import math
+import struct
+import sys
+
+SUPERSAMPLE = 4
+CURVE_STEPS = 8
+MAX_RUN = 64
+
+
+class TrueTypeFont:
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            self.data = f.read()
+        num_tables = struct.unpack_from('>H', self.data, 4)[0]
+        self.tables = {}
+        for i in range(num_tables):
+            tag, _, offset, length = struct.unpack_from('>4sIII', self.data, 12 + 16 * i)
+            self.tables[tag.decode('latin-1')] = (offset, length)
+
+        head = self.tables['head'][0]
+        self.units_per_em = struct.unpack_from('>H', self.data, head + 18)[0]
+        self.long_loca = struct.unpack_from('>h', self.data, head + 50)[0] == 1
+        self.num_glyphs = struct.unpack_from('>H', self.data, self.tables['maxp'][0] + 4)[0]
+        hhea = self.tables['hhea'][0]
+        self.ascender, self.descender = struct.unpack_from('>hh', self.data, hhea + 4)
+        self.num_hmetrics = struct.unpack_from('>H', self.data, hhea + 34)[0]
+        self.cmap = self._read_cmap()
+
+    def _read_cmap(self):
+        base = self.tables['cmap'][0]
+        count = struct.unpack_from('>H', self.data, base + 2)[0]
+        for i in range(count):
+            platform, encoding, offset = struct.unpack_from('>HHI', self.data, base + 4 + 8 * i)
+            sub = base + offset
+            if struct.unpack_from('>H', self.data, sub)[0] == 4 and (platform, encoding) in ((3, 1), (0, 3), (0, 4)):
+                return self._read_cmap4(sub)
+        raise ValueError('no Unicode BMP (format 4) cmap')
+
+    def _read_cmap4(self, sub):
+        seg_count = struct.unpack_from('>H', self.data, sub + 6)[0] // 2
+        ends = sub + 14
+        starts = ends + 2 * seg_count + 2
+        deltas = starts + 2 * seg_count
+        range_offsets = deltas + 2 * seg_count
+        mapping = {}
+        for s in range(seg_count):
+            end = struct.unpack_from('>H', self.data, ends + 2 * s)[0]
+            start = struct.unpack_from('>H', self.data, starts + 2 * s)[0]
+            delta = struct.unpack_from('>h', self.data, deltas + 2 * s)[0]
+            range_offset = struct.unpack_from('>H', self.data, range_offsets + 2 * s)[0]
+            for code in range(start, min(end, 0xFFFE) + 1):
+                if range_offset == 0:
+                    glyph = (code + delta) & 0xFFFF
+                else:
+                    at = range_offsets + 2 * s + range_offset + 2 * (code - start)
+                    glyph = struct.unpack_from('>H', self.data, at)[0]
+                    if glyph:
+                        glyph = (glyph + delta) & 0xFFFF
+                mapping[code] = glyph
+        return mapping
+
+    def advance(self, glyph):
+        hmtx = self.tables['hmtx'][0]
+        index = min(glyph, self.num_hmetrics - 1)
+        return struct.unpack_from('>H', self.data, hmtx + 4 * index)[0]
+
+    def _glyph_offset(self, glyph):
+        loca = self.tables['loca'][0]
+        if self.long_loca:
+            start, end = struct.unpack_from('>II', self.data, loca + 4 * glyph)
+        else:
+            start, end = (2 * v for v in struct.unpack_from('>HH', self.data, loca + 2 * glyph))
+        return self.tables['glyf'][0] + start, end - start
+
+    def contours(self, glyph):
+        """Outline as a list of closed polylines in font units, y up."""
+        offset, length = self._glyph_offset(glyph)
+        if length == 0:
+            return []
+        num_contours = struct.unpack_from('>h', self.data, offset)[0]
+        if num_contours >= 0:
+            return self._simple(offset, num_contours)
+        return self._composite(offset)
+
+    def _simple(self, offset, num_contours):
+        p = offset + 10
+        end_points = struct.unpack_from('>%dH' % num_contours, self.data, p)
+        p += 2 * num_contours
+        p += 2 + struct.unpack_from('>H', self.data, p)[0]  # Skip instructions
+        count = end_points[-1] + 1 if num_contours else 0
+        flags = []
+        while len(flags) < count:
+            flag = self.data[p]
+            p += 1
+            flags.append(flag)
+            if flag & 8:
+                flags.extend([flag] * self.data[p])
+                p += 1
+        xs, p = self._coords(flags, p, 2, 16)
+        ys, p = self._coords(flags, p, 4, 32)
+
+        outlines = []
+        first = 0
+        for last in end_points:
+            points = [(xs[i], ys[i], flags[i] & 1) for i in range(first, last + 1)]
+            outlines.append(self._flatten(points))
+            first = last + 1
+        return outlines
+
+    def _coords(self, flags, p, short_bit, same_bit):
+        values = []
+        value = 0
+        for flag in flags:
+            if flag & short_bit:
+                delta = self.data[p]
+                p += 1
+                value += delta if flag & same_bit else -delta
+            elif not flag & same_bit:
+                value += struct.unpack_from('>h', self.data, p)[0]
+                p += 2
+            values.append(value)
+        return values, p
+
+    @staticmethod
+    def _flatten(points):
+        """Quadratic B-spline contour to a polyline, inserting the implied
+        on-curve midpoints between consecutive off-curve points."""
+        if not points:
+            return []
+        expanded = []
+        for i, (x, y, on) in enumerate(points):
+            nx, ny, non = points[(i + 1) % len(points)]
+            expanded.append((x, y, on))
+            if not on and not non:
+                expanded.append(((x + nx) / 2, (y + ny) / 2, 1))
+        start = next((i for i, pt in enumerate(expanded) if pt[2]), None)
+        if start is None:  # All off-curve: start from an implied point
+            x0, y0, _ = expanded[0]
+            x1, y1, _ = expanded[1 % len(expanded)]
+            expanded.insert(0, ((x0 + x1) / 2, (y0 + y1) / 2, 1))
+            start = 0
+        expanded = expanded[start:] + expanded[:start]
+        line = [(expanded[0][0], expanded[0][1])]
+        i = 1
+        n = len(expanded)
+        while i <= n:
+            x, y, on = expanded[i % n]
+            if on:
+                line.append((x, y))
+                i += 1
+                continue
+            ex, ey, _ = expanded[(i + 1) % n]
+            sx, sy = line[-1]
+            for step in range(1, CURVE_STEPS + 1):
+                t = step / CURVE_STEPS
+                u = 1 - t
+                line.append((u * u * sx + 2 * u * t * x + t * t * ex, u * u * sy + 2 * u * t * y + t * t * ey))
+            i += 2
+        return line
+
+    def _composite(self, offset):
+        p = offset + 10
+        outlines = []
+        while True:
+            flags, glyph = struct.unpack_from('>HH', self.data, p)
+            p += 4
+            if flags & 1:
+                dx, dy = struct.unpack_from('>hh', self.data, p)
+                p += 4
+            else:
+                dx, dy = struct.unpack_from('>bb', self.data, p)
+                p += 2
+            if not flags & 2:
+                dx = dy = 0  # Point matching is not supported; place at the origin
+            a, b, c, d = 1.0, 0.0, 0.0, 1.0
+            if flags & 8:
+                a = d = struct.unpack_from('>h', self.data, p)[0] / 16384
+                p += 2
+            elif flags & 0x40:
+                a, d = (v / 16384 for v in struct.unpack_from('>hh', self.data, p))
+                p += 4
+            elif flags & 0x80:
+                a, b, c, d = (v / 16384 for v in struct.unpack_from('>hhhh', self.data, p))
+                p += 8
+            for line in self.contours(glyph):
+                outlines.append([(a * x + c * y + dx, b * x + d * y + dy) for x, y in line])
+            if not flags & 0x20:
+                return outlines
+
+
+def coverage_grid(outlines, width, rows, scale, baseline):
+    edges = []
+    for line in outlines:
+        pts = [(x * scale, baseline - y * scale) for x, y in line]
+        for (x0, y0), (x1, y1) in zip(pts, pts[1:] + pts[:1]):
+            if y0 != y1:
+                edges.append((x0, y0, x1, y1))
+
+    grid = [[0] * width for _ in range(rows)]
+    samples_wide = width * SUPERSAMPLE
+    for row in range(rows):
+        for sub in range(SUPERSAMPLE):
+            sy = row + (sub + 0.5) / SUPERSAMPLE
+            crossings = []
+            for x0, y0, x1, y1 in edges:
+                if (y0 <= sy < y1) or (y1 <= sy < y0):
+                    crossings.append((x0 + (sy - y0) * (x1 - x0) / (y1 - y0), 1 if y1 > y0 else -1))
+            crossings.sort()
+            winding = 0
+            span_start = 0.0
+            for x, direction in crossings:
+                if winding == 0:
+                    span_start = x
+                winding += direction
+                if winding == 0:
+                    # Samples whose centres fall inside [span_start, x)
+                    first = max(0, math.ceil(span_start * SUPERSAMPLE - 0.5))
+                    last = min(samples_wide - 1, math.ceil(x * SUPERSAMPLE - 0.5) - 1)
+                    for s in range(first, last + 1):
+                        grid[row][s // SUPERSAMPLE] += 1
+    return grid
+
+
+def encode_runs(levels):
+    runs = []
+    i = 0
+    while i < len(levels):
+        level = levels[i]
+        length = 1
+        while i + length < len(levels) and levels[i + length] == level and length < MAX_RUN:
+            length += 1
+        runs.append(level << 6 | (length - 1))
+        i += length
+    return runs
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('ttf')
+    parser.add_argument('--size', type=float, default=16, help='pixels per em')
+    parser.add_argument('--first', type=int, default=32)
+    parser.add_argument('--last', type=int, default=126)
+    parser.add_argument('--name', default='buttonFont')
+    parser.add_argument('--out', default='-')
+    args = parser.parse_args()
+
+    font = TrueTypeFont(args.ttf)
+    scale = args.size / font.units_per_em
+    chars = list(range(args.first, args.last + 1))
+    glyphs = {c: font.cmap.get(c, 0) for c in chars}
+    outlines = {c: font.contours(g) for c, g in glyphs.items()}
+
+    # Line box: tight around the ink of the whole character set
+    top = max((y for c in chars for line in outlines[c] for _, y in line), default=0) * scale
+    bottom = min((y for c in chars for line in outlines[c] for _, y in line), default=0) * scale
+    baseline = math.ceil(top)
+    rows = baseline + math.ceil(-bottom)
+
+    table = []
+    data = []
+    for c in chars:
+        width = max(1, round(font.advance(glyphs[c]) * scale))
+        grid = coverage_grid(outlines[c], width, rows, scale, baseline)
+        full = SUPERSAMPLE * SUPERSAMPLE
+        levels = [(v * 3 + full // 2) // full for line in grid for v in line]
+        table.append((len(data), width))
+        data.extend(encode_runs(levels))
+
+    out = sys.stdout if args.out == '-' else open(args.out, 'w')
+    name = args.name
+    out.write('// Generated by tools/font_rasterize.py from %s at %g px; do not edit.\n' % (args.ttf.split('/')[-1], args.size))
+    out.write('#include <Arduino.h>\n#include "screen/Font.h"\n\n')
+    out.write('static const uint8_t %sData[] PROGMEM = {\n' % name)
+    for i in range(0, len(data), 16):
+        out.write('    ' + ', '.join('0x%02X' % b for b in data[i:i + 16]) + ',\n')
+    out.write('};\n\n')
+    out.write('static const FontGlyph %sGlyphs[] PROGMEM = {\n' % name)
+    for c, (offset, width) in zip(chars, table):
+        shown = 'backslash' if c == 92 else chr(c)  # A trailing \ would continue the comment
+        out.write('    {%u, %u}, // %s\n' % (offset, width, shown))
+    out.write('};\n\n')
+    out.write('const Font %s PROGMEM = {%u, %u, %u, %sGlyphs, %sData};\n' % (name, args.first, args.last, rows, name, name))
+    if out is not sys.stdout:
+        out.close()
+    print('%s: %u glyphs, %u rows, %u bytes of runs' % (name, len(chars), rows, len(data)), file=sys.stderr)
+
+
+if __name__ == '__main__':
+    main()
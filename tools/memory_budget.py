@@ -0,0 +1,81 @@
+#!/usr/bin/env python3
+"""Check the firmware's static RAM against the board, leaving room for the stack.
+
+    python3 tools/memory_budget.py .pio/build/uno/firmware.elf --ram 2048 --reserve 400
+
+Adds up .data, .bss and .noinit in the ELF; whatever the RAM has left over
+is shared by the heap and the stack. The build fails when that is less than
+the reserve, so a new table or buffer can't quietly eat the stack. The
+reserve is the measured worst case plus a margin: `dispenser_client.py PORT
+memory` reports what the stack has never touched since reset.
+
+Also runs as a PlatformIO post-build script for [env:uno], taking the RAM
+size from the board and the reserve from custom_stack_reserve.
+"""
+import argparse
+import struct
+import sys
+
+STATIC_SECTIONS = (".data", ".bss", ".noinit")
+DEFAULT_RESERVE = 400
+
+
+def section_sizes(path):
+    """Section name -> size, from a 32-bit little-endian ELF."""
+    data = open(path, "rb").read()
+    if data[:4] != b"\x7fELF" or data[4] != 1 or data[5] != 1:
+        raise ValueError("%s: not a 32-bit little-endian ELF" % path)
+    shoff, = struct.unpack_from("<I", data, 32)
+    shentsize, shnum, shstrndx = struct.unpack_from("<HHH", data, 46)
+    headers = [struct.unpack_from("<IIIIIIIIII", data, shoff + i * shentsize) for i in range(shnum)]
+    names = headers[shstrndx][4]  # sh_offset of the section name table
+    sizes = {}
+    for header in headers:
+        start = names + header[0]
+        name = data[start:data.index(b"\0", start)].decode()
+        sizes[name] = header[5]
+    return sizes
+
+
+def check(path, ram, reserve, out=sys.stdout):
+    """Prints the budget; returns 0 when the reserve fits, 1 when it doesn't."""
+    sizes = section_sizes(path)
+    used = {name: sizes.get(name, 0) for name in STATIC_SECTIONS}
+    static = sum(used.values())
+    left = ram - static
+    print("RAM: %s = %d of %d bytes, %d left for heap and stack (reserve %d)"
+          % (" + ".join("%s %d" % item for item in used.items()), static, ram, left, reserve), file=out)
+    if left < reserve:
+        print("RAM: over budget by %d bytes" % (reserve - left), file=out)
+        return 1
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf")
+    parser.add_argument("--ram", type=int, default=2048, help="bytes of SRAM")
+    parser.add_argument("--reserve", type=int, default=DEFAULT_RESERVE, help="bytes kept for the stack")
+    args = parser.parse_args()
+    try:
+        return check(args.elf, args.ram, args.reserve)
+    except (OSError, ValueError) as error:
+        print(error, file=sys.stderr)
+        return 2
+
+
+try:
+    Import("env")  # noqa: F821 -- defined when PlatformIO runs this as an extra script
+    platformio = True
+except NameError:
+    platformio = False
+
+if platformio:
+    def after_link(source, target, env):
+        ram = int(env.BoardConfig().get("upload.maximum_ram_size"))
+        reserve = int(env.GetProjectOption("custom_stack_reserve", DEFAULT_RESERVE))
+        return check(str(target[0]), ram, reserve)
+
+    env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", after_link)  # noqa: F821
+elif __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,146 @@
+#!/usr/bin/env python3
+"""Decode the dispenser's binary telemetry stream into text.
+
+    python3 tools/telemetry_decode.py /dev/ttyACM0      # live, needs pyserial
+    python3 tools/telemetry_decode.py capture.bin       # a saved capture
+    some-command | python3 tools/telemetry_decode.py -  # stdin
+
+The records arrive in LINK_EVENTS frames of the serial link (see
+dispenser_link.py); replies to other clients' requests are skipped.
+Event names, levels and formats come from src/telemetry/TelemetryEvents.h,
+so the decoder always matches the firmware built from the same tree.
+"""
+import argparse
+import os
+import re
+import sys
+
+from dispenser_link import EVENTS, FrameReader
+
+SYNC = 0xA5
+BAUD = 115200
+EVENTS_H = os.path.join(os.path.dirname(__file__), "..", "src", "telemetry", "TelemetryEvents.h")
+
+
+def load_events(path):
+    text = open(path).read()
+    events = []
+    for name, level, fmt in re.findall(r'X\((\w+),\s*(\w+),\s*"((?:[^"\\]|\\.)*)"\)', text):
+        argc = len(re.findall(r"%[dux]", fmt))
+        events.append((name, level, fmt, argc))
+    return events
+
+
+def read_varint(data, pos):
+    value = shift = 0
+    while True:
+        if pos >= len(data):
+            return None, pos
+        byte = data[pos]
+        pos += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            return value, pos
+        if shift > 35:
+            raise ValueError("varint too long")
+
+
+def unzigzag(v):
+    return (v >> 1) ^ -(v & 1)
+
+
+def render(fmt, args):
+    values = iter(args)
+
+    def sub(m):
+        spec = m.group(1)
+        if spec == "%":
+            return "%"
+        v = next(values)
+        if spec == "x":
+            return "%x" % (v & 0xFFFFFFFF)
+        if spec == "u":
+            return str(v & 0xFFFFFFFF)
+        return str(v)
+
+    return re.sub(r"%([duxX%])", sub, fmt)
+
+
+def decode(data, events):
+    """Yields (millis, level, name, text) and the number of bytes consumed."""
+    pos = 0
+    records = []
+    while True:
+        start = data.find(bytes([SYNC]), pos)
+        if start < 0 or start + 2 > len(data):
+            pos = len(data) if start < 0 else start
+            break
+        id_argc = data[start + 1]
+        event_id, argc = id_argc >> 2, id_argc & 3
+        if event_id >= len(events) or events[event_id][3] != argc:
+            pos = start + 1  # Not a record boundary, resync
+            continue
+        try:
+            cursor = start + 2
+            timestamp, cursor = read_varint(data, cursor)
+            args = []
+            for _ in range(argc):
+                if timestamp is None:
+                    break
+                raw, cursor = read_varint(data, cursor)
+                if raw is None:
+                    timestamp = None
+                    break
+                args.append(unzigzag(raw))
+        except ValueError:
+            pos = start + 1
+            continue
+        if timestamp is None:
+            pos = start  # Incomplete, wait for more
+            break
+        name, level, fmt, _ = events[event_id]
+        records.append((timestamp, level, name, render(fmt, args)))
+        pos = cursor
+    return records, pos
+
+
+def open_stream(path):
+    if path == "-":
+        return sys.stdin.buffer
+    if path.startswith("/dev/") or path.upper().startswith("COM"):
+        try:
+            import serial  # pyserial
+        except ImportError:
+            sys.exit("pyserial is needed to read %s directly (pip install pyserial)" % path)
+        return serial.Serial(path, BAUD, timeout=0.1)
+    return open(path, "rb")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("source", help="serial port, capture file, or - for stdin")
+    parser.add_argument("--events", default=EVENTS_H, help="path to TelemetryEvents.h")
+    args = parser.parse_args()
+
+    events = load_events(args.events)
+    stream = open_stream(args.source)
+    frames = FrameReader()
+    pending = b""
+    while True:
+        chunk = stream.read(256)
+        if not chunk:
+            if hasattr(stream, "in_waiting"):
+                continue  # Serial timeout, keep listening
+            break
+        for payload in frames.feed(chunk):
+            if payload[0] == EVENTS:
+                pending += payload[1:]
+        records, used = decode(pending, events)
+        pending = pending[used:]
+        for timestamp, level, name, text in records:
+            print("%10.3f %-5s %-18s %s" % (timestamp / 1000.0, level, name, text), flush=True)
+
+
+if __name__ == "__main__":
+    main()